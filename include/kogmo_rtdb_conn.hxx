@@ -181,6 +181,21 @@ public:
       {
         return cycle_ts;
       }
+    //! Spin up to secs before sleeping while waiting for new data, see kogmo_rtdb_setwaitspin()
+    void setWaitSpin (const float& secs, const bool& yield = false)
+      {
+        int err = kogmo_rtdb_setwaitspin(dbc, secs, yield ? 1 : 0);
+        if ( err < 0 )
+          throw DBError(err);
+      }
+    kogmo_rtdb_waitstats_t getWaitStats (const bool& reset = false)
+      {
+        kogmo_rtdb_waitstats_t stats;
+        int err = kogmo_rtdb_getwaitstats(dbc, &stats, reset ? 1 : 0);
+        if ( err < 0 )
+          throw DBError(err);
+        return stats;
+      }
     kogmo_rtdb_handle_t* getHandle (void) const
       {
         return dbc;
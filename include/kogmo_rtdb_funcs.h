@@ -79,7 +79,7 @@ kogmo_rtdb_obj_initinfo (kogmo_rtdb_handle_t *db_h,
  *  \retval -KOGMO_RTDB_ERR_NOTUNIQ    There is already an (unique) object, that cannot coexist with your new (unique) object.
  *  \retval -KOGMO_RTDB_ERR_NOMEMORY   Not enough memory within the database for the new object and its history,
  *                                    restart the manager with a larger KOGMO_RTDB_HEAPSIZE.
- *  \retval -KOGMO_RTDB_ERR_OUTOFOBJ  Out of object slots (recompile the database with a higher KOGMO_RTDB_OBJ_MAX).
+ *  \retval -KOGMO_RTDB_ERR_OUTOFOBJ  Out of object slots (restart the manager with more slots, kogmo_rtdb_man -O).
  *                   Be aware, that object slots are freed after their history_interval is expired.
  *                   This error also occurs when the OID reaches its maximum and a restart is required
  *                   (the OID is large enough that this should not happen within normal operation).
@@ -202,6 +202,71 @@ kogmo_rtdb_obj_searchinfo (kogmo_rtdb_handle_t *db_h,
                            int nth);
 
 
+/*! \brief Start a Search for Objects without a Limit on the Number of Results.
+ *
+ * Unlike kogmo_rtdb_obj_searchinfo() the results are fetched in chunks
+ * with kogmo_rtdb_obj_searchinfo_next(), the database is not locked
+ * between the chunks.
+ * Objects that exist during the whole search are returned exactly once,
+ * objects that are created or deleted meanwhile may or may not be returned.
+ *
+ * \code
+ * kogmo_rtdb_obj_search_t search;
+ * kogmo_rtdb_objid_t oids[64];
+ * int i, n;
+ * err = kogmo_rtdb_obj_searchinfo_begin (dbc, &search, "~^foo", 0, 0, 0, 0, 0);
+ * while ( ( n = kogmo_rtdb_obj_searchinfo_next (dbc, &search, oids, 64) ) > 0 )
+ *   for ( i = 0; i < n; i++ )
+ *     ... oids[i] ...
+ * kogmo_rtdb_obj_searchinfo_end (dbc, &search);
+ * \endcode
+ *
+ * \param db_h        Database handle
+ * \param search_p    Pointer to a cursor that will be initialized
+ * \param name        see kogmo_rtdb_obj_searchinfo(), at most
+ *                    KOGMO_RTDB_SEARCH_NAME_MAXLEN-1 characters
+ * \param otype       see kogmo_rtdb_obj_searchinfo()
+ * \param parent_oid  see kogmo_rtdb_obj_searchinfo()
+ * \param proc_oid    see kogmo_rtdb_obj_searchinfo()
+ * \param ts          see kogmo_rtdb_obj_searchinfo()
+ * \param flags       0 or KOGMO_RTDB_SEARCH_FLAGS_DELETED to find objects
+ *                    that are already marked deleted, too
+ * \returns           <0 on errors, 0 on success
+ *  \retval -KOGMO_RTDB_ERR_INVALID    Invalid parameters (invalid regular expression, name too long).
+ */
+int
+kogmo_rtdb_obj_searchinfo_begin (kogmo_rtdb_handle_t *db_h,
+                                 kogmo_rtdb_obj_search_t *search_p,
+                                 _const char *name,
+                                 kogmo_rtdb_objtype_t otype,
+                                 kogmo_rtdb_objid_t parent_oid,
+                                 kogmo_rtdb_objid_t proc_oid,
+                                 kogmo_timestamp_t ts,
+                                 int flags);
+
+/*! \brief Get the next Chunk of Results of a Search.
+ *
+ * \param db_h        Database handle
+ * \param search_p    Cursor initialized by kogmo_rtdb_obj_searchinfo_begin()
+ * \param oids        Array to receive up to n object-IDs
+ * \param n           Size of oids
+ * \returns           <0 on errors, the number of object-IDs written to oids,
+ *                    0 if there are no more results
+ */
+int
+kogmo_rtdb_obj_searchinfo_next (kogmo_rtdb_handle_t *db_h,
+                                kogmo_rtdb_obj_search_t *search_p,
+                                kogmo_rtdb_objid_t *oids,
+                                int n);
+
+/*! \brief Finish a Search.
+ * The cursor can be reused for another kogmo_rtdb_obj_searchinfo_begin().
+ */
+int
+kogmo_rtdb_obj_searchinfo_end (kogmo_rtdb_handle_t *db_h,
+                               kogmo_rtdb_obj_search_t *search_p);
+
+
 /*! \brief Search and Wait until an Object specified by its Name, Parent, creating Process and Time exists.
  *
  * This function searches and waits if necessary until there is an object,
@@ -409,6 +474,34 @@ kogmo_rtdb_obj_writedata (kogmo_rtdb_handle_t *db_h,
                           void *data_p);
 
 
+/*! \brief Write only the changed Parts of the Data of an Object to the Database.
+ *
+ * Like kogmo_rtdb_obj_writedata(), but instead of the whole Data-Block only
+ * the changes to the latest data in the database are given.
+ * The database builds the new data from the latest data and the patches,
+ * so the data need not be copied from your process.
+ * This saves memory bandwidth for large objects where only a few parts
+ * change every cycle (e.g. occupancy grids).
+ *
+ * \param db_h        Database handle
+ * \param oid         Object-ID of the object to write
+ * \param data_p      Pointer to a kogmo_rtdb_subobj_base_t with the header
+ *                    for the new data (size and data_ts), only the header is used;
+ *                    if size grows, the new part is zeroed before the patches are applied
+ * \param patches     Array of changed byte ranges, they are applied in this
+ *                    order and must lie after the header and within size
+ * \param count       Number of entries in patches
+ * \returns           <0 on errors, see kogmo_rtdb_obj_writedata()
+ *  \retval -KOGMO_RTDB_ERR_INVALID    The data size or a patch is not allowed
+ */
+int
+kogmo_rtdb_obj_writedata_delta (kogmo_rtdb_handle_t *db_h,
+                                kogmo_rtdb_objid_t oid,
+                                void *data_p,
+                                _const kogmo_rtdb_obj_patch_t *patches,
+                                int count);
+
+
 /*! \brief Read the latest Data of an Object from the Database
  *
  * This function reads the latest Data-Block of an Object from the database
@@ -504,6 +597,35 @@ kogmo_rtdb_obj_readdata_datayounger (kogmo_rtdb_handle_t *db_h,
                                      kogmo_rtdb_objsize_t size);
 
 
+/*! \brief Read only a Part of the Data of an Object.
+ *
+ * Like kogmo_rtdb_obj_readdata(), but only the base header and the bytes
+ * offset..offset+len-1 of the Data-Block are copied, at the same positions
+ * as in the object. Use this if you only need e.g. the header of an image,
+ * a region of interest or the first entries of a list.
+ * The rest of the buffer at data_p is not touched, the part of the range
+ * beyond the real size of the object is not copied. base.size is set to
+ * the end of the copied data.
+ *
+ * \param db_h    database handle
+ * \param oid     Object-ID of the desired Object
+ * \param ts      Timestamp at which the Object must be "the last committed";
+ *                0 for "now"
+ * \param offset  Offset of the range from the beginning of the object
+ * \param len     Length of the range, use 0 to read only the base header
+ * \param data_p  Pointer to a Object-Data-Struct, it must be able to absorb
+ *                at least offset+len bytes
+ * \returns       <0 on errors, the real size of the object data found in the rtdb on success
+ */
+kogmo_rtdb_objsize_t
+kogmo_rtdb_obj_readdata_range (kogmo_rtdb_handle_t *db_h,
+                               kogmo_rtdb_objid_t oid,
+                               kogmo_timestamp_t ts,
+                               kogmo_rtdb_objsize_t offset,
+                               kogmo_rtdb_objsize_t len,
+                               void *data_p);
+
+
 
 /*! \brief Get the latest Data for an Object that has been committed after a given timestamp, and wait if there is no newer data
  *
@@ -596,6 +718,60 @@ kogmo_rtdb_obj_readdata_ptr (kogmo_rtdb_handle_t *db_h,
                              void *data_pp);
 
 
+/*! \brief Start a guarded Read of the latest Data of an Object with a Pointer
+ *
+ * Like kogmo_rtdb_obj_readdata_ptr(), but also returns the commit timestamp
+ * of the data. When you are done with the data, call
+ * kogmo_rtdb_obj_readdata_ptr_end() to find out whether it has been
+ * overwritten in the meantime. This saves the copy for large objects.
+ *
+ * \param db_h           Database handle
+ * \param oid            Object-ID of the desired object
+ * \param ts             Timestamp at which the Object must be "the last committed";
+ *                       0 for "now"
+ * \param data_pp        Pointer to a pointer, that will point to the object data structure for reading afterwards
+ * \param committed_ts_p Pointer to a timestamp that receives the commit
+ *                       timestamp of the data, pass it to kogmo_rtdb_obj_readdata_ptr_end()
+ * \returns              <0 on errors (-KOGMO_RTDB_ERR_HISTWRAP if the data is
+ *                       being overwritten right now), the real size of the object data
+ *
+ * Example: \code
+ *                kogmo_rtdb_obj_c3_blaobj_t *myobj_p;
+ *                kogmo_timestamp_t ts;
+ *                do {
+ *                  kogmo_rtdb_obj_readdata_ptr_begin(..,&myobj_p,&ts);
+ *                  process myobj_p
+ *                } while ( kogmo_rtdb_obj_readdata_ptr_end(..,&myobj_p,ts) == -KOGMO_RTDB_ERR_HISTWRAP );
+ * \endcode
+ */
+kogmo_rtdb_objsize_t
+kogmo_rtdb_obj_readdata_ptr_begin (kogmo_rtdb_handle_t *db_h,
+                                   kogmo_rtdb_objid_t oid,
+                                   kogmo_timestamp_t ts,
+                                   void *data_pp,
+                                   kogmo_timestamp_t *committed_ts_p);
+
+
+/*! \brief Finish a guarded Read with a Pointer
+ *
+ * Checks that the data you got from kogmo_rtdb_obj_readdata_ptr_begin()
+ * has not been overwritten while you were using it.
+ *
+ * \param db_h         Database handle
+ * \param oid          Object-ID of the object
+ * \param data_pp      Pointer to the pointer you got from kogmo_rtdb_obj_readdata_ptr_begin()
+ * \param committed_ts Commit timestamp you got from kogmo_rtdb_obj_readdata_ptr_begin()
+ * \returns            0 if the data was valid during the whole time,
+ *                     -KOGMO_RTDB_ERR_HISTWRAP if it has been overwritten and
+ *                     your results are from corrupted data, <0 on other errors
+ */
+int
+kogmo_rtdb_obj_readdata_ptr_end (kogmo_rtdb_handle_t *db_h,
+                                 kogmo_rtdb_objid_t oid,
+                                 void *data_pp,
+                                 kogmo_timestamp_t committed_ts);
+
+
 /*! \brief Start pointer-based write (fast but dangerous)
  *
  * Call this function to receive a pointer where you can
@@ -795,6 +971,44 @@ kogmo_rtdb_setstatus (kogmo_rtdb_handle_t *db_h, uint32_t status, _const char* m
 int  
 kogmo_rtdb_cycle_done (kogmo_rtdb_handle_t *db_h, uint32_t flags);
 
+/*! \brief Let Waits for new Data of this Connection spin before they sleep.
+ * Normally kogmo_rtdb_obj_readdata_waitnext() and similar sleep in the
+ * kernel at once if there is no new data. The wakeup of a sleeping reader
+ * can take longer than the time between a commit and the next one.
+ * With a spin time, readers watch the commit word of the object in user
+ * space first and sleep only if there was no commit within that time.
+ * This costs CPU time while waiting, so use it only on cores of their own.
+ * The defaults are taken from the environment variables
+ * KOGMO_RTDB_WAIT_SPIN (seconds) and KOGMO_RTDB_WAIT_YIELD at connect.
+ *
+ * \param db_h       database handle
+ * \param spin_time  time to spin in seconds, 0 to sleep at once,
+ *                   e.g. 0.0001 for 100 microseconds
+ * \param yield      1: call sched_yield() while spinning,
+ *                   so that other threads on the same core can run
+ * \returns          <0 on errors
+ *
+ * Spinning is only available with futex-based notifications (Linux),
+ * otherwise it is ignored.
+ * Use kogmo_rtdb_getwaitstats() to check whether the spin time fits.
+ */
+int
+kogmo_rtdb_setwaitspin (kogmo_rtdb_handle_t *db_h, float spin_time, int yield);
+
+/*! \brief Get the Counters of the Waits for new Data of this Connection.
+ * The ratio of spin_wakeups to blocks tells how often spinning with
+ * kogmo_rtdb_setwaitspin() saved sleeping in the kernel.
+ * The counters are not synchronized between threads that share a handle.
+ *
+ * \param db_h   database handle
+ * \param stats  pointer to a kogmo_rtdb_waitstats_t that receives the counters,
+ *               may be NULL
+ * \param reset  1: set the counters to 0 afterwards
+ * \returns      <0 on errors
+ */
+int
+kogmo_rtdb_getwaitstats (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_waitstats_t *stats, int reset);
+
 
 
 int
@@ -919,6 +1133,215 @@ kogmo_rtdb_obj_readdataslot_check (kogmo_rtdb_handle_t *db_h,
                                    kogmo_rtdb_obj_slot_t *objslot);
 
 
+
+/*! \brief Bind an Object to a Handle for fast repeated Access.
+ * The bound calls skip the object lookup and the permission checks,
+ * they only check that the object still exists.
+ * This pays off for processes that read or write the same objects
+ * in every cycle.
+ *
+ * \param db_h    database handle
+ * \param oid     Object-ID of the desired Object
+ * \param objh    Pointer to the handle to fill
+ * \returns       <0 on errors (-KOGMO_RTDB_ERR_NOTFOUND if there is
+ *                no such object with data), 0 on success
+ */
+int
+kogmo_rtdb_obj_bind (kogmo_rtdb_handle_t *db_h,
+                     kogmo_rtdb_objid_t oid,
+                     kogmo_rtdb_obj_handle_t *objh);
+
+/*! \brief kogmo_rtdb_obj_readdata() for a bound Object.
+ * \see kogmo_rtdb_obj_bind() and kogmo_rtdb_obj_readdata()
+ */
+kogmo_rtdb_objsize_t
+kogmo_rtdb_obj_readdata_bound (kogmo_rtdb_handle_t *db_h,
+                               kogmo_rtdb_obj_handle_t *objh,
+                               kogmo_timestamp_t ts,
+                               void *data_p,
+                               kogmo_rtdb_objsize_t size);
+
+/*! \brief kogmo_rtdb_obj_writedata() for a bound Object.
+ * \see kogmo_rtdb_obj_bind() and kogmo_rtdb_obj_writedata()
+ */
+int
+kogmo_rtdb_obj_writedata_bound (kogmo_rtdb_handle_t *db_h,
+                                kogmo_rtdb_obj_handle_t *objh,
+                                void *data_p);
+
+/*! \brief kogmo_rtdb_obj_readdata_waitnext_until() for a bound Object.
+ * \see kogmo_rtdb_obj_bind() and kogmo_rtdb_obj_readdata_waitnext_until()
+ */
+kogmo_rtdb_objsize_t
+kogmo_rtdb_obj_readdata_waitnext_bound (kogmo_rtdb_handle_t *db_h,
+                                        kogmo_rtdb_obj_handle_t *objh,
+                                        kogmo_timestamp_t old_ts,
+                                        void *data_p,
+                                        kogmo_rtdb_objsize_t size,
+                                        kogmo_timestamp_t wakeup_ts);
+
+/*! \brief Wait until any of several Objects has new Data.
+ * This is kogmo_rtdb_obj_readdata_waitnext_until() for a list of objects
+ * in one thread, e.g. for a fusion process that reacts to whichever
+ * sensor updates first. It does not read the data, use
+ * kogmo_rtdb_obj_readdata() for the changed objects afterwards.
+ * If your objects have the no_notifies flag, the call polls.
+ *
+ * \param db_h      database handle
+ * \param oids      array of count Object-IDs
+ * \param old_ts    array of count commit timestamps, an object has
+ *                  changed if it has data committed after its old_ts
+ *                  (0: any data)
+ * \param count     number of objects
+ * \param wakeup_ts absolute time to give up (0: wait infinitely)
+ * \param changed   array of count results: 1 if the object has new data,
+ *                  -1 if it has been deleted or does not exist, 0 otherwise
+ * \returns         the number of objects with changed!=0,
+ *                  -KOGMO_RTDB_ERR_TIMEOUT on timeout, <0 on other errors
+ */
+int
+kogmo_rtdb_obj_wait_any (kogmo_rtdb_handle_t *db_h,
+                         const kogmo_rtdb_objid_t *oids,
+                         const kogmo_timestamp_t *old_ts,
+                         int count, kogmo_timestamp_t wakeup_ts,
+                         int *changed);
+
+/*! \brief Wait until all of several Objects have Data from the same Time.
+ * This is a barrier for synchronized sensors, e.g. the cameras of a
+ * stereo or surround-view system: it returns once per frame set,
+ * when every object has a frame whose data_ts lies within
+ * data_ts_tolerance of the others. If the inputs lag behind each other,
+ * the frames are taken from their histories.
+ * The call sleeps until the slowest objects commit, it does not wake
+ * up for every single frame.
+ *
+ * Like with kogmo_rtdb_obj_readdata_between_ptr(), you get pointers into
+ * the database that are valid at return. Check each of them with
+ * kogmo_rtdb_obj_readdata_ptr_end() and its committed_ts after use.
+ *
+ * \param db_h      database handle
+ * \param oids      array of count Object-IDs
+ * \param count     number of objects
+ * \param data_ts_tolerance maximum difference of the data_ts within a set
+ * \param wakeup_ts absolute time to give up (0: wait infinitely)
+ * \param set_ts_p  Pointer to the largest data_ts of the previous set
+ *                  (initialize it with 0), all frames of the new set are
+ *                  newer; receives the largest data_ts of the new set
+ * \param ptrs_p    Pointer to an array of count pointers to
+ *                  Object-Data-Structs that receives the set
+ * \param committed_ts array of count timestamps that receives the
+ *                  committed_ts of the frames, or NULL
+ * \returns         count on success, -KOGMO_RTDB_ERR_TIMEOUT on timeout,
+ *                  -KOGMO_RTDB_ERR_NOTFOUND if an object does not exist
+ *                  (any more), <0 on other errors
+ */
+int
+kogmo_rtdb_obj_wait_all (kogmo_rtdb_handle_t *db_h,
+                         const kogmo_rtdb_objid_t *oids, int count,
+                         kogmo_timestamp_t data_ts_tolerance,
+                         kogmo_timestamp_t wakeup_ts,
+                         kogmo_timestamp_t *set_ts_p,
+                         void *ptrs_p, kogmo_timestamp_t *committed_ts);
+
+/*! \brief Get a File Descriptor that becomes readable when an Object
+ * gets new Data.
+ * This integrates the database into event loops that already use
+ * poll(), select() or epoll for sockets and timers. The descriptor is
+ * an eventfd: read 8 bytes from it to reset it, then read the latest
+ * data of the object with kogmo_rtdb_obj_readdata(). Several commits
+ * before that read give only one event. If the object gets deleted, the
+ * descriptor becomes readable a last time.
+ *
+ * A notifier thread of your process waits for all subscribed objects
+ * with kogmo_rtdb_obj_wait_any() and signals the descriptors. It is
+ * started with the first subscription and stopped by kogmo_rtdb_disconnect().
+ * If that thread fails, all descriptors become readable a last time and
+ * further subscriptions return -KOGMO_RTDB_ERR_UNKNOWN until you reconnect.
+ *
+ * \param db_h   database handle
+ * \param oid    Object-ID of the Object to watch
+ * \returns      the file descriptor (non-blocking) on success,
+ *               <0 on errors (-KOGMO_RTDB_ERR_OUTOFOBJ if this process
+ *               has too many subscriptions)
+ */
+int
+kogmo_rtdb_obj_subscribe_fd (kogmo_rtdb_handle_t *db_h,
+                             kogmo_rtdb_objid_t oid);
+
+/*! \brief Stop the Events of a File Descriptor from
+ * kogmo_rtdb_obj_subscribe_fd() and close it.
+ *
+ * \param db_h   database handle
+ * \param fd     the file descriptor
+ * \returns      <0 on errors, 0 on success
+ */
+int
+kogmo_rtdb_obj_unsubscribe_fd (kogmo_rtdb_handle_t *db_h, int fd);
+
+/*! \brief Read the Data of several Objects as a consistent Snapshot.
+ * All reads see the database at the same moment: a commit to any of the
+ * objects is either included in all reads or in none. For each entry the
+ * latest data committed at or before its ts (0: the latest data) within
+ * this snapshot is read, like kogmo_rtdb_obj_readdata().
+ * The result of each read is stored in its entry.
+ *
+ * \param db_h   database handle
+ * \param reads  array of reads, see kogmo_rtdb_obj_readmulti_t
+ * \param count  number of entries in reads
+ * \returns       the number of successful reads, <0 on errors
+ */
+int
+kogmo_rtdb_obj_readdata_multi (kogmo_rtdb_handle_t *db_h,
+                               kogmo_rtdb_obj_readmulti_t *reads, int count);
+
+
+/*! \brief Read all Data of an Object from its History that has been committed
+ * within a Time Window.
+ * This copies all history entries with begin_ts <= committed_ts <= end_ts
+ * in one call, the oldest first. Wrap-around is checked once for the
+ * whole batch: either all entries are valid or the call fails with
+ * -KOGMO_RTDB_ERR_HISTWRAP and you should try it again.
+ *
+ * \param db_h      database handle
+ * \param oid       Object-ID of the desired Object
+ * \param begin_ts  oldest commit timestamp to include
+ * \param end_ts    latest commit timestamp to include
+ * \param data_p    Pointer to an array of max_count Object-Data-Structs,
+ *                  each of them size bytes large
+ * \param size      Size of each element in data_p, the data is truncated
+ *                  like in kogmo_rtdb_obj_readdata()
+ * \param max_count Maximum number of entries to read, if there are more
+ *                  entries within the window, the oldest are returned;
+ *                  continue with begin_ts after the last committed_ts
+ * \returns         <0 on errors, the number of entries read on success
+ *                  (0 if there is no data within the window)
+ */
+int
+kogmo_rtdb_obj_readdata_between (kogmo_rtdb_handle_t *db_h,
+                                 kogmo_rtdb_objid_t oid,
+                                 kogmo_timestamp_t begin_ts,
+                                 kogmo_timestamp_t end_ts,
+                                 void *data_p, kogmo_rtdb_objsize_t size,
+                                 int max_count);
+
+/*! \brief kogmo_rtdb_obj_readdata_between() with pointers.
+ * This fills an array of pointers into the database instead of copying
+ * the data. They are valid at return. Later commits overwrite the oldest
+ * entry first, so check that the committed_ts of the first one is still
+ * the same at the end of your calculations.
+ *
+ * \param ptrs_p    Pointer to an array of max_count pointers to
+ *                  Object-Data-Structs
+ * \see kogmo_rtdb_obj_readdata_between() and kogmo_rtdb_obj_readdata_ptr()
+ */
+int
+kogmo_rtdb_obj_readdata_between_ptr (kogmo_rtdb_handle_t *db_h,
+                                     kogmo_rtdb_objid_t oid,
+                                     kogmo_timestamp_t begin_ts,
+                                     kogmo_timestamp_t end_ts,
+                                     void *ptrs_p, int max_count);
+
+
 #ifdef __cplusplus
  }; /* extern "C" */
  }; /* namespace KogniMobil */
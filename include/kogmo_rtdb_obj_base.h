@@ -84,15 +84,24 @@ typedef PACKED_struct
  char                 dbhost[KOGMO_RTDB_OBJMETA_NAME_MAXLEN];
  uint32_t             version_rev; // 123
  char                 version_date[30]; // 2006-09-19 11:23:51 +01:00:00
- char                 version_id[402];
+ char                 version_id[394];
  uint32_t             objects_max;
  uint32_t             objects_free;
  uint32_t             processes_max;
  uint32_t             processes_free;
  kogmo_rtdb_objsize_t memory_max;
  kogmo_rtdb_objsize_t memory_free;
+ uint32_t             page_size; // page size backing the object data in bytes
+ uint32_t             page_type; // KOGMO_RTDB_PAGETYPE_*
 } kogmo_rtdb_subobj_c3_rtdb_t;
 
+/*! \brief Kind of pages backing the object data (kogmo_rtdb_subobj_c3_rtdb_t.page_type)
+ */
+#define KOGMO_RTDB_PAGETYPE_NORMAL    0 //!< normal pages
+#define KOGMO_RTDB_PAGETYPE_THP       1 //!< transparent huge pages requested by madvise()
+#define KOGMO_RTDB_PAGETYPE_HUGETLBFS 2 //!< file on a hugetlbfs mount
+#define KOGMO_RTDB_PAGETYPE_MEMFD     3 //!< memfd_create(MFD_HUGETLB)
+
 /*! \brief Full Object for RTDB Info
  */
 typedef PACKED_struct
@@ -16,6 +16,7 @@
 #endif
 
 #include "kogmo_rtdb.hxx"
+#include <vector>
 
 // This is a hook for your extentions, if you need extra includes for your extra methods
 #ifdef KOGMO_RTDB_OBJ_BASE_CLASS_EXTRA_INCLUDES_FILE
@@ -57,6 +58,15 @@ class RTDBObj
   private:
     void operator= ( const RTDBObj& src); // zuweisung sperren (bitte Copy() benutzen)
     int *reference_counter;
+    // bound handle for fast access, (re)bound whenever objinfo_p->oid changes
+    kogmo_rtdb_obj_handle_t *objh_p;
+    bool bindHandle ()
+      {
+        if ( objinfo_p -> oid && objh_p -> oid == objinfo_p -> oid )
+          return true;
+        // on errors fall back to the calls with oid, they report the error
+        return kogmo_rtdb_obj_bind (db_h, objinfo_p -> oid, objh_p) >= 0;
+      };
   public:
     // This is the Basis-Constructor. Don't look at it.
     // See A2_RoadKloth for a good example how to use it.
@@ -95,6 +105,9 @@ class RTDBObj
 	    	// Reference Counter for Copy Constructor
 	    	reference_counter = new int;
 	    	(*reference_counter) = 1;
+
+        objh_p = new kogmo_rtdb_obj_handle_t;
+        memset ( objh_p, 0, sizeof(kogmo_rtdb_obj_handle_t) );
       };
 
 			//!< Copy Constructor. Makes a shallow copy. Pointers and database-handles are shared with original object
@@ -107,6 +120,7 @@ class RTDBObj
 		    objsize_p = src.objsize_p; 
 		    objsize_min_p = src.objsize_min_p;
 				reference_counter = src.reference_counter; 
+				objh_p = src.objh_p;
 	    	(*reference_counter)++;
       };
 
@@ -121,6 +135,7 @@ class RTDBObj
 			    delete objsize_min_p;
 	        delete objbase_p;
 	        delete objinfo_p;
+	        delete objh_p;
 	    	}
       };
 
@@ -406,7 +421,10 @@ class RTDBObj
 	int err;
         do
 	 {
-          err = kogmo_rtdb_obj_writedata (db_h, objinfo_p -> oid, objbase_p);
+          if ( bindHandle () )
+            err = kogmo_rtdb_obj_writedata_bound (db_h, objh_p, objbase_p);
+          else
+            err = kogmo_rtdb_obj_writedata (db_h, objinfo_p -> oid, objbase_p);
           if ( err == -KOGMO_RTDB_ERR_TOOFAST )
             std::cout << "too fast!\n";
          }
@@ -418,8 +436,12 @@ class RTDBObj
     void RTDBRead ( Timestamp ts = 0 ) // TODO: read at different commit/data timestamps
       {
         kogmo_rtdb_objsize_t osize;
-        osize = kogmo_rtdb_obj_readdata (db_h, objinfo_p -> oid, ts,
-                                         objbase_p, (*objsize_p));
+        if ( bindHandle () )
+          osize = kogmo_rtdb_obj_readdata_bound (db_h, objh_p, ts,
+                                                 objbase_p, (*objsize_p));
+        else
+          osize = kogmo_rtdb_obj_readdata (db_h, objinfo_p -> oid, ts,
+                                           objbase_p, (*objsize_p));
         if ( osize < 0 )
           {
             objbase_p -> size = 0;
@@ -443,6 +465,22 @@ class RTDBObj
           throw DBError(-KOGMO_RTDB_ERR_INVALID);
       };
 
+    // liest nur den header und die bytes offset..offset+len-1 der daten
+    // (z.b. bildheader oder region of interest), der rest bleibt unveraendert
+    void RTDBReadRange ( int32_t offset, int32_t len, Timestamp ts = 0 )
+      {
+        kogmo_rtdb_objsize_t osize;
+        if ( offset < 0 || len < 0 || offset + len > (*objsize_p) )
+          throw DBError(-KOGMO_RTDB_ERR_INVALID);
+        osize = kogmo_rtdb_obj_readdata_range (db_h, objinfo_p -> oid, ts,
+                                               offset, len, objbase_p);
+        if ( osize < 0 )
+          {
+            objbase_p -> size = 0;
+            throw DBError(osize);
+          }
+      };
+
     void RTDBReadWaitNext ( Timestamp old_ts = 0, float timeout = 0 )
       // hier: relativer Timeout, z.B. timeout = 0.01 -> blockiere max 10ms (ist einfacher)
       // die *_until() Funktionen nehmen einen *absoluten* Timeout, wichtig fuer Realzeit
@@ -459,8 +497,12 @@ class RTDBObj
         kogmo_rtdb_objsize_t osize;
         if ( ! old_ts )
           old_ts = objbase_p -> committed_ts;
-        osize = kogmo_rtdb_obj_readdata_waitnext_until (db_h, objinfo_p -> oid,
-                                                        old_ts, objbase_p, (*objsize_p), wakeup_ts);
+        if ( bindHandle () )
+          osize = kogmo_rtdb_obj_readdata_waitnext_bound (db_h, objh_p,
+                                                          old_ts, objbase_p, (*objsize_p), wakeup_ts);
+        else
+          osize = kogmo_rtdb_obj_readdata_waitnext_until (db_h, objinfo_p -> oid,
+                                                          old_ts, objbase_p, (*objsize_p), wakeup_ts);
         if ( osize < 0 )
           throw DBError(osize);
         if ( osize < (*objsize_min_p) )
@@ -733,6 +775,247 @@ inline std::ostream& operator<< (std::ostream& out, const RTDBObj& O)
 };
 
 
+/*! \brief Children of a Real-time Database Object
+ * Takes a snapshot of the Object-IDs of all children of an object
+ * (uses the parent index of the database) and allows to iterate over them:
+ * \code
+ *  RTDBObjChildren children(DBC, parent.getOID());
+ *  for ( RTDBObjChildren::iterator it = children.begin(); it != children.end(); ++it )
+ *    child.RTDBSearch(*it);
+ * \endcode
+ */
+class RTDBObjChildren
+{
+  private:
+    std::vector<kogmo_rtdb_objid_t> oids;
+  public:
+    typedef std::vector<kogmo_rtdb_objid_t>::const_iterator iterator;
+
+    RTDBObjChildren (const class RTDBConn& DBC, kogmo_rtdb_objid_t parent_oid,
+                     kogmo_rtdb_objtype_t otype = 0, Timestamp ts = 0)
+      {
+        kogmo_rtdb_obj_search_t search;
+        int n, err;
+        err = kogmo_rtdb_obj_searchinfo_begin ( DBC.getHandle(), &search, "", otype,
+                                                parent_oid, 0, ts, 0);
+        if ( err < 0 )
+          throw DBError(err);
+        do
+          {
+            size_t have = oids.size();
+            oids.resize ( have + 64 );
+            n = kogmo_rtdb_obj_searchinfo_next ( DBC.getHandle(), &search, &oids[have], 64 );
+            oids.resize ( have + ( n > 0 ? n : 0 ) );
+          }
+        while ( n > 0 );
+        kogmo_rtdb_obj_searchinfo_end ( DBC.getHandle(), &search );
+        if ( n < 0 )
+          throw DBError(n);
+      };
+
+    iterator begin (void) const { return oids.begin(); };
+    iterator end (void) const { return oids.end(); };
+    int size (void) const { return oids.size(); };
+    bool empty (void) const { return oids.empty(); };
+    kogmo_rtdb_objid_t operator[] (int i) const { return oids[i]; };
+};
+
+
+/*! \brief Group of Real-time Database Objects that are read together
+ * as a consistent snapshot (see kogmo_rtdb_obj_readdata_multi()):
+ * \code
+ *  RTDBObjGroup group;
+ *  group.add(obj1);
+ *  group.add(obj2);
+ *  group.RTDBRead();
+ * \endcode
+ * The objects must stay alive as long as they are in the group.
+ */
+class RTDBObjGroup
+{
+  private:
+    std::vector<RTDBObj*> objs;
+    std::vector<kogmo_rtdb_obj_readmulti_t> reads;
+  public:
+    void add (RTDBObj& obj)
+      {
+        kogmo_rtdb_obj_readmulti_t read;
+        memset ( &read, 0, sizeof(read) );
+        objs.push_back ( &obj );
+        reads.push_back ( read );
+      };
+
+    int size (void) const { return objs.size(); };
+
+    //! Result of the last read of the i-th object: its data size or an error
+    kogmo_rtdb_objsize_t getResult (int i) const { return reads[i].result; };
+
+    //! Reads all objects at commit time ts (0: the latest data).
+    //! Throws DBError for the first object that could not be read,
+    //! the other objects are read nevertheless.
+    void RTDBRead ( Timestamp ts = 0 )
+      {
+        int i, n = objs.size();
+        if ( n == 0 )
+          return;
+        for ( i = 0; i < n; i++ )
+          {
+            reads[i].oid = objs[i] -> objinfo_p -> oid;
+            reads[i].ts = ts;
+            reads[i].data_p = objs[i] -> objbase_p;
+            reads[i].size = *(objs[i] -> objsize_p);
+          }
+        int err = kogmo_rtdb_obj_readdata_multi (objs[0] -> db_h, &reads[0], n);
+        if ( err < 0 )
+          throw DBError(err);
+        err = 0;
+        for ( i = 0; i < n; i++ )
+          {
+            if ( reads[i].result >= 0 && reads[i].result < *(objs[i] -> objsize_min_p) )
+              reads[i].result = -KOGMO_RTDB_ERR_INVALID;
+            if ( reads[i].result < 0 )
+              {
+                objs[i] -> objbase_p -> size = 0;
+                if ( !err )
+                  err = reads[i].result;
+              }
+          }
+        if ( err < 0 )
+          throw DBError(err);
+      };
+};
+
+
+/*! \brief Set of Real-time Database Objects to wait for, whichever
+ * gets new data first (see kogmo_rtdb_obj_wait_any()):
+ * \code
+ *  RTDBWaitSet waitset;
+ *  waitset.add(camera);
+ *  waitset.add(radar);
+ *  for (;;)
+ *    {
+ *      waitset.RTDBWaitAny();
+ *      if ( waitset.isChanged(0) )
+ *        process camera
+ *      if ( waitset.isChanged(1) )
+ *        process radar
+ *    }
+ * \endcode
+ * The changed objects are read, so the next wait continues
+ * after the data they contain.
+ * The objects must stay alive as long as they are in the set.
+ */
+class RTDBWaitSet
+{
+  private:
+    std::vector<RTDBObj*> objs;
+    std::vector<kogmo_rtdb_objid_t> oids;
+    std::vector<kogmo_timestamp_t> old_ts;
+    std::vector<int> changed;
+  public:
+    void add (RTDBObj& obj)
+      {
+        objs.push_back ( &obj );
+        oids.push_back ( 0 );
+        old_ts.push_back ( 0 );
+        changed.push_back ( 0 );
+      };
+
+    int size (void) const { return objs.size(); };
+
+    //! True if the i-th object had new data at the last wait
+    bool isChanged (int i) const { return changed[i] > 0; };
+    //! True if the i-th object had been deleted at the last wait
+    bool isDeleted (int i) const { return changed[i] < 0; };
+
+    //! Waits until any object has data newer than the data it contains
+    //! and reads all changed objects, returns their number.
+    //! The timeout is relative like in RTDBObj::RTDBReadWaitNext(),
+    //! throws DBError on timeout or if a changed object could not be read.
+    int RTDBWaitAny ( float timeout = 0 )
+      {
+        int i, n = objs.size();
+        if ( n == 0 )
+          return 0;
+        Timestamp wakeup_ts = 0;
+        if ( timeout )
+          {
+            wakeup_ts.now();
+            wakeup_ts+=timeout;
+          }
+        for ( i = 0; i < n; i++ )
+          {
+            oids[i] = objs[i] -> objinfo_p -> oid;
+            old_ts[i] = objs[i] -> objbase_p -> committed_ts;
+          }
+        int err = kogmo_rtdb_obj_wait_any (objs[0] -> db_h, &oids[0], &old_ts[0], n,
+                                           wakeup_ts, &changed[0]);
+        if ( err < 0 )
+          throw DBError(err);
+        for ( i = 0; i < n; i++ )
+          if ( changed[i] > 0 )
+            objs[i] -> RTDBRead ();
+        return err;
+      };
+};
+
+
+/*! \brief Guarded Read of the Data of an Object in place with a Pointer
+ * into the Database (see kogmo_rtdb_obj_readdata_ptr_begin()).
+ * This saves the copy for large objects:
+ * \code
+ *  for (;;)
+ *    {
+ *      RTDBReadGuard<kogmo_rtdb_obj_a2_image_t> img(DBC, oid);
+ *      process img->image.data
+ *      if ( img.isValid() )
+ *        break;
+ *      // overwritten meanwhile, try it again
+ *    }
+ * \endcode
+ * The data must not be modified and must not be used any more after
+ * the guard has been destroyed.
+ */
+template < typename KOGMO_STRUCT = kogmo_rtdb_subobj_base_t > class RTDBReadGuard
+{
+  private:
+    kogmo_rtdb_handle_t *db_h;
+    kogmo_rtdb_objid_t oid;
+    KOGMO_STRUCT *data_p;
+    kogmo_timestamp_t committed_ts;
+    kogmo_rtdb_objsize_t size;
+    RTDBReadGuard (const RTDBReadGuard& src); // kopieren sperren
+    void operator= (const RTDBReadGuard& src);
+  public:
+    //! Starts the read of the data committed at ts (0: the latest data).
+    //! Throws DBError if there is no such data or it is too small.
+    RTDBReadGuard (const class RTDBConn& DBC, kogmo_rtdb_objid_t oid_in, Timestamp ts = 0)
+      {
+        db_h = DBC.getHandle();
+        oid = oid_in;
+        size = kogmo_rtdb_obj_readdata_ptr_begin (db_h, oid, ts.timestamp(),
+                                                  &data_p, &committed_ts);
+        if ( size < 0 )
+          throw DBError(size);
+        if ( size < (kogmo_rtdb_objsize_t) sizeof(KOGMO_STRUCT) )
+          throw DBError(-KOGMO_RTDB_ERR_INVALID);
+      };
+
+    const KOGMO_STRUCT* get (void) const { return data_p; };
+    const KOGMO_STRUCT* operator-> (void) const { return data_p; };
+    kogmo_rtdb_objsize_t getSize (void) const { return size; };
+    Timestamp getCommittedTimestamp (void) const { return committed_ts; };
+
+    //! True if the data has not been overwritten since the construction,
+    //! only then the results computed from it are valid.
+    bool isValid (void) const
+      {
+        KOGMO_STRUCT *ptr = data_p;
+        return kogmo_rtdb_obj_readdata_ptr_end (db_h, oid, &ptr, committed_ts) == 0;
+      };
+};
+
+
 /*
   Empfohlene Benutzung des Templates:
 
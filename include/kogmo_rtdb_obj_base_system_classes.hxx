@@ -368,6 +368,16 @@ class C3_RTDB : public RTDBObj
         return objrtdb_p->memory_free;
       }
 
+    uint32_t getPageSize () const
+      {
+        return objrtdb_p->page_size;
+      }
+
+    uint32_t getPageType () const
+      {
+        return objrtdb_p->page_type;
+      }
+
     std::string dump (void) const
       {
         std::ostringstream ostr;
@@ -381,7 +391,8 @@ class C3_RTDB : public RTDBObj
              << "Last Update of this Information: " << (float)((Timestamp().now()-getCommittedTimestamp())) << " seconds"<< std::endl
              << "Memory free: " << getMemoryFree() << "/" << getMemoryMax() << std::endl
              << "Objects free: " << getObjectsFree() << "/" << getObjectsMax() << std::endl
-             << "Processes free: " << getProcessesFree() << "/" << getProcessesMax() << std::endl;
+             << "Processes free: " << getProcessesFree() << "/" << getProcessesMax() << std::endl
+             << "Page size: " << getPageSize()/1024 << " kB (type " << getPageType() << ")" << std::endl;
         return RTDBObj::dump() + ostr.str();
       };
 };
@@ -650,13 +661,14 @@ template < int width = 1024, int height = 768, int channels = 1, int bits=8 > cl
           if ( read_ptr_ts != committed_ts )
            {
             kogmo_rtdb_objsize_t osize;
-            osize = kogmo_rtdb_obj_readdata_ptr (this->db_h, this->objinfo_p -> oid, committed_ts,
-                                             &read_ptr);
+            kogmo_timestamp_t ptr_ts;
+            osize = kogmo_rtdb_obj_readdata_ptr_begin (this->db_h, this->objinfo_p -> oid, committed_ts,
+                                                       &read_ptr, &ptr_ts);
             if ( osize < *(this->objsize_min_p) )
                 throw DBError(osize);
-            if ( read_ptr->base.committed_ts != (kogmo_timestamp_t) committed_ts )
+            if ( ptr_ts != (kogmo_timestamp_t) committed_ts )
                 throw DBError(-KOGMO_RTDB_ERR_HISTWRAP);
-            read_ptr_ts = this->getCommittedTimestamp();
+            read_ptr_ts = committed_ts;
            }
           return read_ptr->image.data;
          }
@@ -665,6 +677,12 @@ template < int width = 1024, int height = 768, int channels = 1, int bits=8 > cl
       {
         if ( !use_read_ptr )
           return true;
+        if (!committed_ts)
+          committed_ts = this->getCommittedTimestamp();
+        // the data of getData() is still there
+        if ( read_ptr != NULL && read_ptr_ts.timestamp() != 0 && committed_ts == read_ptr_ts )
+          return kogmo_rtdb_obj_readdata_ptr_end (this->db_h, this->objinfo_p -> oid,
+                                                  &read_ptr, read_ptr_ts) == 0;
         read_ptr_ts = 0; // force re-read
         try {
           getData(committed_ts);
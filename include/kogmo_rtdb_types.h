@@ -120,6 +120,33 @@ typedef char kogmo_rtdb_objname_t [KOGMO_RTDB_OBJMETA_NAME_MAXLEN];
 typedef kogmo_rtdb_objid_t kogmo_rtdb_objid_list_t [KOGMO_RTDB_OBJIDLIST_MAX+1];
 
 
+//! maximum length of a name or regular expression for a search cursor
+//! (including terminating null-byte)
+#define KOGMO_RTDB_SEARCH_NAME_MAXLEN 128
+//! search cursor flag: also find objects that are already marked deleted
+#define KOGMO_RTDB_SEARCH_FLAGS_DELETED 0x0001
+
+/*! \brief Cursor for a search without a limit on the number of results.
+ * It is filled by kogmo_rtdb_obj_searchinfo_begin() and contains the
+ * search parameters and the position within the object table.
+ * Its fields should not be changed by the caller.
+ */
+typedef PACKED_struct
+{
+  char                  name[KOGMO_RTDB_SEARCH_NAME_MAXLEN];
+  kogmo_rtdb_objtype_t  otype;
+  kogmo_rtdb_objid_t    parent_oid;
+  kogmo_rtdb_objid_t    proc_oid;
+  kogmo_timestamp_t     ts;
+  int32_t               flags;  // KOGMO_RTDB_SEARCH_FLAGS_*
+  int32_t               state;  // internal: 0=not started/ended, 1=running, 2=finished
+  int32_t               index;  // internal: index that is scanned
+  int32_t               slot;   // internal: last visited slot, -1 before the first
+  kogmo_rtdb_objid_t    oid;    // internal: oid in that slot
+  int32_t               reserved0;
+} kogmo_rtdb_obj_search_t;
+
+
 
 /*! \brief Data Block that contains Object-Metadata.
  * The Metadata of an Object should not (or only very slowly) change
@@ -247,6 +274,20 @@ typedef PACKED_struct
         //   a read request for the latest date will fail.
         //!< 0: default: a read request always gives out data, even if it's stale.
         //!< be used for error recovery.
+      uint32_t data_ts_index : 1;
+        //!< (U) 1: Keep an index of the history sorted by data_ts, so that
+        //!< kogmo_rtdb_obj_readdata_datatime(), _dataolder() and _datayounger()
+        //!< find the right data in O(log n) even if the data was committed
+        //!< out of order (e.g. late sensor frames). Costs 16 bytes per history slot
+        //!< and some time on each commit.
+        //!< 0: default: no index, data time reads scan the history from the latest
+        //!< data backwards and stop at the first match.
+      uint32_t numa_node : 8;
+        //!< (U) NUMA node + 1 on which the history buffer of the object should be placed,
+        //!< e.g. the node of the processes that will write the object.
+        //!< kogmo_rtdb_obj_insert() sets it to the node actually used + 1,
+        //!< or 0 if the buffer was not placed (e.g. on a system with a single node).
+        //!< 0: default: node of the inserting process.
     } flags;
 
   int32_t               history_size;
@@ -280,11 +321,53 @@ typedef PACKED_struct
   kogmo_timestamp_t     committed_ts;
   int32_t               object_slot;
   int32_t               history_slot;
-  int32_t               reserved0;
+  int32_t               slot_stride; // distance of the history slots within the object buffer
   int32_t               reserved1;
 } kogmo_rtdb_obj_slot_t;
 
 
+/*! \brief Bound object handle for reading and writing without an object lookup.
+ * Filled by kogmo_rtdb_obj_bind(). It stays valid as long as the object
+ * exists, afterwards all calls with it return -KOGMO_RTDB_ERR_NOTFOUND.
+ */
+
+typedef PACKED_struct
+{
+  kogmo_rtdb_objid_t    oid;         // bound object, 0 if not bound
+  int32_t               object_slot; // its slot in the object table
+  int32_t               access;      // KOGMO_RTDB_OBJ_HANDLE_READ | KOGMO_RTDB_OBJ_HANDLE_WRITE
+  int32_t               reserved0;
+} kogmo_rtdb_obj_handle_t;
+
+#define KOGMO_RTDB_OBJ_HANDLE_READ  1 //!< this process may read the object
+#define KOGMO_RTDB_OBJ_HANDLE_WRITE 2 //!< this process may commit data to the object
+
+
+/*! \brief One read of kogmo_rtdb_obj_readdata_multi().
+ */
+
+typedef PACKED_struct
+{
+  kogmo_rtdb_objid_t    oid;         // (U) object to read
+  int32_t               reserved0;
+  kogmo_timestamp_t     ts;          // (U) read the latest data committed at or before ts, 0: the latest data
+  void                 *data_p;      // (U) buffer for the data
+  kogmo_rtdb_objsize_t  size;        // (U) size of the buffer
+  kogmo_rtdb_objsize_t  result;      // (I) size of the data read (as kogmo_rtdb_obj_readdata()) or an error
+} kogmo_rtdb_obj_readmulti_t;
+
+
+/*! \brief One changed byte range for kogmo_rtdb_obj_writedata_delta().
+ */
+
+typedef PACKED_struct
+{
+  kogmo_rtdb_objsize_t  offset;      // (U) offset from the beginning of the object, >= sizeof(kogmo_rtdb_subobj_base_t)
+  kogmo_rtdb_objsize_t  len;         // (U) number of bytes
+  _const void          *data_p;      // (U) new data for this range
+} kogmo_rtdb_obj_patch_t;
+
+
 /*@}*/
 
 
@@ -356,6 +439,22 @@ typedef struct
 #define KOGMO_RTDB_CONNECT_FLAGS_REALTIME   0x0100
  //!< (internal, ask matthias.goebl*goebl.net before use)
 
+
+/*! \brief Counters of the Waits for new Data of a Connection
+ * See kogmo_rtdb_getwaitstats() and kogmo_rtdb_setwaitspin().
+ */
+
+typedef struct
+{
+  uint64_t waits;
+    //!< calls to kogmo_rtdb_obj_readdata_waitnext() and similar that
+    //!< found no new data at once and had to wait
+  uint64_t spin_wakeups;
+    //!< commits seen while spinning, without sleeping in the kernel
+  uint64_t blocks;
+    //!< sleeps in the kernel, after the spin time ran out
+} kogmo_rtdb_waitstats_t;
+
 /*@}*/
 
 
@@ -224,8 +224,8 @@ main (int argc, char **argv)
   int traceit=0, streamit=0, junkit=0, record_enable=1;
   char w;
 
-  int init_phase, init_i=0;
-  kogmo_rtdb_objid_list_t initial_objects;
+  int init_phase, init_i=0, n_initial=0;
+  kogmo_rtdb_objid_t *initial_objects = NULL;
 
   char                 *name_stream[10]={NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL};
   kogmo_rtdb_objid_t     oid_stream[10]={0,0,0,0,0,0,0,0,0,0};
@@ -473,19 +473,35 @@ main (int argc, char **argv)
         {
           if ( ! initial_ts )
             {
-              int n_obj=0;
+              kogmo_rtdb_obj_search_t search;
+              int n_obj, max_initial=0;
               initial_ts = kogmo_rtdb_timestamp_now(dbc);
-              oid = kogmo_rtdb_obj_searchinfo ( dbc, NULL, 0,0,0, initial_ts, initial_objects,0);
-              if ( oid < 0 )
+              err = kogmo_rtdb_obj_searchinfo_begin ( dbc, &search, NULL, 0,0,0, initial_ts, 0);
+              if ( err < 0 )
                 DIE("cannot get list of initial objects");
-              while ( n_obj < KOGMO_RTDB_OBJIDLIST_MAX && initial_objects[n_obj] > 0)
-                n_obj++;
+              n_initial = 0;
+              do
+                {
+                  if ( max_initial - n_initial < 256 )
+                    {
+                      max_initial += 1024;
+                      initial_objects = realloc ( initial_objects, max_initial * sizeof(kogmo_rtdb_objid_t) );
+                      if ( initial_objects == NULL )
+                        DIE("cannot allocate list of initial objects");
+                    }
+                  n_obj = kogmo_rtdb_obj_searchinfo_next ( dbc, &search, &initial_objects[n_initial], max_initial - n_initial );
+                  if ( n_obj < 0 )
+                    DIE("cannot get list of initial objects");
+                  n_initial += n_obj;
+                }
+              while ( n_obj > 0 );
+              kogmo_rtdb_obj_searchinfo_end ( dbc, &search );
               // sort oids numerically ascending so is it guaranteed that a parent objects is created first
-              qsort(&initial_objects[0], n_obj, sizeof(kogmo_rtdb_objid_t), compare_oid);
+              qsort(&initial_objects[0], n_initial, sizeof(kogmo_rtdb_objid_t), compare_oid);
               init_i=0;
             }
           freebuf=-1;
-          if ( initial_objects[init_i] != 0 )
+          if ( init_i < n_initial )
             {
               oid = initial_objects[init_i];
               ts = initial_ts;
@@ -497,6 +513,8 @@ main (int argc, char **argv)
           else
             {
               init_phase = 0;
+              free ( initial_objects );
+              initial_objects = NULL;
             }
           init_i++;
         }
@@ -61,7 +61,7 @@ void dump_recursive (kogmo_rtdb_handle_t *db_h,
 int
 main (int argc, char **argv)
 {
-  int i;
+  int i,j;
   char *p;
   kogmo_rtdb_handle_t *dbc;
   kogmo_rtdb_connect_info_t dbinfo;
@@ -181,6 +181,41 @@ main (int argc, char **argv)
       printf("* Memory free:    %d/%d MB\n",rtdbobj.rtdb.memory_free/1024/1024, rtdbobj.rtdb.memory_max/1024/1024);
       printf("* Objects free:   %d/%d\n",rtdbobj.rtdb.objects_free, rtdbobj.rtdb.objects_max);
       printf("* Processes free: %d/%d\n",rtdbobj.rtdb.processes_free, rtdbobj.rtdb.processes_max);
+      printf("* Page size:      %u kB (%s)\n",rtdbobj.rtdb.page_size/1024,
+             rtdbobj.rtdb.page_type == KOGMO_RTDB_PAGETYPE_THP ? "transparent huge pages" :
+             rtdbobj.rtdb.page_type == KOGMO_RTDB_PAGETYPE_HUGETLBFS ? "hugetlbfs" :
+             rtdbobj.rtdb.page_type == KOGMO_RTDB_PAGETYPE_MEMFD ? "memfd hugetlb" : "normal pages");
+      printf("* NUMA nodes:     %d\n",kogmo_rtdb_numa_nodes());
+      if ( do_resources && kogmo_rtdb_numa_nodes() > 1 )
+        {
+          kogmo_rtdb_obj_search_t search;
+          kogmo_rtdb_objid_t objlist[64];
+          long long int node_bytes[KOGMO_RTDB_NUMA_NODES_MAX+1];
+          int node_objects[KOGMO_RTDB_NUMA_NODES_MAX+1];
+          int n;
+          memset (node_bytes, 0, sizeof (node_bytes));
+          memset (node_objects, 0, sizeof (node_objects));
+          // object buffers per node, index 0 for buffers without placement
+          if ( kogmo_rtdb_obj_searchinfo_begin (dbc, &search, "", 0, 0, 0, 0/*ts*/, 0) >= 0 )
+            {
+              while ( ( n = kogmo_rtdb_obj_searchinfo_next (dbc, &search, objlist,
+                              sizeof(objlist)/sizeof(objlist[0])) ) > 0 )
+                for (i=0; i<n; i++ )
+                  {
+                    if ( kogmo_rtdb_obj_readinfo (dbc, objlist[i], 0/*ts*/, &om) < 0 || om.size_max == 0 )
+                      continue;
+                    j = om.flags.numa_node <= KOGMO_RTDB_NUMA_NODES_MAX ? om.flags.numa_node : 0;
+                    node_objects[j]++;
+                    node_bytes[j] += KOGMO_RTDB_OBJ_BUFFER_SIZE (&om);
+                  }
+              kogmo_rtdb_obj_searchinfo_end (dbc, &search);
+            }
+          for (j=1; j <= KOGMO_RTDB_NUMA_NODES_MAX; j++)
+            if ( node_objects[j] )
+              printf("*  node %d:        %d object buffers, %lli MB\n", j-1, node_objects[j], node_bytes[j]/1024/1024);
+          if ( node_objects[0] )
+            printf("*  not placed:    %d object buffers, %lli MB\n", node_objects[0], node_bytes[0]/1024/1024);
+        }
       printf("\n");
     }
 
@@ -432,12 +467,13 @@ void dump_recursive (kogmo_rtdb_handle_t *db_h,
                      int generation, kogmo_rtdb_objid_list_t olist)
 {
   kogmo_rtdb_obj_info_t om;
-  kogmo_rtdb_objid_t oid;
   kogmo_rtdb_obj_c3_process_info_t pi;
   kogmo_rtdb_obj_base_t ob;
   kogmo_timestamp_string_t tstring;
   kogmo_rtdb_objsize_t olen;
-  int ret,i;
+  kogmo_rtdb_obj_search_t search;
+  kogmo_rtdb_objid_t childlist[16];
+  int ret,i,n;
 
   ret = kogmo_rtdb_obj_readinfo ( db_h, parentoid, ts, &om );
   if ( ret < 0 )
@@ -481,10 +517,16 @@ void dump_recursive (kogmo_rtdb_handle_t *db_h,
         }
     }
 
-  i=0;
-  while( ( oid = kogmo_rtdb_obj_searchinfo ( db_h, "", 0, parentoid, 0, ts,
-                                             NULL, ++i ) ) > 0 )
-    {
-      dump_recursive (db_h, oid, ts, generation + 1, olist);
-    }
+  // walk the children with a cursor, it uses the parent index and
+  // has no limit on the number of children
+  ret = kogmo_rtdb_obj_searchinfo_begin ( db_h, &search, "", 0, parentoid, 0, ts, 0 );
+  if ( ret < 0 )
+    return;
+  while ( ( n = kogmo_rtdb_obj_searchinfo_next ( db_h, &search, childlist,
+                  sizeof(childlist)/sizeof(childlist[0]) ) ) > 0 )
+    for (i=0; i<n; i++)
+      {
+        dump_recursive (db_h, childlist[i], ts, generation + 1, olist);
+      }
+  kogmo_rtdb_obj_searchinfo_end ( db_h, &search );
 }
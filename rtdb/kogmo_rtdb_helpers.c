@@ -13,11 +13,51 @@
  */
 
 #include "kogmo_rtdb_internal.h"
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+# define KOGMO_RTDB_COPY_X86
+# include <immintrin.h>
+#endif
 
  /* ******************** OBJECT MANAGEMENT HELPERS ******************** */
 
+/*! \brief Find the Hot Metadata of an Object by its Object-ID.
+ * For internal use only.
+ * \returns Pointer to its Hot Metadata or NULL if not found.
+ */
+// No LOCKs in this function!
+
+struct kogmo_rtdb_obj_hot_t *
+kogmo_rtdb_obj_findhot_byid (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objid_t oid )
+{
+  uint32_t i, maxprobe;
+  int32_t entry;
+  volatile int32_t *index = db_h->objmeta_index;
+  struct kogmo_rtdb_obj_hot_t *scan_objhot_p;
+
+  if ( oid <= 0 )
+    return NULL;
+
+  // here: hash lookup, the oids are sequential, so (oid & mask) is a good hash.
+  // concurrent inserts/purges can only hide the object that is currently
+  // inserted or purged, a found slot is always verified by its oid
+  maxprobe = *(volatile uint32_t *) &db_h->localdata_p->objmeta_index_maxprobe;
+  for ( i = 0; i <= maxprobe && i < db_h->obj_index_size; i++ )
+    {
+      entry = index[ ( oid + i ) & ( db_h->obj_index_size - 1 ) ];
+      if ( entry <= 0 || entry > (int32_t) db_h->obj_max )
+        continue;
+      scan_objhot_p = &db_h->objhot[entry-1];
+      if ( *(volatile kogmo_rtdb_objid_t *) &scan_objhot_p->oid == oid )
+        return scan_objhot_p;
+    }
+
+  return NULL;
+}
+
 /*! \brief Find an Object by its Object-ID.
  * For internal use only.
+ * Note: history_slot in the returned Metadata is not maintained,
+ * use the hot table (kogmo_rtdb_obj_findhot_byid()) for it.
  * \returns Pointer to its Metadata or NULL if not found.
  */
 // No LOCKs in this function!
@@ -25,21 +65,375 @@
 kogmo_rtdb_obj_info_t *
 kogmo_rtdb_obj_findmeta_byid (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objid_t oid )
 {
-  int i=-1;
-  kogmo_rtdb_obj_info_t *scan_objmeta_p;
+  struct kogmo_rtdb_obj_hot_t *objhot_p;
+  objhot_p = kogmo_rtdb_obj_findhot_byid (db_h, oid);
+  if ( objhot_p == NULL )
+    return NULL;
+  return &db_h->objmeta[ kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p) ];
+}
+
+/*! \brief Copy the Metadata of a Slot into its Hot Metadata.
+ * For internal use only.
+ * Must be called with objmeta_lock held and while the oid of the slot is
+ * still 0, the oid is published afterwards by the caller.
+ */
+void
+kogmo_rtdb_obj_hot_fill (kogmo_rtdb_handle_t *db_h, int slot)
+{
+  struct kogmo_rtdb_obj_hot_t *objhot_p = &db_h->objhot[slot];
+  kogmo_rtdb_obj_info_t *objmeta_p = &db_h->objmeta[slot];
+
+  objhot_p->oid = objmeta_p->oid;
+  objhot_p->created_ts = objmeta_p->created_ts;
+  objhot_p->deleted_ts = objmeta_p->deleted_ts;
+  objhot_p->otype = objmeta_p->otype;
+  objhot_p->parent_oid = objmeta_p->parent_oid;
+  objhot_p->created_proc = objmeta_p->created_proc;
+  objhot_p->size_max = objmeta_p->size_max;
+  objhot_p->slot_stride = KOGMO_RTDB_OBJ_SLOT_STRIDE (objmeta_p->size_max);
+  objhot_p->history_size = objmeta_p->history_size;
+  objhot_p->history_slot = objmeta_p->history_slot;
+  objhot_p->buffer_idx = objmeta_p->buffer_idx;
+  objhot_p->history_interval = objmeta_p->history_interval;
+  objhot_p->min_cycletime = objmeta_p->min_cycletime;
+  objhot_p->max_cycletime = objmeta_p->max_cycletime;
+  objhot_p->flags = objmeta_p->flags;
+}
+
+// insert slot into a chain after the slot "after" or as its new head if
+// after<0, prev[] of the head points to the tail
+static void
+chain_insert_after (int32_t *head_p, int32_t *next, int32_t *prev, int after, int slot)
+{
+  int head = *head_p - 1;
+  if ( head < 0 )
+    {
+      next[slot] = 0;
+      prev[slot] = slot + 1;
+      *head_p = slot + 1;
+      return;
+    }
+  if ( after < 0 )
+    {
+      next[slot] = head + 1;
+      prev[slot] = prev[head];
+      prev[head] = slot + 1;
+      *head_p = slot + 1;
+      return;
+    }
+  next[slot] = next[after];
+  prev[slot] = after + 1;
+  if ( next[after] )
+    prev[next[after] - 1] = slot + 1;
+  else
+    prev[head] = slot + 1; // new tail
+  next[after] = slot + 1;
+}
+
+// append slot to a chain
+static void
+chain_insert (int32_t *head_p, int32_t *next, int32_t *prev, int slot)
+{
+  int head = *head_p - 1;
+  chain_insert_after (head_p, next, prev, head < 0 ? -1 : prev[head] - 1, slot);
+}
+
+// insert slot into a chain ordered by oid. new objects have the highest oid,
+// so this only walks the chain for objects that are re-indexed.
+// the order allows searchinfo cursors to resume behind a removed slot.
+static void
+chain_insert_byoid (kogmo_rtdb_handle_t *db_h,
+                    int32_t *head_p, int32_t *next, int32_t *prev, int slot)
+{
+  int head = *head_p - 1;
+  int after = head < 0 ? -1 : prev[head] - 1;
+  while ( after >= 0 && db_h->objmeta[after].oid > db_h->objmeta[slot].oid )
+    after = after == head ? -1 : prev[after] - 1;
+  chain_insert_after (head_p, next, prev, after, slot);
+}
 
-  // here: linear search.
-  // we could think about indexing if reasonable and KOGMO_RTDB_OBJ_MAX is high
-  do
+// remove slot from a chain, slots that are not in a chain have prev[] 0
+static void
+chain_remove (int32_t *head_p, int32_t *next, int32_t *prev, int slot)
+{
+  int head = *head_p - 1;
+  int follower = next[slot] - 1;
+  if ( prev[slot] == 0 || head < 0 )
+    return;
+  if ( slot == head )
+    {
+      if ( follower >= 0 )
+        prev[follower] = prev[head];
+      *head_p = next[slot];
+    }
+  else
     {
-      if ( ++i >= KOGMO_RTDB_OBJ_MAX )
+      next[prev[slot] - 1] = next[slot];
+      if ( follower >= 0 )
+        prev[follower] = prev[slot];
+      else
+        prev[head] = prev[slot];
+    }
+  next[slot] = prev[slot] = 0;
+}
+
+/*! \brief Take a Slot from the List of free Slots.
+ * For internal use only.
+ * Must be called with objmeta_lock held.
+ * \returns the Slot-Number or -1 if there is no free slot
+ */
+int
+kogmo_rtdb_obj_freeslot_get (kogmo_rtdb_handle_t *db_h)
+{
+  int slot = db_h->localdata_p->objmeta_free_head - 1;
+  if ( slot < 0 )
+    return -1;
+  db_h->localdata_p->objmeta_free_head = db_h->objmeta_free_next[slot];
+  db_h->objmeta_free_next[slot] = 0;
+  db_h->localdata_p->objmeta_free--;
+  return slot;
+}
+
+/*! \brief Return a Slot to the List of free Slots.
+ * For internal use only.
+ * Must be called with objmeta_lock held, after the oid of the slot has been cleared.
+ */
+void
+kogmo_rtdb_obj_freeslot_put (kogmo_rtdb_handle_t *db_h, int slot)
+{
+  db_h->objmeta_free_next[slot] = db_h->localdata_p->objmeta_free_head;
+  db_h->localdata_p->objmeta_free_head = slot + 1;
+  db_h->localdata_p->objmeta_free++;
+}
+
+/*! \brief Add a deleted Keep-Alloc Slot to the List of reusable Slots of its Process.
+ * For internal use only.
+ * Must be called with objmeta_lock held.
+ */
+void
+kogmo_rtdb_obj_keepalloc_add (kogmo_rtdb_handle_t *db_h, int slot)
+{
+  struct kogmo_rtdb_obj_hot_t *objhot_p = &db_h->objhot[slot];
+  chain_insert (&db_h->localdata_p->objmeta_keepalloc_hash[kogmo_rtdb_obj_hash_keepalloc (
+                  objhot_p->created_proc, KOGMO_RTDB_OBJ_BUFFER_SIZE (objhot_p))],
+                db_h->objmeta_free_next, db_h->objmeta_free_prev, slot);
+}
+
+/*! \brief Remove a Keep-Alloc Slot from the List of reusable Slots.
+ * For internal use only.
+ * Must be called with objmeta_lock held and before the slot is reused or purged.
+ */
+void
+kogmo_rtdb_obj_keepalloc_remove (kogmo_rtdb_handle_t *db_h, int slot)
+{
+  struct kogmo_rtdb_obj_hot_t *objhot_p = &db_h->objhot[slot];
+  chain_remove (&db_h->localdata_p->objmeta_keepalloc_hash[kogmo_rtdb_obj_hash_keepalloc (
+                  objhot_p->created_proc, KOGMO_RTDB_OBJ_BUFFER_SIZE (objhot_p))],
+                db_h->objmeta_free_next, db_h->objmeta_free_prev, slot);
+}
+
+/*! \brief Add a Slot to the Search-Indices (name, type, parent).
+ * For internal use only.
+ * Must be called with objmeta_lock held and the oid set in its metadata.
+ */
+void
+kogmo_rtdb_obj_searchindex_add (kogmo_rtdb_handle_t *db_h, int slot)
+{
+  struct kogmo_rtdb_obj_local_t *l = db_h->localdata_p;
+  chain_insert_byoid (db_h, &l->objmeta_name_hash[kogmo_rtdb_obj_hash_name (db_h->objmeta[slot].name)],
+                      db_h->objmeta_name_next, db_h->objmeta_name_prev, slot);
+  chain_insert_byoid (db_h, &l->objmeta_type_hash[kogmo_rtdb_obj_hash_type (db_h->objmeta[slot].otype)],
+                      db_h->objmeta_type_next, db_h->objmeta_type_prev, slot);
+  chain_insert_byoid (db_h, &l->objmeta_parent_hash[kogmo_rtdb_obj_hash_parent (db_h->objmeta[slot].parent_oid)],
+                      db_h->objmeta_parent_next, db_h->objmeta_parent_prev, slot);
+}
+
+/*! \brief Remove a Slot from the Search-Indices (name, type, parent).
+ * For internal use only.
+ * Must be called with objmeta_lock held and before name, type or parent
+ * of the slot are changed.
+ */
+void
+kogmo_rtdb_obj_searchindex_remove (kogmo_rtdb_handle_t *db_h, int slot)
+{
+  struct kogmo_rtdb_obj_local_t *l = db_h->localdata_p;
+  chain_remove (&l->objmeta_name_hash[kogmo_rtdb_obj_hash_name (db_h->objmeta[slot].name)],
+                db_h->objmeta_name_next, db_h->objmeta_name_prev, slot);
+  chain_remove (&l->objmeta_type_hash[kogmo_rtdb_obj_hash_type (db_h->objmeta[slot].otype)],
+                db_h->objmeta_type_next, db_h->objmeta_type_prev, slot);
+  chain_remove (&l->objmeta_parent_hash[kogmo_rtdb_obj_hash_parent (db_h->objmeta[slot].parent_oid)],
+                db_h->objmeta_parent_next, db_h->objmeta_parent_prev, slot);
+}
+
+/*! \brief Add an Object to the Object-Indices (oid, name, type, parent).
+ * For internal use only.
+ * Must be called with objmeta_lock held, after the metadata including its
+ * oid has been copied into the slot and before the oid is set in its hot
+ * metadata.
+ */
+void
+kogmo_rtdb_obj_index_add (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objid_t oid,
+                          int slot)
+{
+  uint32_t i;
+  volatile int32_t *entry_p;
+
+  kogmo_rtdb_obj_searchindex_add (db_h, slot);
+
+  for ( i = 0; i < db_h->obj_index_size; i++ )
+    {
+      entry_p = &db_h->objmeta_index[ ( oid + i ) & ( db_h->obj_index_size - 1 ) ];
+      if ( *entry_p != 0 )
+        continue;
+      // raise the limit first, so that readers won't stop probing too early
+      if ( i > db_h->localdata_p->objmeta_index_maxprobe )
+        *(volatile uint32_t *) &db_h->localdata_p->objmeta_index_maxprobe = i;
+      *entry_p = slot + 1;
+      return;
+    }
+  // cannot happen, as there are more index entries than slots
+  ERR("object index full, cannot add oid %lli", (long long int) oid);
+}
+
+/*! \brief Remove an Object from the Object-Indices (oid, name, type, parent).
+ * For internal use only.
+ * Must be called with objmeta_lock held and while the oid, name, type and
+ * parent are still set in its slot.
+ */
+void
+kogmo_rtdb_obj_index_remove (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objid_t oid,
+                             int slot)
+{
+  uint32_t i;
+  volatile int32_t *entry_p;
+
+  kogmo_rtdb_obj_searchindex_remove (db_h, slot);
+
+  for ( i = 0; i <= db_h->localdata_p->objmeta_index_maxprobe
+               && i < db_h->obj_index_size; i++ )
+    {
+      entry_p = &db_h->objmeta_index[ ( oid + i ) & ( db_h->obj_index_size - 1 ) ];
+      if ( *entry_p == slot + 1 )
         {
-          return NULL;
+          *entry_p = 0;
+          return;
         }
-      scan_objmeta_p = &db_h->localdata_p->objmeta[i];
     }
-  while ( scan_objmeta_p->oid != oid );
+  DBGL (DBGL_DB,"oid %lli in slot %d not found in object index",
+        (long long int) oid, slot);
+}
 
-  return scan_objmeta_p;
+
+
+ /* ******************** DATA COPY HELPERS ******************** */
+
+// The writer does not read a committed slot again and large data blocks
+// (images, scans) do not fit into the caches anyway, so copying them with
+// non-temporal stores saves the reads of the destination lines and does not
+// evict the working set of the process. The final sfence orders the
+// stores before the commit timestamp that makes the data valid.
+
+#ifdef KOGMO_RTDB_COPY_X86
+
+// internal: copy with 16 byte non-temporal stores
+__attribute__((target("sse2")))
+static void *
+kogmo_rtdb_copy_sse2 (void *dest, const void *src, size_t n)
+{
+  char *d = (char *) dest;
+  const char *s = (const char *) src;
+  size_t head = ( 16 - ( (uintptr_t) d & 15 ) ) & 15;
+
+  if ( head > n )
+    head = n;
+  memcpy (d, s, head);
+  d += head; s += head; n -= head;
+
+  for ( ; n >= 64; n -= 64, d += 64, s += 64 )
+    {
+      __m128i a = _mm_loadu_si128 ((const __m128i *) (s +  0));
+      __m128i b = _mm_loadu_si128 ((const __m128i *) (s + 16));
+      __m128i c = _mm_loadu_si128 ((const __m128i *) (s + 32));
+      __m128i e = _mm_loadu_si128 ((const __m128i *) (s + 48));
+      _mm_stream_si128 ((__m128i *) (d +  0), a);
+      _mm_stream_si128 ((__m128i *) (d + 16), b);
+      _mm_stream_si128 ((__m128i *) (d + 32), c);
+      _mm_stream_si128 ((__m128i *) (d + 48), e);
+    }
+  _mm_sfence ();
+
+  memcpy (d, s, n);
+  return dest;
 }
 
+// internal: copy with 32 byte non-temporal stores
+__attribute__((target("avx2")))
+static void *
+kogmo_rtdb_copy_avx2 (void *dest, const void *src, size_t n)
+{
+  char *d = (char *) dest;
+  const char *s = (const char *) src;
+  size_t head = ( 32 - ( (uintptr_t) d & 31 ) ) & 31;
+
+  if ( head > n )
+    head = n;
+  memcpy (d, s, head);
+  d += head; s += head; n -= head;
+
+  for ( ; n >= 128; n -= 128, d += 128, s += 128 )
+    {
+      __m256i a = _mm256_loadu_si256 ((const __m256i *) (s +  0));
+      __m256i b = _mm256_loadu_si256 ((const __m256i *) (s + 32));
+      __m256i c = _mm256_loadu_si256 ((const __m256i *) (s + 64));
+      __m256i e = _mm256_loadu_si256 ((const __m256i *) (s + 96));
+      _mm256_stream_si256 ((__m256i *) (d +  0), a);
+      _mm256_stream_si256 ((__m256i *) (d + 32), b);
+      _mm256_stream_si256 ((__m256i *) (d + 64), c);
+      _mm256_stream_si256 ((__m256i *) (d + 96), e);
+    }
+  _mm_sfence ();
+
+  memcpy (d, s, n);
+  return dest;
+}
+
+#endif /* KOGMO_RTDB_COPY_X86 */
+
+/*! \brief Select the Copy Function for large Data Blocks by the Features
+ * of the CPU. Called once at connect.
+ * For internal use only.
+ */
+void
+kogmo_rtdb_copy_init (kogmo_rtdb_handle_t *db_h)
+{
+  long int cache_size = 0;
+
+  db_h->copy_large = NULL;
+  // smaller blocks are likely to be read again from the cache
+#ifdef _SC_LEVEL3_CACHE_SIZE
+  cache_size = sysconf (_SC_LEVEL3_CACHE_SIZE);
+  if ( cache_size <= 0 )
+    cache_size = sysconf (_SC_LEVEL2_CACHE_SIZE);
+#endif
+  db_h->copy_threshold = cache_size / 2 > KOGMO_RTDB_COPY_THRESHOLD_MIN ?
+                         cache_size / 2 : KOGMO_RTDB_COPY_THRESHOLD_MIN;
+  if ( getenv ("KOGMO_RTDB_COPY_THRESHOLD") )
+    db_h->copy_threshold = strtol ( getenv ("KOGMO_RTDB_COPY_THRESHOLD"), NULL, 0);
+  if ( db_h->copy_threshold == 0 )
+    return;
+
+#ifdef KOGMO_RTDB_COPY_X86
+  __builtin_cpu_init ();
+  if ( __builtin_cpu_supports ("avx2") )
+    db_h->copy_large = kogmo_rtdb_copy_avx2;
+  else if ( __builtin_cpu_supports ("sse2") )
+    db_h->copy_large = kogmo_rtdb_copy_sse2;
+#endif
+
+  DBGL (DBGL_DB,"copy: non-temporal copy %s from %lli bytes on",
+        db_h->copy_large == NULL ? "not available" :
+#ifdef KOGMO_RTDB_COPY_X86
+        db_h->copy_large == kogmo_rtdb_copy_avx2 ? "avx2" :
+#endif
+        "sse2", (long long int) db_h->copy_threshold);
+}
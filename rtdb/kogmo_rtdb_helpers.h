@@ -29,6 +29,16 @@
 //DEBUG: #define _COPY_INT64(dest,src,word) do { ( (int*) ((void*)&(dest)) )[word] = ( (int*) ((void*)&(src)) )[word]; printf("%lli %i %i\n",dest,(int)(dest>>32)&0xFFFFFFFF,(int)(dest&0xFF
 #define _CMP_INT64(dest,src,word) ( (int*) ((void*)&(dest)) )[word] == ( (int*) ((void*)&(src)) )[word]
 
+// keep the compiler from moving memory accesses across this point
+#define COMPILER_BARRIER() __asm__ __volatile__ ("" : : : "memory")
+
+// tell the cpu that we are busy waiting (saves power and the sibling hyperthread)
+#if defined(__i386__) || defined(__x86_64__)
+#define CPU_RELAX() __asm__ __volatile__ ("pause" : : : "memory")
+#else
+#define CPU_RELAX() COMPILER_BARRIER()
+#endif
+
 #if __BYTE_ORDER == __LITTLE_ENDIAN
 #define COPY_INT64_HIGHFIRST(dest,src) do { _COPY_INT64(dest,src,1); _COPY_INT64(dest,src,0); } while (0)
 #define COPY_INT64_LOWFIRST(dest,src)  do { _COPY_INT64(dest,src,0); _COPY_INT64(dest,src,1); } while (0)
@@ -44,6 +54,72 @@
 
 kogmo_rtdb_obj_info_t *
 kogmo_rtdb_obj_findmeta_byid (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objid_t oid );
+struct kogmo_rtdb_obj_hot_t *
+kogmo_rtdb_obj_findhot_byid (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objid_t oid );
+void
+kogmo_rtdb_obj_hot_fill (kogmo_rtdb_handle_t *db_h, int slot);
+
+// hash functions for the name, type and parent indices
+inline static uint32_t
+kogmo_rtdb_obj_hash_name (_const char *name)
+{
+  uint32_t hash = 2166136261U; // FNV-1a
+  int i;
+  for ( i = 0; i < KOGMO_RTDB_OBJMETA_NAME_MAXLEN && name[i] != '\0'; i++ )
+    hash = ( hash ^ (unsigned char) name[i] ) * 16777619U;
+  return hash & ( KOGMO_RTDB_OBJ_HASH_SIZE - 1 );
+}
+
+inline static uint32_t
+kogmo_rtdb_obj_hash_type (kogmo_rtdb_objtype_t otype)
+{
+  return ( (uint32_t) otype ^ ( (uint32_t) otype >> 12 ) ) & ( KOGMO_RTDB_OBJ_HASH_SIZE - 1 );
+}
+
+inline static uint32_t
+kogmo_rtdb_obj_hash_parent (kogmo_rtdb_objid_t parent_oid)
+{
+  return (uint32_t) parent_oid & ( KOGMO_RTDB_OBJ_HASH_SIZE - 1 ); // oids are sequential
+}
+
+inline static uint32_t
+kogmo_rtdb_obj_hash_keepalloc (kogmo_rtdb_objid_t proc_oid, uint32_t total_size)
+{
+  return ( (uint32_t) proc_oid * 2654435761U ^ total_size ^ ( total_size >> 12 ) )
+         & ( KOGMO_RTDB_OBJ_HASH_SIZE - 1 );
+}
+
+void
+kogmo_rtdb_copy_init (kogmo_rtdb_handle_t *db_h);
+
+// copy object data, large blocks bypass the caches
+inline static void
+kogmo_rtdb_copy (kogmo_rtdb_handle_t *db_h, void *dest, const void *src, size_t n)
+{
+  if ( db_h->copy_large != NULL && n >= db_h->copy_threshold )
+    db_h->copy_large (dest, src, n);
+  else
+    memcpy (dest, src, n);
+}
+
+int
+kogmo_rtdb_obj_freeslot_get (kogmo_rtdb_handle_t *db_h);
+void
+kogmo_rtdb_obj_freeslot_put (kogmo_rtdb_handle_t *db_h, int slot);
+void
+kogmo_rtdb_obj_keepalloc_add (kogmo_rtdb_handle_t *db_h, int slot);
+void
+kogmo_rtdb_obj_keepalloc_remove (kogmo_rtdb_handle_t *db_h, int slot);
+void
+kogmo_rtdb_obj_searchindex_add (kogmo_rtdb_handle_t *db_h, int slot);
+void
+kogmo_rtdb_obj_searchindex_remove (kogmo_rtdb_handle_t *db_h, int slot);
+void
+kogmo_rtdb_obj_index_add (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objid_t oid,
+                          int slot);
+void
+kogmo_rtdb_obj_index_remove (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objid_t oid,
+                             int slot);
 
 inline static int
 this_process_is_manager(kogmo_rtdb_handle_t *db_h)
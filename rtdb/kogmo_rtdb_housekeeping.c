@@ -18,7 +18,7 @@ int
 kogmo_rtdb_objmeta_purge_objs (kogmo_rtdb_handle_t *db_h)
 {
   int i;
-  kogmo_rtdb_obj_info_t *scan_objmeta_p;
+  struct kogmo_rtdb_obj_hot_t *scan_objhot_p;
   kogmo_rtdb_objid_t scan_oid;
   kogmo_timestamp_t ts,scan_delete_ts;
   int purge_keep_alloc = 0;
@@ -41,20 +41,20 @@ kogmo_rtdb_objmeta_purge_objs (kogmo_rtdb_handle_t *db_h)
   ts = kogmo_rtdb_timestamp_now(db_h);
 
   kogmo_rtdb_objmeta_lock(db_h);
-  for(i=0;i<KOGMO_RTDB_OBJ_MAX;i++)
+  for(i=0;i<(int)db_h->obj_max;i++)
     {
-      scan_objmeta_p = &db_h->localdata_p->objmeta[i];
-      scan_oid = scan_objmeta_p->oid;
-      scan_delete_ts = scan_objmeta_p->deleted_ts;
+      scan_objhot_p = &db_h->objhot[i];
+      scan_oid = scan_objhot_p->oid;
+      scan_delete_ts = scan_objhot_p->deleted_ts;
       if (scan_oid && scan_delete_ts)
         {
           scan_delete_ts = kogmo_timestamp_add_secs(
                scan_delete_ts,
-               scan_objmeta_p->history_interval > db_h->localdata_p->default_keep_deleted_interval ?
-               scan_objmeta_p->history_interval : db_h->localdata_p->default_keep_deleted_interval);
+               scan_objhot_p->history_interval > db_h->localdata_p->default_keep_deleted_interval ?
+               scan_objhot_p->history_interval : db_h->localdata_p->default_keep_deleted_interval);
           if ( scan_delete_ts < ts )
             {
-              if ( scan_objmeta_p->flags.keep_alloc &&
+              if ( scan_objhot_p->flags.keep_alloc &&
                    ( !purge_keep_alloc ||
                      kogmo_timestamp_diff_secs ( scan_delete_ts, ts ) < KOGMO_RTDB_PURGE_KEEPALLOC_MAXSECS) )
                 continue; // this is kept allocated and alloc-purce time is not reached or we do not purge
@@ -93,8 +93,9 @@ kogmo_rtdb_objmeta_purge_procs (kogmo_rtdb_handle_t *db_h)
           if ( err == -1 && errno == ESRCH )
             {
               kogmo_rtdb_obj_info_t used_objmeta;
-              kogmo_rtdb_objid_list_t objlist;
-              int j, immediately_delete;
+              kogmo_rtdb_obj_search_t search;
+              kogmo_rtdb_objid_t objlist[64];
+              int j, n, nobjs = 0, immediately_delete;
               kogmo_rtdb_objid_t err;
 
               immediately_delete = db_h->ipc_h.shm_p->proc[i].flags & KOGMO_RTDB_CONNECT_FLAGS_IMMEDIATELYDELETE;
@@ -104,17 +105,17 @@ kogmo_rtdb_objmeta_purge_procs (kogmo_rtdb_handle_t *db_h)
                       (long long int)db_h->ipc_h.shm_p->proc[i].proc_oid,
                       db_h->ipc_h.shm_p->proc[i].pid);
 
-              err = kogmo_rtdb_obj_searchinfo_deleted (db_h, "", 0, 0,
-                        db_h->ipc_h.shm_p->proc[i].proc_oid, 0, objlist, 0);
+              err = kogmo_rtdb_obj_searchinfo_begin (db_h, &search, "", 0, 0,
+                        db_h->ipc_h.shm_p->proc[i].proc_oid, 0, KOGMO_RTDB_SEARCH_FLAGS_DELETED);
               if (err < 0 )
                 {
                   DBGL(DBGL_APP,"search for objectlist failed: %d",err);
                 }
               else
                 {
-                  DBGL(DBGL_APP,"dead process has %i objects to%s delete",err,
-                       immediately_delete ? " immediately":"");
-                  for (j=0; objlist[j] != 0; j++ )
+                  while ( ( n = kogmo_rtdb_obj_searchinfo_next (db_h, &search, objlist,
+                                  sizeof(objlist)/sizeof(objlist[0])) ) > 0 )
+                    for (j=0; j<n; j++, nobjs++ )
                     {
                       err = kogmo_rtdb_obj_readinfo (db_h, objlist[j], 0, &used_objmeta );
                       if ( err >= 0 && used_objmeta.flags.persistent )
@@ -128,6 +129,9 @@ kogmo_rtdb_objmeta_purge_procs (kogmo_rtdb_handle_t *db_h)
                          }
                         kogmo_rtdb_obj_delete_imm(db_h, &used_objmeta, immediately_delete);
                     }
+                  kogmo_rtdb_obj_searchinfo_end (db_h, &search);
+                  DBGL(DBGL_APP,"dead process had %i objects to%s delete",nobjs,
+                       immediately_delete ? " immediately":"");
                 }
 
               kogmo_rtdb_ipc_mutex_lock (&db_h->ipc_h.shm_p->proc_lock);
@@ -14,6 +14,14 @@
  */
 
 #include "kogmo_rtdb_internal.h"
+#if !defined(MACOSX) && !defined(KOGMO_RTDB_HARDREALTIME)
+#include <sys/vfs.h> /* fstatfs */
+#endif
+#ifdef KOGMO_RTDB_IPC_FUTEX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <limits.h>
+#endif
 
 #ifdef KOGMO_RTDB_IPC_DO_POLLING
 static int ipc_poll_mutex_usecs, ipc_poll_condvar_usecs;
@@ -58,6 +66,118 @@ roundup_pagesize (long long int sz, int extra_pages)
 }
 
 
+// internal: size of a transparent huge page, used for reporting only
+static long int
+kogmo_rtdb_ipc_thp_pagesize (void)
+{
+  long int size = 0;
+  FILE *f = fopen ("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "r");
+  if ( f != NULL )
+    {
+      if ( fscanf (f, "%li", &size) != 1 )
+        size = 0;
+      fclose (f);
+    }
+  return size > 0 ? size : 2*1024*1024;
+}
+
+
+// internal: create and map a separate segment with huge pages for the object data (manager only);
+// mode is "memfd" or the directory of a mounted hugetlbfs.
+// returns the file descriptor, sets data_p and data_mapsize and fills in path, pagesize and pagetype,
+// or -1 if not possible (the caller then falls back to the normal segment,
+// pagesize and pagetype are reset to normal pages)
+static int
+kogmo_rtdb_ipc_hugepages_create (struct kogmo_rtdb_ipc_handle_t *ipc_h,
+                                 const char *mode, long int data_size,
+                                 char *path, long int *pagesize, uint32_t *pagetype)
+{
+#if defined(MACOSX) || defined(KOGMO_RTDB_HARDREALTIME)
+  return -1;
+#else
+  int fd = -1, err;
+  struct statfs fs;
+
+  if ( strcmp (mode, "memfd") == 0 )
+    {
+#ifdef MFD_HUGETLB
+      fd = memfd_create (ipc_h->shmid+1, MFD_HUGETLB);
+      if ( fd == -1 )
+        {
+          ERR("creating huge page memfd failed: %s",strerror(errno));
+          return -1;
+        }
+      // other processes reopen it via the manager's file descriptor table,
+      // this needs ptrace access to the manager, so only the same user can connect
+      snprintf (path, KOGMO_RTDB_IPC_DATAPATH_MAXLEN, "/proc/%li/fd/%i", (long int) getpid(), fd);
+      *pagetype = KOGMO_RTDB_PAGETYPE_MEMFD;
+#else
+      ERR("memfd_create(MFD_HUGETLB) is not supported on this system");
+      return -1;
+#endif
+    }
+  else if ( mode[0] == '/' )
+    {
+      if ( snprintf (path, KOGMO_RTDB_IPC_DATAPATH_MAXLEN, "%s%s", mode, ipc_h->shmid)
+           >= KOGMO_RTDB_IPC_DATAPATH_MAXLEN )
+        {
+          ERR("hugetlbfs path '%s' too long",mode);
+          return -1;
+        }
+      unlink (path);
+      fd = open (path, O_RDWR|O_CREAT|O_TRUNC, S_IRWXU);
+      if ( fd == -1 )
+        {
+          ERR("creating huge page file '%s' failed: %s",path,strerror(errno));
+          return -1;
+        }
+      *pagetype = KOGMO_RTDB_PAGETYPE_HUGETLBFS;
+    }
+  else
+    return -1;
+
+  // the block size of a hugetlbfs is its huge page size
+  err = fstatfs (fd, &fs);
+  *pagesize = err == 0 ? fs.f_bsize : 0;
+  if ( *pagesize <= sysconf (_SC_PAGESIZE) )
+    {
+      ERR("'%s' is not backed by huge pages",mode);
+      goto fail;
+    }
+
+  ipc_h->data_mapsize = (data_size + *pagesize - 1) / *pagesize * *pagesize;
+  err = ftruncate (fd, ipc_h->data_mapsize);
+  if ( err == -1 )
+    {
+      ERR("setting huge page segment size failed: %s (not enough huge pages reserved?)",strerror(errno));
+      goto fail;
+    }
+
+  // the huge pages are reserved by the first mapping, not by ftruncate()
+  ipc_h->data_p = mmap (NULL, ipc_h->data_mapsize, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+  if ( ipc_h->data_p == MAP_FAILED )
+    {
+      ipc_h->data_p = NULL;
+      ERR("mapping huge page segment failed: %s (not enough huge pages reserved?)",strerror(errno));
+      goto fail;
+    }
+
+  DBGL(DBGL_IPC,"object data in huge page segment %s with %li kB pages", path, *pagesize/1024);
+  return fd;
+
+ fail:
+  close (fd);
+  if ( *pagetype == KOGMO_RTDB_PAGETYPE_HUGETLBFS )
+    unlink (path);
+  path[0] = '\0';
+  ipc_h->data_mapsize = 0;
+  *pagetype = KOGMO_RTDB_PAGETYPE_NORMAL;
+  *pagesize = sysconf (_SC_PAGESIZE);
+  return -1;
+#endif
+}
+
+
 kogmo_rtdb_objid_t
 kogmo_rtdb_ipc_connect (struct kogmo_rtdb_ipc_handle_t *ipc_h,
                         char *dbhost,
@@ -68,6 +188,10 @@ kogmo_rtdb_ipc_connect (struct kogmo_rtdb_ipc_handle_t *ipc_h,
   int err;
   int i;
   int is_manager=0,no_handlers=0,is_spectator,be_silent,is_realtime;
+  char data_path[KOGMO_RTDB_IPC_DATAPATH_MAXLEN];
+  long int data_pagesize = sysconf (_SC_PAGESIZE);
+  uint32_t data_pagetype = KOGMO_RTDB_PAGETYPE_NORMAL;
+  const char *hugepages;
 
   strncpy(ipc_h->shmid,KOGMO_RTDB_SHMID,KOGMO_RTDB_PROC_NAME_MAXLEN);
   if (dbhost!=NULL && dbhost[0]!='\0')
@@ -78,6 +202,9 @@ kogmo_rtdb_ipc_connect (struct kogmo_rtdb_ipc_handle_t *ipc_h,
 
   ipc_h->shmfd=-1;
   ipc_h->shm_p=NULL;
+  ipc_h->datafd=-1;
+  ipc_h->data_p=NULL;
+  data_path[0]='\0';
 
   if ( procname[0] == '\0' ) {
     if ( flags & KOGMO_RTDB_CONNECT_FLAGS_LIVEONERR )
@@ -197,7 +324,22 @@ kogmo_rtdb_ipc_connect (struct kogmo_rtdb_ipc_handle_t *ipc_h,
             DIE("kogmo_rtdb_connect: opening shared memory '%s' failed: %s",ipc_h->shmid,strerror(errno));
         }
 
-        ipc_h->shm_size = sizeof(struct kogmo_rtdb_ipc_shm_t) + *data_size;
+        // Object Data in a separate Huge Page Segment?
+        hugepages = getenv(KOGMO_RTDB_HUGEPAGES_ENV);
+        if ( hugepages != NULL && hugepages[0] != '\0' )
+          {
+            if ( strcmp (hugepages, "madvise") != 0 && strcmp (hugepages, "thp") != 0 )
+              {
+                ipc_h->datafd = kogmo_rtdb_ipc_hugepages_create (ipc_h, hugepages, *data_size,
+                                                                 data_path, &data_pagesize, &data_pagetype);
+                if ( ipc_h->datafd == -1 )
+                  ERR("cannot use huge pages '%s', falling back to madvise()",hugepages);
+              }
+            if ( ipc_h->datafd == -1 )
+              data_pagetype = KOGMO_RTDB_PAGETYPE_THP;
+          }
+
+        ipc_h->shm_size = sizeof(struct kogmo_rtdb_ipc_shm_t) + ( ipc_h->datafd == -1 ? *data_size : 0 );
         DBG("kogmo_rtdb_connect: new shared memory size: %lli",(long long int)ipc_h->shm_size);
         err=ftruncate(ipc_h->shmfd, roundup_pagesize(ipc_h->shm_size, 1 /*1 extra page against XENO size-bug*/ ));
         if( err == -1 )
@@ -301,13 +443,41 @@ kogmo_rtdb_ipc_connect (struct kogmo_rtdb_ipc_handle_t *ipc_h,
         }
 
       *data_size = ipc_h->shm_p->data_size;
+      data_pagesize = ipc_h->shm_p->data_pagesize;
+      data_pagetype = ipc_h->shm_p->data_pagetype;
+      strncpy(data_path,ipc_h->shm_p->data_path,sizeof(data_path));
+      data_path[sizeof(data_path)-1]='\0';
 
       err=munmap(ipc_h->shm_p,roundup_pagesize(ipc_h->shm_size,0));
       if( err != 0 )
         ERR("unmapping initial shared memory: %s",strerror(errno));
 
+      if ( data_path[0] != '\0' )
+        {
+          // Object Data lives in a separate Huge Page Segment
+          ipc_h->datafd = open(data_path,is_spectator?O_RDONLY:O_RDWR);
+          if( ipc_h->datafd == -1 && ( errno == EACCES || errno == EPERM )
+              && data_pagetype == KOGMO_RTDB_PAGETYPE_MEMFD )
+            {
+              // the memfd can only be reopened by processes that may ptrace the manager
+              if ( ipc_h->this_process.flags & KOGMO_RTDB_CONNECT_FLAGS_LIVEONERR )
+                return ( -KOGMO_RTDB_ERR_NOPERM );
+              else
+                DIE("kogmo_rtdb_connect: the huge page memfd of the manager can only be opened "
+                    "by its own user, start the manager with a hugetlbfs directory "
+                    "(e.g. -L /dev/hugepages) to allow other users");
+            }
+          if( ipc_h->datafd == -1 )
+            {
+              if ( ipc_h->this_process.flags & KOGMO_RTDB_CONNECT_FLAGS_LIVEONERR )
+                return ( -KOGMO_RTDB_ERR_UNKNOWN );
+              else
+                DIE("kogmo_rtdb_connect: opening huge page segment '%s' failed: %s",data_path,strerror(errno));
+            }
+        }
+
       // ready for re-map with correct size
-      ipc_h->shm_size = sizeof(struct kogmo_rtdb_ipc_shm_t) + *data_size;
+      ipc_h->shm_size = sizeof(struct kogmo_rtdb_ipc_shm_t) + ( ipc_h->datafd == -1 ? *data_size : 0 );
     }
 
 
@@ -320,9 +490,44 @@ kogmo_rtdb_ipc_connect (struct kogmo_rtdb_ipc_handle_t *ipc_h,
         DIE("kogmo_rtdb_connect: mapping shared memory failed: %s",strerror(errno));
     }
 
-  DBGL(DBGL_IPC+DBGL_VERBOSE, "kogmo_rtdb_connect: localdata has %li bytes at %p", *data_size,ipc_h->shm_p);
+  if ( ipc_h->datafd != -1 && ipc_h->data_p == NULL ) // the manager has already mapped it
+    {
+      ipc_h->data_mapsize = (*data_size + data_pagesize - 1) / data_pagesize * data_pagesize;
+      ipc_h->data_p=mmap(NULL,ipc_h->data_mapsize, is_spectator?PROT_READ:PROT_READ|PROT_WRITE, MAP_SHARED, ipc_h->datafd, 0);
+      if( ipc_h->data_p == MAP_FAILED)
+        {
+          ipc_h->data_p = NULL;
+          if ( ipc_h->this_process.flags & KOGMO_RTDB_CONNECT_FLAGS_LIVEONERR )
+            return ( -KOGMO_RTDB_ERR_UNKNOWN );
+          else
+            DIE("kogmo_rtdb_connect: mapping huge page segment failed: %s",strerror(errno));
+        }
+    }
+  else if ( ipc_h->datafd == -1 )
+    {
+      ipc_h->data_mapsize = 0;
+      ipc_h->data_p = (char*)ipc_h->shm_p + sizeof(struct kogmo_rtdb_ipc_shm_t);
+#ifdef MADV_HUGEPAGE
+      // every process has to ask for it, the flag belongs to its own mapping
+      if ( data_pagetype == KOGMO_RTDB_PAGETYPE_THP )
+        {
+          err = madvise(ipc_h->shm_p, roundup_pagesize(ipc_h->shm_size,0), MADV_HUGEPAGE);
+          if( err != 0 )
+            {
+              DBG("kogmo_rtdb_connect: madvise(MADV_HUGEPAGE) failed: %s",strerror(errno));
+              data_pagetype = KOGMO_RTDB_PAGETYPE_NORMAL;
+            }
+          else
+            data_pagesize = kogmo_rtdb_ipc_thp_pagesize ();
+        }
+#else
+      data_pagetype = KOGMO_RTDB_PAGETYPE_NORMAL;
+#endif
+    }
+
+  DBGL(DBGL_IPC+DBGL_VERBOSE, "kogmo_rtdb_connect: localdata has %li bytes at %p", *data_size,ipc_h->data_p);
 
-  *data_p = (char*)ipc_h->shm_p + sizeof(struct kogmo_rtdb_ipc_shm_t);
+  *data_p = ipc_h->data_p;
 
   if ( !is_manager )
     {
@@ -344,8 +549,16 @@ kogmo_rtdb_ipc_connect (struct kogmo_rtdb_ipc_handle_t *ipc_h,
 
   if(is_manager)
     {
-      memset(ipc_h->shm_p, 0, ipc_h->shm_size);
+      // the new segment is already zero; on NUMA systems the data pages are
+      // not touched here, so that object buffers land on the node of their writers
+      memset(ipc_h->shm_p, 0, kogmo_rtdb_numa_nodes () > 1 ?
+                              sizeof(struct kogmo_rtdb_ipc_shm_t) : ipc_h->shm_size);
+      if ( ipc_h->datafd != -1 )
+        memset(ipc_h->data_p, 0, *data_size); // also pre-faults the huge pages
       ipc_h->shm_p->data_size = *data_size;
+      ipc_h->shm_p->data_pagesize = data_pagesize;
+      ipc_h->shm_p->data_pagetype = data_pagetype;
+      strncpy(ipc_h->shm_p->data_path,data_path,sizeof(ipc_h->shm_p->data_path));
       ipc_h->shm_p->manager_pid = getpid();
       ipc_h->shm_p->manager_alive_ts = 0; // manager at initialization
       kogmo_rtdb_ipc_mutex_init (&ipc_h->shm_p->global_lock);
@@ -414,6 +627,13 @@ kogmo_rtdb_ipc_connect_enable (struct kogmo_rtdb_ipc_handle_t *ipc_h)
       else
         DIE("kogmo_rtdb_connect: setting shared memory permissions failed: %s",strerror(errno));
   }
+  // (a memfd has no path of its own, its permissions do not matter)
+  if ( ipc_h->datafd != -1 && ipc_h->shm_p->data_pagetype == KOGMO_RTDB_PAGETYPE_HUGETLBFS )
+    {
+      err= fchmod(ipc_h->datafd, S_IRWXU|S_IRWXG|S_IRWXO);
+      if (err==-1)
+        ERR("setting huge page segment permissions failed: %s",strerror(errno));
+    }
   return(0);
 }
 
@@ -471,6 +691,22 @@ kogmo_rtdb_ipc_disconnect (struct kogmo_rtdb_ipc_handle_t *ipc_h,
 
  // Remove Shared Memory
 
+ if(ipc_h->datafd != -1) {
+  if(is_manager && ipc_h->shm_p->data_pagetype == KOGMO_RTDB_PAGETYPE_HUGETLBFS) {
+   err=unlink(ipc_h->shm_p->data_path);
+   if( err != 0 )
+    ERR("unlinking huge page segment: %s",strerror(errno));
+  }
+  err=munmap(ipc_h->data_p,ipc_h->data_mapsize);
+  if( err != 0 )
+   ERR("unmapping huge page segment: %s",strerror(errno));
+  err=close(ipc_h->datafd);
+  if( err != 0 )
+   ERR("closing huge page segment failed: %s",strerror(errno));
+  ipc_h->datafd=-1;
+ }
+ ipc_h->data_p=NULL;
+
  err=munmap(ipc_h->shm_p,roundup_pagesize(ipc_h->shm_size,0));
  if( err != 0 )
   ERR("unmapping shared memory: %s",strerror(errno));
@@ -798,6 +1034,50 @@ kogmo_rtdb_ipc_condvar_signalall(pthread_cond_t *condvar)
 
 
 
+#ifdef KOGMO_RTDB_IPC_FUTEX
+
+/// Wait until *word is no longer val, wakeup_ts is absolute (0: no timeout)
+int
+kogmo_rtdb_ipc_futex_wait(volatile uint32_t *word, uint32_t val, kogmo_timestamp_t wakeup_ts)
+{
+  int err;
+  struct timespec ats;
+  ats.tv_nsec = ( wakeup_ts * KOGMO_TIMESTAMP_NANOSECONDSPERTICK ) % 1000000000;
+  ats.tv_sec  =   wakeup_ts / KOGMO_TIMESTAMP_TICKSPERSECOND;
+
+  DBGL(DBGL_IPC,"before futex_wait(%u,%lli)", val, (long long int)wakeup_ts);
+  // shared futex (the word is in shared memory), absolute timeout in CLOCK_REALTIME like the condvars
+  err = syscall (SYS_futex, word, FUTEX_WAIT_BITSET | FUTEX_CLOCK_REALTIME, val,
+                 wakeup_ts ? &ats : NULL, NULL, FUTEX_BITSET_MATCH_ANY);
+  DBGL(DBGL_IPC,"after futex_wait()");
+
+  if ( err == -1 && errno == ETIMEDOUT )
+    return -KOGMO_RTDB_ERR_TIMEOUT;
+
+  // EAGAIN: the word changed before we slept, EINTR: signal - both are normal wakeups
+  if ( err == -1 && errno != EAGAIN && errno != EINTR )
+    DIE("waiting on futex failed: %s(%i)",strerror(errno),errno);
+
+  return 0;
+}
+
+/// Wake up all waiters on word
+int
+kogmo_rtdb_ipc_futex_wake(volatile uint32_t *word)
+{
+  int err;
+  DBGL(DBGL_IPC,"before futex_wake()");
+  err = syscall (SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+  DBGL(DBGL_IPC,"after futex_wake()=%i",err);
+  if ( err == -1 )
+    DIE("waking up futex waiters failed: %s",strerror(errno));
+  return 0;
+}
+
+#endif /* KOGMO_RTDB_IPC_FUTEX */
+
+
+
 
 
 
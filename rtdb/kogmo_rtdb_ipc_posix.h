@@ -69,6 +69,9 @@ struct kogmo_rtdb_ipc_process_t {
 #define KOGMO_RTDB_PROC_MAX 100
 #endif
 
+//! maximum length of the path to a separate object data segment
+#define KOGMO_RTDB_IPC_DATAPATH_MAXLEN 128
+
 struct kogmo_rtdb_ipc_shm_t {
  uint32_t revision;
  // manager internals
@@ -83,17 +86,30 @@ struct kogmo_rtdb_ipc_shm_t {
  uint64_t proc_oid_next;
 
  long int data_size;
- // this struct is followed by the local object data in shared memory
+ long int data_pagesize; // page size backing the object data
+ uint32_t data_pagetype; // KOGMO_RTDB_PAGETYPE_*
+ char data_path[KOGMO_RTDB_IPC_DATAPATH_MAXLEN];
+   // if not empty, the object data lives in this separate file (hugetlbfs or memfd),
+   // otherwise this struct is followed by the local object data in shared memory
 };
 
 
 #define KOGMO_RTDB_SHMID "/kogmo_rtdb"
 
+//! environment variable to select huge pages for the object data (manager only):
+//! "madvise" (transparent huge pages), "memfd" (memfd_create with MFD_HUGETLB)
+//! or the directory of a mounted hugetlbfs, e.g. "/dev/hugepages";
+//! with "memfd" only processes of the manager's user can connect
+#define KOGMO_RTDB_HUGEPAGES_ENV "KOGMO_RTDB_HUGEPAGES"
+
 struct kogmo_rtdb_ipc_handle_t {
  int shmfd;
  char shmid[KOGMO_RTDB_PROC_NAME_MAXLEN];
  struct kogmo_rtdb_ipc_shm_t *shm_p;
  long int shm_size;
+ int datafd; // -1: object data follows shm_p in the same segment
+ char *data_p;
+ long int data_mapsize;
  struct kogmo_rtdb_ipc_process_t this_process;
  int this_process_slot; // so far only for notify-fix
  mqd_t tracefd;
@@ -135,6 +151,17 @@ int kogmo_rtdb_ipc_condvar_destroy(pthread_cond_t *condvar);
 int kogmo_rtdb_ipc_condvar_wait(pthread_cond_t *condvar, pthread_mutex_t *mutex, kogmo_timestamp_t wakeup_ts);
 int kogmo_rtdb_ipc_condvar_signalall(pthread_cond_t *condvar);
 
+// per-object change notifications with a futex word instead of a mutex+condvar pair
+#if defined(__linux__) && !defined(KOGMO_RTDB_HARDREALTIME) && !defined(KOGMO_RTDB_IPC_DO_POLLING)
+#define KOGMO_RTDB_IPC_FUTEX
+#endif
+#ifdef KOGMO_RTDB_IPC_FUTEX
+// the highest bit of a futex word flags waiters, the other bits count changes
+#define KOGMO_RTDB_IPC_FUTEX_WAITERS 0x80000000U
+int kogmo_rtdb_ipc_futex_wait(volatile uint32_t *word, uint32_t val, kogmo_timestamp_t wakeup_ts);
+int kogmo_rtdb_ipc_futex_wake(volatile uint32_t *word);
+#endif
+
 int kogmo_rtdb_ipc_mq_init(mqd_t *mqfd, char *name, int do_init, int size, int len);
 int kogmo_rtdb_ipc_mq_destroy(mqd_t mqfd, char *name, int do_destroy);
 int kogmo_rtdb_ipc_mq_send(mqd_t mqfd, void *msg, int size);
@@ -40,14 +40,22 @@ usage (void)
 #endif
 " -S SIZE   create database with the given size, defaults to %d bytes,\n"
 "           overrides the environment variable KOGMO_RTDB_HEAPSIZE\n"
+" -O NUM    create database with NUM object slots, defaults to %d,\n"
+"           overrides the environment variable KOGMO_RTDB_OBJMAX\n"
 " -H DBHOST create database with the given name, must begin with 'local:',\n"
 "           eg. 'local:bla'. defaults to '%s', overrides the \n"
 "           environment variable KOGMO_RTDB_DBHOST\n"
 //" -I INTERVAL[,MAXSIZE]  force minimum history interval\n"
 //"           (only for objects with a maximum size of MAXSIZE bytes.)\n"
+" -L MODE   back the object data with huge pages: 'madvise' (transparent\n"
+"           huge pages), 'memfd' or the directory of a mounted hugetlbfs,\n"
+"           eg. '/dev/hugepages'. overrides the environment variable\n"
+"           KOGMO_RTDB_HUGEPAGES. with 'memfd' only processes of the\n"
+"           same user can connect\n"
 " -k        kill old database (specified by -H or KOGMO_RTDB_DBHOST) and exit\n"
 " -h        print this help message\n\n",
 KOGMO_RTDB_DEFAULT_HEAP_SIZE,
+KOGMO_RTDB_OBJ_MAX,
 KOGMO_RTDB_DEFAULT_DBHOST);
   exit(1);
 }
@@ -74,7 +82,7 @@ int main(int argc, char *argv[]) {
 
  kogmo_rtdb_require_revision(KOGMO_RTDB_REV);
 
- while( ( opt = getopt (argc, argv, "ndsPDS:H:kI:h") ) != -1 )
+ while( ( opt = getopt (argc, argv, "ndsPDS:O:H:L:kI:h") ) != -1 )
   switch(opt)
    {
     case 'n': daemon = 0; break;
@@ -88,7 +96,9 @@ int main(int argc, char *argv[]) {
 #endif
     case 'D': daemon = 0; kogmo_rtdb_debug = DBGL_MAX; break;
     case 'S': setenv("KOGMO_RTDB_HEAPSIZE",optarg,1); break;
+    case 'O': setenv("KOGMO_RTDB_OBJMAX",optarg,1); break;
     case 'H': setenv("KOGMO_RTDB_DBHOST",optarg,1); break;
+    case 'L': setenv("KOGMO_RTDB_HUGEPAGES",optarg,1); break;
     case 'I': setenv("KOGMO_RTDB_MINHIST",optarg,1); break;
     case 'k': justkill = 1; break;
     case 'h':
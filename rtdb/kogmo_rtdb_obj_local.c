@@ -31,6 +31,109 @@ exit_handler(int code, void *db_h)
 }
 
 
+// internal: take the wait policy of a new connection from the environment
+static void
+kogmo_rtdb_waitspin_init (kogmo_rtdb_handle_t *db_h)
+{
+  float spin_time = KOGMO_RTDB_DEFAULT_WAIT_SPIN;
+  if ( getenv ("KOGMO_RTDB_WAIT_SPIN") )
+    spin_time = atof ( getenv ("KOGMO_RTDB_WAIT_SPIN") );
+  db_h->wait_spin_ticks = spin_time > 0 ? kogmo_timestamp_add_secs (0, spin_time) : 0;
+  db_h->wait_spin_yield = getenv ("KOGMO_RTDB_WAIT_YIELD") ?
+                          atoi ( getenv ("KOGMO_RTDB_WAIT_YIELD") ) != 0 : 0;
+  memset (&db_h->waitstats, 0, sizeof (db_h->waitstats));
+  if ( db_h->wait_spin_ticks )
+    DBGL (DBGL_DB,"wait: spinning %.6f seconds%s before sleeping", spin_time,
+          db_h->wait_spin_yield ? " with sched_yield()" : "");
+}
+
+
+
+#define LAYOUT_ALIGN(offset) ( ( (offset) + 63 ) & ~63L )
+
+/*! \brief Compute the Layout of the Object Tables in Shared Memory.
+ * For internal use only.
+ * The tables follow struct kogmo_rtdb_obj_local_t and their size depends on
+ * the number of object slots. Sets the table pointers in the handle if the
+ * database is already mapped.
+ * \returns the offset of the heap relative to the local data
+ */
+long int
+kogmo_rtdb_obj_local_layout (kogmo_rtdb_handle_t *db_h, uint32_t obj_max)
+{
+  long int offset, objhot_offset, objmeta_offset, obj_lock_offset, index_offset, name_next_offset,
+           type_next_offset, parent_next_offset, free_next_offset, name_prev_offset,
+           type_prev_offset, parent_prev_offset, free_prev_offset;
+#ifndef KOGMO_RTDB_IPC_FUTEX
+  long int obj_changenotify_offset, obj_changenotify_lock_offset;
+#endif
+  uint32_t index_size;
+  char *base = (char*) db_h->localdata_p;
+
+  // at least twice the number of slots to keep the probe sequences short,
+  // the limit keeps the shift from wrapping for invalid obj_max
+  for ( index_size = 1; index_size < 2 * obj_max && index_size < 2 * KOGMO_RTDB_OBJ_MAX_LIMIT;
+        index_size <<= 1 );
+
+  offset = LAYOUT_ALIGN ( sizeof (struct kogmo_rtdb_obj_local_t) );
+  objhot_offset = offset;
+  offset = LAYOUT_ALIGN ( offset + obj_max * sizeof (struct kogmo_rtdb_obj_hot_t) );
+  objmeta_offset = offset;
+  offset = LAYOUT_ALIGN ( offset + obj_max * sizeof (kogmo_rtdb_obj_info_t) );
+  obj_lock_offset = offset;
+  offset = LAYOUT_ALIGN ( offset + obj_max * sizeof (pthread_mutex_t) );
+#ifndef KOGMO_RTDB_IPC_FUTEX
+  obj_changenotify_offset = offset;
+  offset = LAYOUT_ALIGN ( offset + obj_max * sizeof (pthread_cond_t) );
+  obj_changenotify_lock_offset = offset;
+  offset = LAYOUT_ALIGN ( offset + obj_max * sizeof (pthread_mutex_t) );
+#endif
+  index_offset = offset;
+  offset = LAYOUT_ALIGN ( offset + index_size * sizeof (int32_t) );
+  name_next_offset = offset;
+  offset = LAYOUT_ALIGN ( offset + obj_max * sizeof (int32_t) );
+  type_next_offset = offset;
+  offset = LAYOUT_ALIGN ( offset + obj_max * sizeof (int32_t) );
+  parent_next_offset = offset;
+  offset = LAYOUT_ALIGN ( offset + obj_max * sizeof (int32_t) );
+  free_next_offset = offset;
+  offset = LAYOUT_ALIGN ( offset + obj_max * sizeof (int32_t) );
+  name_prev_offset = offset;
+  offset = LAYOUT_ALIGN ( offset + obj_max * sizeof (int32_t) );
+  type_prev_offset = offset;
+  offset = LAYOUT_ALIGN ( offset + obj_max * sizeof (int32_t) );
+  parent_prev_offset = offset;
+  offset = LAYOUT_ALIGN ( offset + obj_max * sizeof (int32_t) );
+  free_prev_offset = offset;
+  offset = LAYOUT_ALIGN ( offset + obj_max * sizeof (int32_t) );
+
+  db_h->obj_max = obj_max;
+  db_h->obj_index_size = index_size;
+  if ( base != NULL )
+    {
+      db_h->objhot = (struct kogmo_rtdb_obj_hot_t *) ( base + objhot_offset );
+      db_h->objmeta = (kogmo_rtdb_obj_info_t *) ( base + objmeta_offset );
+      db_h->obj_lock = (pthread_mutex_t *) ( base + obj_lock_offset );
+#ifndef KOGMO_RTDB_IPC_FUTEX
+      db_h->obj_changenotify = (pthread_cond_t *) ( base + obj_changenotify_offset );
+      db_h->obj_changenotify_lock = (pthread_mutex_t *) ( base + obj_changenotify_lock_offset );
+#endif
+      db_h->objmeta_index = (int32_t *) ( base + index_offset );
+      db_h->objmeta_name_next = (int32_t *) ( base + name_next_offset );
+      db_h->objmeta_type_next = (int32_t *) ( base + type_next_offset );
+      db_h->objmeta_parent_next = (int32_t *) ( base + parent_next_offset );
+      db_h->objmeta_free_next = (int32_t *) ( base + free_next_offset );
+      db_h->objmeta_name_prev = (int32_t *) ( base + name_prev_offset );
+      db_h->objmeta_type_prev = (int32_t *) ( base + type_prev_offset );
+      db_h->objmeta_parent_prev = (int32_t *) ( base + parent_prev_offset );
+      db_h->objmeta_free_prev = (int32_t *) ( base + free_prev_offset );
+      db_h->heap = base + offset;
+    }
+  DBGL(DBGL_DB,"local_layout: %u object slots, %u index entries, heap at offset %li",
+       obj_max, index_size, offset);
+  return offset;
+}
+
 
 void
 kogmo_rtdb_obj_local_init (kogmo_rtdb_handle_t *db_h,
@@ -57,17 +160,24 @@ kogmo_rtdb_obj_local_init (kogmo_rtdb_handle_t *db_h,
 
   kogmo_rtdb_ipc_mutex_init(&db_h->localdata_p->objmeta_lock);
   kogmo_rtdb_ipc_condvar_init(&db_h->localdata_p->objmeta_changenotify);
-  db_h->localdata_p->objmeta_free=KOGMO_RTDB_OBJ_MAX;
+  db_h->localdata_p->objmeta_free=db_h->obj_max;
 
-  for ( i=0; i < KOGMO_RTDB_OBJ_MAX; i++)
+  // all slots are free, the lowest slots will be used first
+  db_h->localdata_p->objmeta_free_head = 1;
+  for ( i=0; i < (int)db_h->obj_max; i++)
+    db_h->objmeta_free_next[i] = i + 1 < (int)db_h->obj_max ? i + 2 : 0;
+
+  for ( i=0; i < (int)db_h->obj_max; i++)
     {
-      kogmo_rtdb_ipc_mutex_init(&db_h->localdata_p->obj_lock[i]);
-      kogmo_rtdb_ipc_mutex_init(&db_h->localdata_p->obj_changenotify_lock[i]);
-      kogmo_rtdb_ipc_condvar_init(&db_h->localdata_p->obj_changenotify[i]);
+      kogmo_rtdb_ipc_mutex_init(&db_h->obj_lock[i]);
+#ifndef KOGMO_RTDB_IPC_FUTEX
+      kogmo_rtdb_ipc_mutex_init(&db_h->obj_changenotify_lock[i]);
+      kogmo_rtdb_ipc_condvar_init(&db_h->obj_changenotify[i]);
+#endif
     }
   kogmo_rtdb_ipc_mutex_init(&db_h->localdata_p->heap_lock);
   kogmo_rtdb_obj_mem_init (db_h);
-  kogmo_rtdb_obj_mem_alloc (db_h, 2); // so there will be no index 0 in future requests
+  kogmo_rtdb_obj_mem_alloc (db_h, 2, 0, NULL); // so there will be no index 0 in future requests
 }
 
 
@@ -79,13 +189,13 @@ kogmo_rtdb_obj_local_destroy (kogmo_rtdb_handle_t *db_h)
   kogmo_rtdb_obj_mem_destroy (db_h);
   DBGL(DBGL_DB,"local_destroy() mutexes");
   kogmo_rtdb_ipc_mutex_destroy(&db_h->localdata_p->heap_lock);
-  for ( i=0; i < KOGMO_RTDB_OBJ_MAX; i++)
+  for ( i=0; i < (int)db_h->obj_max; i++)
     {
-      kogmo_rtdb_ipc_mutex_destroy(&db_h->localdata_p->obj_lock[i]);
-      kogmo_rtdb_ipc_mutex_destroy(&db_h->localdata_p->
-                                   obj_changenotify_lock[i]);
-      kogmo_rtdb_ipc_condvar_destroy(&db_h->localdata_p->
-                                     obj_changenotify[i]);
+      kogmo_rtdb_ipc_mutex_destroy(&db_h->obj_lock[i]);
+#ifndef KOGMO_RTDB_IPC_FUTEX
+      kogmo_rtdb_ipc_mutex_destroy(&db_h->obj_changenotify_lock[i]);
+      kogmo_rtdb_ipc_condvar_destroy(&db_h->obj_changenotify[i]);
+#endif
     }
   kogmo_rtdb_ipc_mutex_destroy(&db_h->localdata_p->objmeta_lock);
   kogmo_rtdb_ipc_condvar_destroy(&db_h->localdata_p->
@@ -117,7 +227,8 @@ kogmo_rtdb_connect (kogmo_rtdb_handle_t **db_hp,
 {
   kogmo_rtdb_objid_t connoid,rootoid,procoid,proclistoid;
   kogmo_rtdb_obj_info_t objmeta;
-  long int localdata_size=0;
+  long int localdata_size=0, heap_offset=0;
+  long int obj_max=0;
   int ret;
   char *local_dbhost=NULL;
   kogmo_rtdb_handle_t *db_h;
@@ -140,6 +251,10 @@ kogmo_rtdb_connect (kogmo_rtdb_handle_t **db_hp,
 
   DBG("db handle at %p, points to %p",&db_h,db_h);
   db_h->localdata_p = NULL; // still not connected
+  kogmo_rtdb_regex_cache_init (db_h);
+  kogmo_rtdb_copy_init (db_h);
+  kogmo_rtdb_waitspin_init (db_h);
+  kogmo_rtdb_obj_subscribe_init (db_h);
 
   if ( ! conninfo->cycletime )
     conninfo->cycletime = KOGMO_RTDB_DEFAULT_MAX_CYCLETIME;
@@ -159,6 +274,20 @@ kogmo_rtdb_connect (kogmo_rtdb_handle_t **db_hp,
     DIE("heapsize %lli too small, minimum is %lli bytes",
         (long long int) localdata_size, (long long int) KOGMO_RTDB_MINIMUM_HEAP_SIZE);
 
+  // only relevant for manager, normal processes get it from the database
+  // and do the layout after connecting
+  if ( conninfo->flags & KOGMO_RTDB_CONNECT_FLAGS_MANAGER )
+    {
+      obj_max = KOGMO_RTDB_OBJ_MAX;
+      if ( getenv ("KOGMO_RTDB_OBJMAX") )
+        obj_max = strtol ( getenv ("KOGMO_RTDB_OBJMAX"), NULL, 0);
+      if ( obj_max < 16 || obj_max > KOGMO_RTDB_OBJ_MAX_LIMIT )
+        DIE("number of object slots %li invalid, must be between 16 and %li",
+            obj_max, (long int) KOGMO_RTDB_OBJ_MAX_LIMIT);
+      heap_offset = kogmo_rtdb_obj_local_layout (db_h, obj_max);
+      localdata_size += heap_offset;
+    }
+
   if (conninfo->dbhost==NULL || (conninfo->dbhost!=NULL && conninfo->dbhost[0]=='\0'))
     {
       conninfo->dbhost = KOGMO_RTDB_DEFAULT_DBHOST;
@@ -193,6 +322,20 @@ kogmo_rtdb_connect (kogmo_rtdb_handle_t **db_hp,
         DIE("error connecting to local database, error %d",connoid);
     }
 
+  if ( this_process_is_manager (db_h) )
+    {
+      db_h->localdata_p->obj_max = obj_max;
+      db_h->localdata_p->heap_offset = heap_offset;
+      db_h->localdata_p->obj_index_size = db_h->obj_index_size;
+    }
+  if ( db_h->localdata_p->obj_max < 16 || db_h->localdata_p->obj_max > KOGMO_RTDB_OBJ_MAX_LIMIT )
+    DIE("inconsistent database layout, %li object slots",
+        (long int) db_h->localdata_p->obj_max);
+  heap_offset = kogmo_rtdb_obj_local_layout (db_h, db_h->localdata_p->obj_max);
+  if ( heap_offset != db_h->localdata_p->heap_offset )
+    DIE("inconsistent database layout, heap at offset %li instead of %li",
+        heap_offset, db_h->localdata_p->heap_offset);
+
   //if ( conninfo->dbhost && strncmp ( conninfo->dbhost, "local:", 6 ) != 0 )
   kogmo_rtdb_obj_mem_attach (db_h);
 
@@ -235,8 +378,7 @@ kogmo_rtdb_connect (kogmo_rtdb_handle_t **db_hp,
 
   if (this_process_is_manager (db_h) )
     {
-      kogmo_rtdb_obj_local_init(db_h, localdata_size -
-                                      sizeof(struct kogmo_rtdb_obj_local_t) );
+      kogmo_rtdb_obj_local_init(db_h, localdata_size - heap_offset );
       // init root node
       kogmo_rtdb_obj_initinfo (db_h, &objmeta, "root",
                                KOGMO_RTDB_OBJTYPE_C3_ROOT, 0);
@@ -353,9 +495,11 @@ kogmo_rtdb_connect (kogmo_rtdb_handle_t **db_hp,
       snprintf (rtdb_obj.rtdb.version_id, sizeof (rtdb_obj.rtdb.version_id),
                 KOGMO_RTDB_COPYRIGHT
                 "Release %i%s (%s)\n", KOGMO_RTDB_REV, KOGMO_RTDB_REVSPEC, KOGMO_RTDB_DATE);
-      rtdb_obj.rtdb.objects_max=rtdb_obj.rtdb.objects_free=KOGMO_RTDB_OBJ_MAX;
+      rtdb_obj.rtdb.objects_max=rtdb_obj.rtdb.objects_free=db_h->obj_max;
       rtdb_obj.rtdb.processes_max=rtdb_obj.rtdb.processes_free=KOGMO_RTDB_PROC_MAX;
       rtdb_obj.rtdb.memory_max=rtdb_obj.rtdb.memory_free=db_h->localdata_p->heap_size;
+      rtdb_obj.rtdb.page_size=db_h->ipc_h.shm_p->data_pagesize;
+      rtdb_obj.rtdb.page_type=db_h->ipc_h.shm_p->data_pagetype;
       ret = kogmo_rtdb_obj_writedata (db_h, dbinfooid, &rtdb_obj);
       if ( ret < 0 )
         {
@@ -387,6 +531,9 @@ kogmo_rtdb_disconnect (kogmo_rtdb_handle_t *db_h, void *discinfo)
 
   CHK_DBH("kogmo_rtdb_disconnect",db_h,0);
 
+  // stop the notifier thread while the database is still there
+  kogmo_rtdb_obj_subscribe_destroy (db_h);
+
   if (db_h->procobjmeta.oid != 0 && this_process_is_manager (db_h) )
     {
       kogmo_rtdb_kill_procs(db_h, 15);
@@ -396,8 +543,9 @@ kogmo_rtdb_disconnect (kogmo_rtdb_handle_t *db_h, void *discinfo)
   if ( db_h->procobjmeta.oid != 0 )
     {
       kogmo_rtdb_obj_info_t used_objmeta;
-      kogmo_rtdb_objid_list_t objlist;
-      int i, immediately_delete;
+      kogmo_rtdb_obj_search_t search;
+      kogmo_rtdb_objid_t objlist[64];
+      int i, n, immediately_delete;
       kogmo_rtdb_objid_t err;
 
       DBGL (DBGL_IPC, "deleting all objects created by this process proc_oid %d",
@@ -408,13 +556,15 @@ kogmo_rtdb_disconnect (kogmo_rtdb_handle_t *db_h, void *discinfo)
 
       immediately_delete = db_h->procobj.process.flags & KOGMO_RTDB_CONNECT_FLAGS_IMMEDIATELYDELETE;
 
-      err = kogmo_rtdb_obj_searchinfo_deleted (db_h, "", 0, 0,
-                db_h->procobj.process.proc_oid, 0, objlist, 0);
-      DBG("process has %i objects to%s delete",err,immediately_delete ? " immediately":"");
+      err = kogmo_rtdb_obj_searchinfo_begin (db_h, &search, "", 0, 0,
+                db_h->procobj.process.proc_oid, 0, KOGMO_RTDB_SEARCH_FLAGS_DELETED);
+      DBG("deleting objects of this process%s",immediately_delete ? " immediately":"");
       if (err < 0 )
         return err;
 
-      for (i=0; objlist[i] != 0; i++ )
+      while ( ( n = kogmo_rtdb_obj_searchinfo_next (db_h, &search, objlist,
+                      sizeof(objlist)/sizeof(objlist[0])) ) > 0 )
+        for (i=0; i<n; i++ )
         {
           err = kogmo_rtdb_obj_readinfo (db_h, objlist[i], 0, &used_objmeta );
           if ( err >= 0 && used_objmeta.flags.persistent )
@@ -429,6 +579,7 @@ kogmo_rtdb_disconnect (kogmo_rtdb_handle_t *db_h, void *discinfo)
             }
            kogmo_rtdb_obj_delete_imm(db_h, &used_objmeta, immediately_delete);
         }
+      kogmo_rtdb_obj_searchinfo_end (db_h, &search);
 
       DBGL (DBGL_IPC, "delete process object");
       kogmo_rtdb_obj_delete_imm (db_h, &db_h->procobjmeta, immediately_delete);
@@ -445,6 +596,7 @@ kogmo_rtdb_disconnect (kogmo_rtdb_handle_t *db_h, void *discinfo)
     kogmo_rtdb_obj_local_destroy(db_h);
 
   err = kogmo_rtdb_ipc_disconnect (&db_h->ipc_h, flags);
+  kogmo_rtdb_regex_cache_destroy (db_h);
   // free(db_h); - the exit-handler still depends on it
   DBGL(DBGL_API,"kogmo_rtdb_disconnect() done.");
   return err;
@@ -473,6 +625,30 @@ kogmo_rtdb_cycle_done (kogmo_rtdb_handle_t *db_h, uint32_t flags)
 }
 
 
+int
+kogmo_rtdb_setwaitspin (kogmo_rtdb_handle_t *db_h, float spin_time, int yield)
+{
+  CHK_DBH("kogmo_rtdb_setwaitspin",db_h,0);
+  if ( spin_time < 0 )
+    return -KOGMO_RTDB_ERR_INVALID;
+  db_h->wait_spin_ticks = kogmo_timestamp_add_secs (0, spin_time);
+  db_h->wait_spin_yield = yield ? 1 : 0;
+  DBGL (DBGL_API,"kogmo_rtdb_setwaitspin(%f,%i)", spin_time, yield);
+  return 0;
+}
+
+int
+kogmo_rtdb_getwaitstats (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_waitstats_t *stats, int reset)
+{
+  CHK_DBH("kogmo_rtdb_getwaitstats",db_h,0);
+  if ( stats )
+    *stats = db_h->waitstats;
+  if ( reset )
+    memset (&db_h->waitstats, 0, sizeof (db_h->waitstats));
+  return 0;
+}
+
+
 kogmo_timestamp_t
 kogmo_rtdb_timestamp_now (kogmo_rtdb_handle_t *db_h)
 {
@@ -21,22 +21,144 @@ namespace KogniMobil {
 #endif
 
 
+// default number of object slots, the manager can set another number at startup
+// (environment variable KOGMO_RTDB_OBJMAX, kogmo_rtdb_man -O)
 #ifndef KOGMO_RTDB_OBJ_MAX
 #define KOGMO_RTDB_OBJ_MAX 1000
 #endif
+#define KOGMO_RTDB_OBJ_MAX_LIMIT (1024*1024)
+
+// number of hash buckets for the name and type indices, must be a power of 2
+#ifndef KOGMO_RTDB_OBJ_HASH_SIZE
+#define KOGMO_RTDB_OBJ_HASH_SIZE 1024
+#endif
+#if ( KOGMO_RTDB_OBJ_HASH_SIZE & ( KOGMO_RTDB_OBJ_HASH_SIZE - 1 ) )
+#error KOGMO_RTDB_OBJ_HASH_SIZE must be a power of 2
+#endif
+
+// hot part of the object metadata: a copy of the fields used by the data paths
+// and by the slot scans, one cache line per slot, so that a scan touches one line
+// per slot instead of three. the complete kogmo_rtdb_obj_info_t stays in objmeta[]
+// (the cold table) for readinfo and the name matching.
+// oid is published last by insert and verified by lock-free readers, history_slot
+// is only maintained here (objmeta[].history_slot is not updated by commits).
+// other fields are changed under objmeta_lock together with the cold table.
+struct kogmo_rtdb_obj_hot_t {
+ kogmo_timestamp_t     created_ts;
+ kogmo_timestamp_t     deleted_ts;
+ kogmo_rtdb_objid_t    oid;
+ kogmo_rtdb_objtype_t  otype;
+ kogmo_rtdb_objid_t    parent_oid;
+ kogmo_rtdb_objid_t    created_proc;
+ kogmo_rtdb_objsize_t  size_max;
+ kogmo_rtdb_objsize_t  slot_stride; // distance of the history slots, see KOGMO_RTDB_OBJ_SLOT_STRIDE()
+ int32_t               history_size;
+ volatile int32_t      history_slot;
+ kogmo_rtdb_objsize_t  buffer_idx;
+ float                 history_interval;
+ float                 min_cycletime;
+ float                 max_cycletime;
+ __typeof__ (((kogmo_rtdb_obj_info_t *)0)->flags) flags;
+#ifdef KOGMO_RTDB_IPC_FUTEX
+ volatile uint32_t     notify_seq; // counts notifies, see kogmo_rtdb_obj_do_notify()
+#endif
+} __attribute__ ((aligned (64)));
+
+// the heap buffer of an object holds its history slots, then the commit sequence
+// numbers of the slots (uint64_t, see commit_seq in kogmo_rtdb_obj_local_t)
+// and then the optional data_ts index.
+
+// optional index of the history of an object by data_ts (flags.data_ts_index),
+// placed in the heap buffer of the object behind the commit sequence numbers.
+// the entries are sorted by data_ts, commits with the same data_ts in commit order.
+// they are kept in a ring (entry[(first+i)%history_size] is the i-th), so that
+// in-order commits remove and add entries at its ends in constant time.
+// only commits change it, and they are serialized per object (single owner or
+// obj_lock), readers do not lock: seq is odd during a change, a reader repeats
+// its lookup if seq changed, and verifies data_ts and committed_ts of the slot.
+struct kogmo_rtdb_obj_dataidx_entry_t {
+ kogmo_timestamp_t     data_ts;
+ int32_t               slot;
+ int32_t               reserved;
+};
+struct kogmo_rtdb_obj_dataidx_t {
+ volatile uint32_t     seq;
+ int32_t               first;
+ int32_t               count;
+ int32_t               reserved;
+ struct kogmo_rtdb_obj_dataidx_entry_t entry[];
+};
+
+// history slots start at a cache line, large slots at a page, so that a writer
+// filling one slot does not share a cache line with the readers of the previous one.
+// the heap buffer of an object is aligned the same way (see kogmo_rtdb_obj_mem_alloc).
+#define KOGMO_RTDB_OBJ_SLOT_ALIGN_LINE 64
+#define KOGMO_RTDB_OBJ_SLOT_ALIGN_PAGE 4096
+#define KOGMO_RTDB_OBJ_SLOT_PAGED_MIN  (4*KOGMO_RTDB_OBJ_SLOT_ALIGN_PAGE) // smaller slots would waste too much
+#define KOGMO_RTDB_OBJ_SLOT_ALIGN(size_max) \
+  ( (size_max) >= KOGMO_RTDB_OBJ_SLOT_PAGED_MIN ? \
+    KOGMO_RTDB_OBJ_SLOT_ALIGN_PAGE : KOGMO_RTDB_OBJ_SLOT_ALIGN_LINE )
+#define KOGMO_RTDB_OBJ_SLOT_STRIDE(size_max) \
+  ( ( (size_max) + KOGMO_RTDB_OBJ_SLOT_ALIGN(size_max) - 1 ) \
+    / KOGMO_RTDB_OBJ_SLOT_ALIGN(size_max) * KOGMO_RTDB_OBJ_SLOT_ALIGN(size_max) )
+
+// size of the heap buffer of an object (kogmo_rtdb_obj_info_t or kogmo_rtdb_obj_hot_t)
+#define KOGMO_RTDB_OBJ_BUFFER_SIZE(p) \
+  ( KOGMO_RTDB_OBJ_SLOT_STRIDE ((p)->size_max) * (p)->history_size \
+    + (kogmo_rtdb_objsize_t) ( (p)->history_size * sizeof (uint64_t) ) \
+    + ( (p)->flags.data_ts_index && (p)->history_size ? \
+        (kogmo_rtdb_objsize_t) ( sizeof (struct kogmo_rtdb_obj_dataidx_t) \
+          + (p)->history_size * sizeof (struct kogmo_rtdb_obj_dataidx_entry_t) ) : 0 ) )
 
 // this is database-global
+// the struct is followed by the object tables, their size depends on obj_max
+// (see kogmo_rtdb_obj_local_layout()), and then by the heap for the object data
 struct kogmo_rtdb_obj_local_t {
  uint64_t objmeta_oid_next;
 
- kogmo_rtdb_obj_info_t objmeta[KOGMO_RTDB_OBJ_MAX];
+ uint32_t obj_max;        // number of object slots, set by the manager
+ uint32_t obj_index_size; // size of the oid index, power of 2
+ long int heap_offset;    // begin of the heap, relative to this struct
+
  uint32_t objmeta_free;
  pthread_mutex_t objmeta_lock;
  pthread_cond_t  objmeta_changenotify;
 
- pthread_mutex_t obj_lock[KOGMO_RTDB_OBJ_MAX];
- pthread_cond_t  obj_changenotify[KOGMO_RTDB_OBJ_MAX];
- pthread_mutex_t obj_changenotify_lock[KOGMO_RTDB_OBJ_MAX];
+ // oid->slot index (objmeta_index[], open addressing, linear probing), protected by
+ // objmeta_lock for writers, readers probe it without locks and verify the oid in the slot;
+ // entries are slot+1, 0 marks a free entry
+ uint32_t objmeta_index_maxprobe; // longest probe sequence ever used, never decreases
+
+ // name, type and parent indices for searchinfo, protected by objmeta_lock:
+ // hash buckets with chains through all indexed slots (objmeta_*_next[]) in the order
+ // the slots were added (object creation order); entries are slot+1, 0 ends a chain.
+ // objmeta_*_prev[] link backwards, the head's entry points to the tail of its chain,
+ // so adding and removing a slot takes constant time.
+ // the parent chains are keyed by parent_oid, so they give the children of
+ // an object and survive the purge and reuse of the parent's slot
+ int32_t objmeta_name_hash[KOGMO_RTDB_OBJ_HASH_SIZE];
+ int32_t objmeta_type_hash[KOGMO_RTDB_OBJ_HASH_SIZE];
+ int32_t objmeta_parent_hash[KOGMO_RTDB_OBJ_HASH_SIZE];
+
+ // lists of reusable slots, protected by objmeta_lock, linked through objmeta_free_next[]
+ // (a slot is in at most one of them), entries are slot+1, 0 ends a list:
+ // free slots (oid 0, a stack) and chains of deleted keep-alloc slots (like the
+ // search index chains, with objmeta_free_prev[]), hashed by creator and total data size
+ int32_t objmeta_free_head;
+ int32_t objmeta_keepalloc_hash[KOGMO_RTDB_OBJ_HASH_SIZE];
+
+ // global commit sequence: counts all commits, a commit stores its number for
+ // the history slot it wrote. kogmo_rtdb_obj_readdata_multi() reads only data
+ // up to the number at its start. changed with atomic operations only, on a
+ // cache line of its own because every commit changes it.
+ volatile uint64_t commit_seq __attribute__ ((aligned (64)));
+ char commit_seq_pad[64 - sizeof (uint64_t)];
+
+#ifdef KOGMO_RTDB_IPC_FUTEX
+ // futex word for kogmo_rtdb_obj_wait_any(), a commit to an object that has
+ // an any-waiter flagged in its notify_seq increments it, see kogmo_rtdb_obj_do_notify()
+ volatile uint32_t anynotify_seq;
+#endif
 
  int32_t rtdb_trace;
  int32_t rtdb_tracebufsize;
@@ -56,8 +178,6 @@ struct kogmo_rtdb_obj_local_t {
  size_t heap_free;
  size_t heap_used;
  pthread_mutex_t heap_lock;
-
- char heap[1]; // will be extended
 };
 
 #ifndef KOGMO_RTDB_DEFAULT_HEAP_SIZE
@@ -67,6 +187,35 @@ struct kogmo_rtdb_obj_local_t {
 #define KOGMO_RTDB_MINIMUM_HEAP_SIZE (512*1024)
 
 
+// data blocks larger than half of the last level cache, but at least this
+// size, are copied with non-temporal stores (if the cpu supports it),
+// the environment variable KOGMO_RTDB_COPY_THRESHOLD overrides it, 0: never
+#ifndef KOGMO_RTDB_COPY_THRESHOLD_MIN
+#define KOGMO_RTDB_COPY_THRESHOLD_MIN (1024*1024)
+#endif
+
+// readers spin on the commit word of an object for this time (in seconds)
+// before they sleep in the kernel, the environment variables
+// KOGMO_RTDB_WAIT_SPIN (seconds) and KOGMO_RTDB_WAIT_YIELD (1: call
+// sched_yield() while spinning) override it, see kogmo_rtdb_setwaitspin()
+#ifndef KOGMO_RTDB_DEFAULT_WAIT_SPIN
+#define KOGMO_RTDB_DEFAULT_WAIT_SPIN 0
+#endif
+// reads of the commit word between two looks at the clock
+#define KOGMO_RTDB_WAIT_SPIN_CHECKS 64
+
+// number of compiled regular expressions for '~' searches kept per handle
+#ifndef KOGMO_RTDB_REGEX_CACHE_SIZE
+#define KOGMO_RTDB_REGEX_CACHE_SIZE 8
+#endif
+
+struct kogmo_rtdb_regex_cache_t {
+ char *pattern; // NULL: unused
+ regex_t re;
+ uint32_t lastuse;
+ uint32_t users; // running searches, entry must not be replaced while >0
+};
+
 // this is process-local
 typedef struct {
  kogmo_rtdb_obj_info_t procobjmeta;
@@ -75,6 +224,39 @@ typedef struct {
  long int localdata_size;
  void *heapinfo;
  struct kogmo_rtdb_ipc_handle_t ipc_h;
+ // object tables and heap in shared memory, see kogmo_rtdb_obj_local_layout()
+ uint32_t obj_max;
+ uint32_t obj_index_size;
+ struct kogmo_rtdb_obj_hot_t *objhot;
+ kogmo_rtdb_obj_info_t *objmeta;
+ pthread_mutex_t *obj_lock;
+#ifndef KOGMO_RTDB_IPC_FUTEX
+ pthread_cond_t  *obj_changenotify;
+ pthread_mutex_t *obj_changenotify_lock;
+#endif
+ int32_t *objmeta_index;
+ int32_t *objmeta_name_next;
+ int32_t *objmeta_type_next;
+ int32_t *objmeta_parent_next;
+ int32_t *objmeta_free_next;
+ int32_t *objmeta_name_prev;
+ int32_t *objmeta_type_prev;
+ int32_t *objmeta_parent_prev;
+ int32_t *objmeta_free_prev;
+ char *heap;
+ // least recently used cache of compiled search patterns
+ struct kogmo_rtdb_regex_cache_t regex_cache[KOGMO_RTDB_REGEX_CACHE_SIZE];
+ uint32_t regex_cache_clock;
+ pthread_mutex_t regex_cache_lock;
+ // notifier thread for pollable file descriptors, see kogmo_rtdb_obj_subscribe_fd()
+ struct kogmo_rtdb_obj_subscriptions_t *subscriptions;
+ // copy function for large data blocks, see kogmo_rtdb_copy_init()
+ void *(*copy_large)(void *dest, const void *src, size_t n);
+ size_t copy_threshold;
+ // spinning before sleeping in waitnext, see kogmo_rtdb_setwaitspin()
+ kogmo_timestamp_t wait_spin_ticks;
+ int wait_spin_yield;
+ kogmo_rtdb_waitstats_t waitstats;
 } kogmo_rtdb_handle_t;
 
 
@@ -83,10 +265,40 @@ inline static int
 kogmo_rtdb_obj_slotnum (kogmo_rtdb_handle_t *db_h,
                         kogmo_rtdb_obj_info_t *objmeta_p)
 {
-  return (int) ( ( (long int)objmeta_p - (long int) (&db_h->localdata_p->objmeta[0]))
+  return (int) ( ( (long int)objmeta_p - (long int) (&db_h->objmeta[0]))
           / sizeof( kogmo_rtdb_obj_info_t ) );
 }
 
+// the commit sequence numbers of the history slots of an object
+inline static uint64_t *
+kogmo_rtdb_obj_commitseq (kogmo_rtdb_handle_t *db_h,
+                          struct kogmo_rtdb_obj_hot_t *objhot_p)
+{
+  return (uint64_t *)
+           & ( db_h->heap [ objhot_p->buffer_idx
+                            + objhot_p->slot_stride * objhot_p->history_size ] );
+}
+
+// the data_ts index of an object, NULL if it has none
+inline static struct kogmo_rtdb_obj_dataidx_t *
+kogmo_rtdb_obj_dataidx (kogmo_rtdb_handle_t *db_h,
+                        struct kogmo_rtdb_obj_hot_t *objhot_p)
+{
+  if ( !objhot_p->flags.data_ts_index || objhot_p->history_size == 0 )
+    return NULL;
+  return (struct kogmo_rtdb_obj_dataidx_t *)
+           & ( db_h->heap [ objhot_p->buffer_idx
+                            + objhot_p->slot_stride * objhot_p->history_size
+                            + objhot_p->history_size * sizeof (uint64_t) ] );
+}
+
+inline static int
+kogmo_rtdb_obj_hot_slotnum (kogmo_rtdb_handle_t *db_h,
+                            struct kogmo_rtdb_obj_hot_t *objhot_p)
+{
+  return (int) ( objhot_p - &db_h->objhot[0] );
+}
+
 
 
 #ifdef __cplusplus
@@ -33,43 +33,182 @@ kogmo_rtdb_obj_initdata (kogmo_rtdb_handle_t *db_h,
 // internal:
 inline static void *
 kogmo_rtdb_obj_histscan (kogmo_rtdb_handle_t *db_h, int32_t adj,
-                         kogmo_rtdb_obj_info_t *scan_objmeta_p,
+                         struct kogmo_rtdb_obj_hot_t *scan_objhot_p,
                          int32_t *currslot, int32_t *firstslot);
 
 
-int
-kogmo_rtdb_obj_writedata (kogmo_rtdb_handle_t *db_h,
-                       kogmo_rtdb_objid_t oid, void *data_p)
+// internal: store the next global commit sequence number for a history slot
+inline static void
+kogmo_rtdb_obj_commitseq_set (kogmo_rtdb_handle_t *db_h,
+                              struct kogmo_rtdb_obj_hot_t *used_objhot_p, int32_t slot)
+{
+  uint64_t seq = __sync_add_and_fetch (&db_h->localdata_p->commit_seq, 1);
+  // a single store, readers on 32-bit cpus must not see half of it
+  __atomic_store_n (&kogmo_rtdb_obj_commitseq (db_h, used_objhot_p)[slot], seq, __ATOMIC_RELAXED);
+}
+
+// internal: the i-th entry of a data_ts index, ordered by data_ts
+#define DATAIDX_ENTRY(idx_p,size,i) (&(idx_p)->entry[ ( (idx_p)->first + (i) ) % (size) ])
+
+// internal: number of index entries with data_ts < ts (or_equal: <= ts)
+inline static int32_t
+kogmo_rtdb_obj_dataidx_bound (struct kogmo_rtdb_obj_dataidx_t *idx_p, int32_t size,
+                              int32_t count, kogmo_timestamp_t ts, int or_equal)
 {
-  kogmo_rtdb_obj_info_t *used_objmeta_p;
+  int32_t lo = 0, hi = count, mid;
+  kogmo_timestamp_t entry_ts;
+  while ( lo < hi )
+    {
+      mid = lo + ( hi - lo ) / 2;
+      entry_ts = DATAIDX_ENTRY (idx_p, size, mid)->data_ts;
+      if ( entry_ts < ts || ( or_equal && entry_ts == ts ) )
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+  return lo;
+}
+
+// internal: update the data_ts index of an object after a commit into
+// history_slot. the entry of the overwritten data is usually the oldest,
+// so it is searched from the front. entries are moved towards the nearer
+// end of the ring.
+inline static void
+kogmo_rtdb_obj_dataidx_commit (kogmo_rtdb_handle_t *db_h,
+                               struct kogmo_rtdb_obj_hot_t *used_objhot_p,
+                               int32_t history_slot, kogmo_timestamp_t data_ts)
+{
+  struct kogmo_rtdb_obj_dataidx_t *idx_p;
+  int32_t size = used_objhot_p->history_size;
+  int32_t i, pos;
+
+  idx_p = kogmo_rtdb_obj_dataidx (db_h, used_objhot_p);
+  if ( idx_p == NULL )
+    return;
+
+  idx_p->seq++;
+  COMPILER_BARRIER();
+
+  // remove the entry of the overwritten data
+  for ( pos = 0; pos < idx_p->count; pos++ )
+    if ( DATAIDX_ENTRY (idx_p, size, pos)->slot == history_slot )
+      break;
+  if ( pos < idx_p->count )
+    {
+      if ( pos < idx_p->count / 2 )
+        {
+          for ( i = pos; i > 0; i-- )
+            *DATAIDX_ENTRY (idx_p, size, i) = *DATAIDX_ENTRY (idx_p, size, i - 1);
+          idx_p->first = ( idx_p->first + 1 ) % size;
+        }
+      else
+        {
+          for ( i = pos; i < idx_p->count - 1; i++ )
+            *DATAIDX_ENTRY (idx_p, size, i) = *DATAIDX_ENTRY (idx_p, size, i + 1);
+        }
+      idx_p->count--;
+    }
+
+  // insert behind all entries with the same data_ts
+  pos = kogmo_rtdb_obj_dataidx_bound (idx_p, size, idx_p->count, data_ts, 1);
+  if ( pos < idx_p->count / 2 )
+    {
+      idx_p->first = ( idx_p->first - 1 + size ) % size;
+      for ( i = 0; i < pos; i++ )
+        *DATAIDX_ENTRY (idx_p, size, i) = *DATAIDX_ENTRY (idx_p, size, i + 1);
+    }
+  else
+    {
+      for ( i = idx_p->count; i > pos; i-- )
+        *DATAIDX_ENTRY (idx_p, size, i) = *DATAIDX_ENTRY (idx_p, size, i - 1);
+    }
+  DATAIDX_ENTRY (idx_p, size, pos)->data_ts = data_ts;
+  DATAIDX_ENTRY (idx_p, size, pos)->slot = history_slot;
+  idx_p->count++;
+
+  COMPILER_BARRIER();
+  idx_p->seq++;
+}
+
+
+// internal: build the data of a delta commit in the new (already invalid)
+// slot: the header from data_p, the rest from the latest data, then the
+// patches
+static void
+kogmo_rtdb_obj_writedata__patch (kogmo_rtdb_handle_t *db_h,
+                                 struct kogmo_rtdb_obj_hot_t *used_objhot_p,
+                                 void *heap_data_p,
+                                 void *data_p, kogmo_rtdb_objsize_t size,
+                                 _const kogmo_rtdb_obj_patch_t *patches, int count)
+{
+  kogmo_rtdb_subobj_base_t *prev_objbase = NULL;
+  kogmo_rtdb_objsize_t prev_size = sizeof (kogmo_rtdb_subobj_base_t);
+  int32_t prev_slot = used_objhot_p->history_slot;
+  int i;
+
+  if ( prev_slot >= 0 )
+    {
+      prev_objbase = (kogmo_rtdb_subobj_base_t *)
+                       & ( db_h->heap [ used_objhot_p->buffer_idx + prev_slot * used_objhot_p->slot_stride ] );
+      prev_size = prev_objbase->size < size ? prev_objbase->size : size;
+    }
+
+  memcpy ( heap_data_p, data_p, sizeof (kogmo_rtdb_subobj_base_t) );
+  if ( prev_objbase != NULL )
+    kogmo_rtdb_copy ( db_h, (char*) heap_data_p + sizeof (kogmo_rtdb_subobj_base_t),
+                      (char*) prev_objbase + sizeof (kogmo_rtdb_subobj_base_t),
+                      prev_size - sizeof (kogmo_rtdb_subobj_base_t) );
+  if ( size > prev_size )
+    memset ( (char*) heap_data_p + prev_size, 0, size - prev_size );
+
+  for ( i = 0; i < count; i++ )
+    memcpy ( (char*) heap_data_p + patches[i].offset, patches[i].data_p, patches[i].len );
+}
+
+
+// internal: commit data to an object that has already been looked up,
+// checked!=0 means that the commit permission has been checked at bind time.
+// with patches!=NULL this is a delta commit, data_p is only the header
+inline static int
+kogmo_rtdb_obj_writedata__hot (kogmo_rtdb_handle_t *db_h,
+                               struct kogmo_rtdb_obj_hot_t *used_objhot_p,
+                               int checked, void *data_p,
+                               kogmo_timestamp_t now_ts,
+                               _const kogmo_rtdb_obj_patch_t *patches, int count)
+{
+  kogmo_rtdb_objid_t oid = used_objhot_p->oid;
   int32_t history_slot;
   kogmo_rtdb_objsize_t size;
-  volatile kogmo_timestamp_t committed_ts;
-  int no_notifies;
+  volatile kogmo_timestamp_t committed_ts = now_ts;
+  int no_notifies, i;
   void *heap_data_p;
 
-  committed_ts = kogmo_rtdb_timestamp_now (db_h);
-
-  CHK_DBH("kogmo_rtdb_obj_writedata",db_h,0);
-  CHK_PTR(data_p);
-
   size = ( (kogmo_rtdb_subobj_base_t*) data_p )->size;
 
-  DBGL (DBGL_API,"kogmo_rtdb_obj_writedata(oid %i, data %p, size %i)", oid, data_p, size);
+  DBGL (DBGL_API,"kogmo_rtdb_obj_writedata(oid %i, data %p, size %i, %i patches)", oid, data_p, size, patches ? count : -1);
 
-  used_objmeta_p = kogmo_rtdb_obj_findmeta_byid (db_h, oid);
-  if ( used_objmeta_p == NULL ) return -KOGMO_RTDB_ERR_NOTFOUND;
-  if ( used_objmeta_p->buffer_idx == 0 ) return -KOGMO_RTDB_ERR_NOTFOUND;
+  if ( used_objhot_p->buffer_idx == 0 ) return -KOGMO_RTDB_ERR_NOTFOUND;
 
-  // better fail: if ( size == 0 ) size = used_objmeta_p -> size_max;
-  if ( size > used_objmeta_p->size_max ) return -KOGMO_RTDB_ERR_INVALID;
+  // better fail: if ( size == 0 ) size = used_objhot_p -> size_max;
+  if ( size > used_objhot_p->size_max ) return -KOGMO_RTDB_ERR_INVALID;
   if ( size < (int)(sizeof ( kogmo_rtdb_subobj_base_t )) ) return -KOGMO_RTDB_ERR_INVALID;
 
-  if ( !used_objmeta_p->flags.write_allow
-    && used_objmeta_p->created_proc != db_h->ipc_h.this_process.proc_oid
+  for ( i = 0; patches != NULL && i < count; i++ )
+    if ( patches[i].offset < (int)(sizeof ( kogmo_rtdb_subobj_base_t ))
+         || patches[i].len < 0 || patches[i].offset > size
+         || patches[i].len > size - patches[i].offset
+         || ( patches[i].len > 0 && patches[i].data_p == NULL ) )
+      {
+        DBGL (DBGL_MSG,"invalid patch %i for oid %d", i, oid);
+        return -KOGMO_RTDB_ERR_INVALID;
+      }
+
+  if ( !checked
+    && !used_objhot_p->flags.write_allow
+    && used_objhot_p->created_proc != db_h->ipc_h.this_process.proc_oid
     && !this_process_is_admin (db_h) )
     {
-      DBGL (DBGL_MSG,"commit permission denied for oid %d", used_objmeta_p->oid);
+      DBGL (DBGL_MSG,"commit permission denied for oid %d", used_objhot_p->oid);
       return -KOGMO_RTDB_ERR_NOPERM;
     }
 
@@ -77,48 +216,48 @@ kogmo_rtdb_obj_writedata (kogmo_rtdb_handle_t *db_h,
   ((kogmo_rtdb_subobj_base_t *) data_p)->committed_proc = db_h->ipc_h.this_process.proc_oid;
 
   // lock object, if concurrent writes are allowed
-  if ( used_objmeta_p->flags.write_allow )
-    kogmo_rtdb_obj_lock (db_h, used_objmeta_p);
+  if ( used_objhot_p->flags.write_allow )
+    kogmo_rtdb_obj_lock (db_h, used_objhot_p);
 
   //if(DEBUG)
   //  if(getenv("KOGMO_RTDB_DEBUG_TEST_BLOCKTIME_WRITE"))
   //    usleep(atof(getenv("KOGMO_RTDB_DEBUG_TEST_BLOCKTIME_WRITE"))*1000000);
 
-  if ( used_objmeta_p->flags.cycle_watch )
+  if ( used_objhot_p->flags.cycle_watch )
     {
       kogmo_rtdb_subobj_base_t *scan_objbase;
-      float min_cycle_time = MIN_CYCLETIME(used_objmeta_p->min_cycletime, used_objmeta_p->max_cycletime);
+      float min_cycle_time = MIN_CYCLETIME(used_objhot_p->min_cycletime, used_objhot_p->max_cycletime);
       // the latest data
-      scan_objbase = kogmo_rtdb_obj_histscan (db_h, 0, used_objmeta_p, NULL, NULL);
+      scan_objbase = kogmo_rtdb_obj_histscan (db_h, 0, used_objhot_p, NULL, NULL);
       if ( scan_objbase != NULL ) // there have been previous commits..
         {
           float time_since_last_commit = kogmo_timestamp_diff_secs (scan_objbase->committed_ts, committed_ts);
           DBGL (DBGL_MSG,"cycle-watch: time_since_last_commit %f < %f ?", time_since_last_commit, min_cycle_time);
           if ( time_since_last_commit < min_cycle_time )
             {
-              if ( used_objmeta_p->flags.write_allow )
-                kogmo_rtdb_obj_unlock (db_h, used_objmeta_p);
-              DBGL (DBGL_MSG,"updates too fast for oid %d: %f < %f", used_objmeta_p->oid, time_since_last_commit, min_cycle_time);
+              if ( used_objhot_p->flags.write_allow )
+                kogmo_rtdb_obj_unlock (db_h, used_objhot_p);
+              DBGL (DBGL_MSG,"updates too fast for oid %d: %f < %f", used_objhot_p->oid, time_since_last_commit, min_cycle_time);
               return -KOGMO_RTDB_ERR_TOOFAST;
             }
         }
     }
 
-  no_notifies = used_objmeta_p->flags.no_notifies | db_h->localdata_p->flags.no_notifies;
+  no_notifies = used_objhot_p->flags.no_notifies | db_h->localdata_p->flags.no_notifies;
 
-  history_slot = used_objmeta_p->history_slot;
+  history_slot = used_objhot_p->history_slot;
   if ( history_slot < 0 )
     {
       history_slot = 0;
     }
   else
     {
-      history_slot = ( history_slot + 1 ) % used_objmeta_p->history_size;
+      history_slot = ( history_slot + 1 ) % used_objhot_p->history_size;
     }
 
-  heap_data_p = &db_h->localdata_p->heap
-                  [ used_objmeta_p->buffer_idx
-                  + history_slot * used_objmeta_p->size_max ];
+  heap_data_p = &db_h->heap
+                  [ used_objhot_p->buffer_idx
+                  + history_slot * used_objhot_p->slot_stride ];
 
   // committed_ts makes an entry valid(>0) / invalid(==0)
   // 2. copy committed_ts as 0 (entry invalid)
@@ -142,7 +281,11 @@ kogmo_rtdb_obj_writedata (kogmo_rtdb_handle_t *db_h,
   COPY_INT64_HIGHFIRST( (((kogmo_rtdb_subobj_base_t *) heap_data_p)->committed_ts), invalid_ts);
 
   // 5. copy data with committed_ts==0
-  memcpy ( heap_data_p, data_p, size );
+  if ( patches == NULL )
+    kogmo_rtdb_copy ( db_h, heap_data_p, data_p, size );
+  else
+    kogmo_rtdb_obj_writedata__patch (db_h, used_objhot_p, heap_data_p,
+                                     data_p, size, patches, count);
 
   // 5b. if there is no data_ts, set it to committed_ts
   if ( ((kogmo_rtdb_subobj_base_t *) heap_data_p)->data_ts == invalid_ts )
@@ -153,21 +296,29 @@ kogmo_rtdb_obj_writedata (kogmo_rtdb_handle_t *db_h,
 
   // pre-6. block new notify-listeners unless notifies are disabled
   if ( ! no_notifies )
-    kogmo_rtdb_obj_do_notify_prepare(db_h, used_objmeta_p);
-  //DBG("obj slot: %i",kogmo_rtdb_obj_slotnum (db_h, used_objmeta_p));
+    kogmo_rtdb_obj_do_notify_prepare(db_h, used_objhot_p);
+  //DBG("obj slot: %i",kogmo_rtdb_obj_hot_slotnum (db_h, used_objhot_p));
+
+  // pre-6. get a global commit sequence number for the slot
+  kogmo_rtdb_obj_commitseq_set (db_h, used_objhot_p, history_slot);
+  COMPILER_BARRIER();
 
   // 6. make slot valid with new committed_ts
   COPY_INT64_LOWFIRST( ((kogmo_rtdb_subobj_base_t *) heap_data_p)->committed_ts, committed_ts);
 
+  // 6b. add it to the data_ts index
+  kogmo_rtdb_obj_dataidx_commit (db_h, used_objhot_p, history_slot,
+                                 ((kogmo_rtdb_subobj_base_t *) heap_data_p)->data_ts);
+
   // 7. set pointer to this slot
-  used_objmeta_p->history_slot = history_slot;
+  used_objhot_p->history_slot = history_slot;
 
-  if ( used_objmeta_p->flags.write_allow )
-    kogmo_rtdb_obj_unlock (db_h, used_objmeta_p);
+  if ( used_objhot_p->flags.write_allow )
+    kogmo_rtdb_obj_unlock (db_h, used_objhot_p);
 
   // 8. send notifies unless notifies are disabled
   if ( ! no_notifies )
-    kogmo_rtdb_obj_do_notify (db_h, used_objmeta_p);
+    kogmo_rtdb_obj_do_notify (db_h, used_objhot_p);
 
   // set my own commited_ts back to the original value
   ((kogmo_rtdb_subobj_base_t *) data_p)->committed_ts = committed_ts;
@@ -190,18 +341,61 @@ kogmo_rtdb_obj_writedata (kogmo_rtdb_handle_t *db_h,
     }
 
   kogmo_rtdb_obj_trace_send (db_h, oid, committed_ts, KOGMO_RTDB_TRACE_UPDATED,
-        kogmo_rtdb_obj_slotnum (db_h, used_objmeta_p), history_slot);
+        kogmo_rtdb_obj_hot_slotnum (db_h, used_objhot_p), history_slot);
 
   return 0;
 }
 
 
+int
+kogmo_rtdb_obj_writedata (kogmo_rtdb_handle_t *db_h,
+                       kogmo_rtdb_objid_t oid, void *data_p)
+{
+  struct kogmo_rtdb_obj_hot_t *used_objhot_p;
+  kogmo_timestamp_t committed_ts;
+
+  committed_ts = kogmo_rtdb_timestamp_now (db_h);
+
+  CHK_DBH("kogmo_rtdb_obj_writedata",db_h,0);
+  CHK_PTR(data_p);
+
+  used_objhot_p = kogmo_rtdb_obj_findhot_byid (db_h, oid);
+  if ( used_objhot_p == NULL ) return -KOGMO_RTDB_ERR_NOTFOUND;
+
+  return kogmo_rtdb_obj_writedata__hot (db_h, used_objhot_p, 0, data_p, committed_ts, NULL, 0);
+}
+
+
+int
+kogmo_rtdb_obj_writedata_delta (kogmo_rtdb_handle_t *db_h,
+                                kogmo_rtdb_objid_t oid, void *data_p,
+                                _const kogmo_rtdb_obj_patch_t *patches, int count)
+{
+  struct kogmo_rtdb_obj_hot_t *used_objhot_p;
+  kogmo_timestamp_t committed_ts;
+
+  committed_ts = kogmo_rtdb_timestamp_now (db_h);
+
+  CHK_DBH("kogmo_rtdb_obj_writedata_delta",db_h,0);
+  CHK_PTR(data_p);
+  CHK_PTR(patches);
+
+  if ( count < 0 ) return -KOGMO_RTDB_ERR_INVALID;
+
+  used_objhot_p = kogmo_rtdb_obj_findhot_byid (db_h, oid);
+  if ( used_objhot_p == NULL ) return -KOGMO_RTDB_ERR_NOTFOUND;
+
+  return kogmo_rtdb_obj_writedata__hot (db_h, used_objhot_p, 0, data_p, committed_ts,
+                                        patches, count);
+}
+
+
 int
 kogmo_rtdb_obj_writedata_ptr_begin (kogmo_rtdb_handle_t *db_h,
                                     kogmo_rtdb_objid_t oid,
                                     void *data_pp)
 {
-  kogmo_rtdb_obj_info_t *used_objmeta_p;
+  struct kogmo_rtdb_obj_hot_t *used_objhot_p;
   int32_t history_slot;
   void *heap_data_p;
 
@@ -210,30 +404,30 @@ kogmo_rtdb_obj_writedata_ptr_begin (kogmo_rtdb_handle_t *db_h,
 
   DBGL (DBGL_API,"kogmo_rtdb_obj_writedata_ptr_begin(oid %i, data* %p)", oid, data_pp);
 
-  used_objmeta_p = kogmo_rtdb_obj_findmeta_byid (db_h, oid);
-  if ( used_objmeta_p == NULL ) return -KOGMO_RTDB_ERR_NOTFOUND;
-  if ( used_objmeta_p->buffer_idx == 0 ) return -KOGMO_RTDB_ERR_NOTFOUND;
+  used_objhot_p = kogmo_rtdb_obj_findhot_byid (db_h, oid);
+  if ( used_objhot_p == NULL ) return -KOGMO_RTDB_ERR_NOTFOUND;
+  if ( used_objhot_p->buffer_idx == 0 ) return -KOGMO_RTDB_ERR_NOTFOUND;
 
-  if ( used_objmeta_p->flags.write_allow
-    || used_objmeta_p->created_proc != db_h->ipc_h.this_process.proc_oid )
+  if ( used_objhot_p->flags.write_allow
+    || used_objhot_p->created_proc != db_h->ipc_h.this_process.proc_oid )
     {
       DBGL (DBGL_MSG,"no ptr-write for public or others objects");
       return -KOGMO_RTDB_ERR_INVALID;
     }
 
-  history_slot = used_objmeta_p->history_slot;
+  history_slot = used_objhot_p->history_slot;
   if ( history_slot < 0 )
     {
       history_slot = 0;
     }
   else
     {
-      history_slot = ( history_slot + 1 ) % used_objmeta_p->history_size;
+      history_slot = ( history_slot + 1 ) % used_objhot_p->history_size;
     }
 
-  heap_data_p = &db_h->localdata_p->heap
-                  [ used_objmeta_p->buffer_idx
-                  + history_slot * used_objmeta_p->size_max ];
+  heap_data_p = &db_h->heap
+                  [ used_objhot_p->buffer_idx
+                  + history_slot * used_objhot_p->slot_stride ];
 
   // make slot invalid
   COPY_INT64_HIGHFIRST( ((kogmo_rtdb_subobj_base_t *) heap_data_p)->committed_ts, invalid_ts);
@@ -250,7 +444,7 @@ kogmo_rtdb_obj_writedata_ptr_commit (kogmo_rtdb_handle_t *db_h,
                                     kogmo_rtdb_objid_t oid,
                                     void *data_pp)
 {
-  kogmo_rtdb_obj_info_t *used_objmeta_p;
+  struct kogmo_rtdb_obj_hot_t *used_objhot_p;
   int32_t history_slot;
   kogmo_rtdb_objsize_t size;
   volatile kogmo_timestamp_t committed_ts;
@@ -266,53 +460,53 @@ kogmo_rtdb_obj_writedata_ptr_commit (kogmo_rtdb_handle_t *db_h,
 
   DBGL (DBGL_API,"kogmo_rtdb_obj_writedata_ptr_commit(oid %i, data* %p, size %i)", oid, data_pp, size);
 
-  used_objmeta_p = kogmo_rtdb_obj_findmeta_byid (db_h, oid);
-  if ( used_objmeta_p == NULL ) return -KOGMO_RTDB_ERR_NOTFOUND;
-  if ( used_objmeta_p->buffer_idx == 0 ) return -KOGMO_RTDB_ERR_NOTFOUND;
+  used_objhot_p = kogmo_rtdb_obj_findhot_byid (db_h, oid);
+  if ( used_objhot_p == NULL ) return -KOGMO_RTDB_ERR_NOTFOUND;
+  if ( used_objhot_p->buffer_idx == 0 ) return -KOGMO_RTDB_ERR_NOTFOUND;
 
-  if ( size > used_objmeta_p->size_max ) return -KOGMO_RTDB_ERR_INVALID;
+  if ( size > used_objhot_p->size_max ) return -KOGMO_RTDB_ERR_INVALID;
   if ( size < (int)(sizeof ( kogmo_rtdb_subobj_base_t )) ) return -KOGMO_RTDB_ERR_INVALID;
 
-  if ( used_objmeta_p->flags.write_allow
-    || used_objmeta_p->created_proc != db_h->ipc_h.this_process.proc_oid )
+  if ( used_objhot_p->flags.write_allow
+    || used_objhot_p->created_proc != db_h->ipc_h.this_process.proc_oid )
     {
       DBGL (DBGL_MSG,"no ptr-write for public or others objects");
       return -KOGMO_RTDB_ERR_INVALID;
     }
 
-  if ( used_objmeta_p->flags.cycle_watch )
+  if ( used_objhot_p->flags.cycle_watch )
     {
       kogmo_rtdb_subobj_base_t *scan_objbase;
-      float min_cycle_time = MIN_CYCLETIME(used_objmeta_p->min_cycletime, used_objmeta_p->max_cycletime);
+      float min_cycle_time = MIN_CYCLETIME(used_objhot_p->min_cycletime, used_objhot_p->max_cycletime);
       // the latest data
-      scan_objbase = kogmo_rtdb_obj_histscan (db_h, 0, used_objmeta_p, NULL, NULL);
+      scan_objbase = kogmo_rtdb_obj_histscan (db_h, 0, used_objhot_p, NULL, NULL);
       if ( scan_objbase != NULL ) // there have been previous commits..
         {
           float time_since_last_commit = kogmo_timestamp_diff_secs (scan_objbase->committed_ts, committed_ts);
           DBGL (DBGL_MSG,"cycle-watch: time_since_last_commit %f < %f ?", time_since_last_commit, min_cycle_time);
           if ( time_since_last_commit < min_cycle_time )
             {
-              DBGL (DBGL_MSG,"updates too fast for oid %d: %f < %f", used_objmeta_p->oid, time_since_last_commit, min_cycle_time);
+              DBGL (DBGL_MSG,"updates too fast for oid %d: %f < %f", used_objhot_p->oid, time_since_last_commit, min_cycle_time);
               return -KOGMO_RTDB_ERR_TOOFAST;
             }
         }
     }
 
-  no_notifies = used_objmeta_p->flags.no_notifies | db_h->localdata_p->flags.no_notifies;
+  no_notifies = used_objhot_p->flags.no_notifies | db_h->localdata_p->flags.no_notifies;
 
-  history_slot = used_objmeta_p->history_slot;
+  history_slot = used_objhot_p->history_slot;
   if ( history_slot < 0 )
     {
       history_slot = 0;
     }
   else
     {
-      history_slot = ( history_slot + 1 ) % used_objmeta_p->history_size;
+      history_slot = ( history_slot + 1 ) % used_objhot_p->history_size;
     }
 
-  heap_data_p = &db_h->localdata_p->heap
-                  [ used_objmeta_p->buffer_idx
-                  + history_slot * used_objmeta_p->size_max ];
+  heap_data_p = &db_h->heap
+                  [ used_objhot_p->buffer_idx
+                  + history_slot * used_objhot_p->slot_stride ];
 
   if ( *(kogmo_rtdb_subobj_base_t**) data_pp != heap_data_p )
     {
@@ -329,17 +523,25 @@ kogmo_rtdb_obj_writedata_ptr_commit (kogmo_rtdb_handle_t *db_h,
 
   // pre-6. block new notify-listeners unless notifies are disabled
   if ( ! no_notifies )
-    kogmo_rtdb_obj_do_notify_prepare(db_h, used_objmeta_p);
+    kogmo_rtdb_obj_do_notify_prepare(db_h, used_objhot_p);
+
+  // pre-6. get a global commit sequence number for the slot
+  kogmo_rtdb_obj_commitseq_set (db_h, used_objhot_p, history_slot);
+  COMPILER_BARRIER();
 
   // 6. make slot valid with new committed_ts
   COPY_INT64_LOWFIRST( ((kogmo_rtdb_subobj_base_t *) heap_data_p)->committed_ts, committed_ts);
 
+  // 6b. add it to the data_ts index
+  kogmo_rtdb_obj_dataidx_commit (db_h, used_objhot_p, history_slot,
+                                 ((kogmo_rtdb_subobj_base_t *) heap_data_p)->data_ts);
+
   // 7. set pointer to this slot
-  used_objmeta_p->history_slot = history_slot;
+  used_objhot_p->history_slot = history_slot;
 
   // 8. send notifies unless notifies are disabled
   if ( ! no_notifies )
-    kogmo_rtdb_obj_do_notify (db_h, used_objmeta_p);
+    kogmo_rtdb_obj_do_notify (db_h, used_objhot_p);
 
   DBGL (DBGL_API,"obj_ptr-committed oid %i into slot %i with %i bytes at ts=%lli",
         oid, history_slot, size, (long long int)committed_ts);
@@ -359,7 +561,7 @@ kogmo_rtdb_obj_writedata_ptr_commit (kogmo_rtdb_handle_t *db_h,
     }
 
   kogmo_rtdb_obj_trace_send (db_h, oid, committed_ts, KOGMO_RTDB_TRACE_UPDATED,
-        kogmo_rtdb_obj_slotnum (db_h, used_objmeta_p), history_slot);
+        kogmo_rtdb_obj_hot_slotnum (db_h, used_objhot_p), history_slot);
 
   return 0;
 }
@@ -379,7 +581,7 @@ kogmo_rtdb_obj_writedata_ptr_commit (kogmo_rtdb_handle_t *db_h,
  */
 inline static void *
 kogmo_rtdb_obj_histscan (kogmo_rtdb_handle_t *db_h, int32_t adj,
-                         kogmo_rtdb_obj_info_t *scan_objmeta_p,
+                         struct kogmo_rtdb_obj_hot_t *scan_objhot_p,
                          int32_t *currslot_p2, int32_t *firstslot_p)
 {
   kogmo_rtdb_subobj_base_t *objbase;
@@ -387,7 +589,7 @@ kogmo_rtdb_obj_histscan (kogmo_rtdb_handle_t *db_h, int32_t adj,
   int32_t *currslot_p; // = currslot_p2 ? currslot_p2 : &currslot_tmp;
   //xDBG("histscan: request: adj:%i, curr:%i last:%i",adj,xx*currslot_p,xx*firstslot_p);
 
-  if ( scan_objmeta_p->history_size == 0)
+  if ( scan_objhot_p->history_size == 0)
     return NULL;
 
   if ( currslot_p2 )
@@ -397,13 +599,13 @@ kogmo_rtdb_obj_histscan (kogmo_rtdb_handle_t *db_h, int32_t adj,
   else
     {
       currslot_p = &currslot_tmp;
-      *currslot_p = scan_objmeta_p->history_slot;
+      *currslot_p = scan_objhot_p->history_slot;
     }
 
   if ( adj == 0 )
     {
       // get current slot = the latest data
-      *currslot_p = scan_objmeta_p->history_slot;
+      *currslot_p = scan_objhot_p->history_slot;
       if ( firstslot_p )
         *firstslot_p = *currslot_p;
     }
@@ -416,7 +618,7 @@ kogmo_rtdb_obj_histscan (kogmo_rtdb_handle_t *db_h, int32_t adj,
     return NULL;
 
   // calculate next slot position
-  *currslot_p = (*currslot_p + scan_objmeta_p->history_size ) % scan_objmeta_p->history_size;
+  *currslot_p = (*currslot_p + scan_objhot_p->history_size ) % scan_objhot_p->history_size;
   //xDBG("histscan: calculated next slot: %i",*currslot_p);
 
   // wrap-around check
@@ -428,9 +630,9 @@ kogmo_rtdb_obj_histscan (kogmo_rtdb_handle_t *db_h, int32_t adj,
 
   // calculate object data pointer from history slot number
   objbase = (kogmo_rtdb_subobj_base_t *)
-             & ( db_h->localdata_p->heap [
-                                             scan_objmeta_p->buffer_idx +
-                                             *currslot_p * scan_objmeta_p->size_max
+             & ( db_h->heap [
+                                             scan_objhot_p->buffer_idx +
+                                             *currslot_p * scan_objhot_p->slot_stride
                                            ] );
 
   if ( CMP_INT64_HIGH(objbase->committed_ts, invalid_ts) )
@@ -444,6 +646,97 @@ kogmo_rtdb_obj_histscan (kogmo_rtdb_handle_t *db_h, int32_t adj,
 }
 
 
+// internal: data of the history entry with the given age (0 = the latest
+// at latest_slot)
+inline static kogmo_rtdb_subobj_base_t *
+kogmo_rtdb_obj_histslot (kogmo_rtdb_handle_t *db_h,
+                         struct kogmo_rtdb_obj_hot_t *scan_objhot_p,
+                         int32_t latest_slot, int32_t age)
+{
+  int32_t slot = ( latest_slot - age + scan_objhot_p->history_size ) % scan_objhot_p->history_size;
+  return (kogmo_rtdb_subobj_base_t *)
+           & ( db_h->heap [ scan_objhot_p->buffer_idx + slot * scan_objhot_p->slot_stride ] );
+}
+
+#define HISTSEARCH_RETRIES 3
+
+// internal: find the latest history entry with committed_ts <= ts.
+// the commit timestamps decrease with the age of the entries, so this is an
+// exponential search from the latest entry followed by a binary search.
+// the oldest entry is the next one to be overwritten, a commit may already
+// have made it the latest before history_slot changed, so it is checked
+// separately. history_slot works as sequence number: if it changed during
+// the search, the search is repeated.
+// returns the age of the entry (0 = the latest, its slot in *latest_slot_p),
+// history_size if there is none, or -1 if the history changed too often,
+// then the caller has to scan linearly.
+// an entry without data (committed_ts==0) counts as older than ts,
+// the caller has to check this.
+inline static int32_t
+kogmo_rtdb_obj_histsearch (kogmo_rtdb_handle_t *db_h,
+                           struct kogmo_rtdb_obj_hot_t *scan_objhot_p,
+                           kogmo_timestamp_t ts, int32_t *latest_slot_p)
+{
+  int32_t size = scan_objhot_p->history_size;
+  int32_t latest, lo, hi, mid, tries;
+  volatile kogmo_timestamp_t scan_ts, next_ts;
+
+  if ( size == 0 )
+    return -1;
+
+  for ( tries = 0; tries < HISTSEARCH_RETRIES; tries++ )
+    {
+      latest = *(volatile int32_t *) &scan_objhot_p->history_slot;
+      if ( latest < 0 )
+        return size; // no writes yet
+
+      // find a range [lo,hi] that contains the result,
+      // hi = size-1 means that it is not within the younger entries
+      lo = 0;
+      hi = 1;
+      while ( hi < size - 1 )
+        {
+          COPY_INT64_HIGHFIRST( scan_ts, kogmo_rtdb_obj_histslot (db_h, scan_objhot_p, latest, hi)->committed_ts );
+          if ( scan_ts <= ts )
+            break;
+          lo = hi + 1;
+          hi = hi * 2;
+        }
+      if ( hi > size - 1 )
+        hi = size - 1;
+
+      while ( lo < hi )
+        {
+          mid = lo + ( hi - lo ) / 2;
+          COPY_INT64_HIGHFIRST( scan_ts, kogmo_rtdb_obj_histslot (db_h, scan_objhot_p, latest, mid)->committed_ts );
+          if ( scan_ts <= ts )
+            hi = mid;
+          else
+            lo = mid + 1;
+        }
+
+      if ( lo == size - 1 )
+        {
+          // the oldest entry is valid if it is still older than its successor
+          COPY_INT64_HIGHFIRST( scan_ts, kogmo_rtdb_obj_histslot (db_h, scan_objhot_p, latest, lo)->committed_ts );
+          if ( size > 1 )
+            COPY_INT64_HIGHFIRST( next_ts, kogmo_rtdb_obj_histslot (db_h, scan_objhot_p, latest, lo - 1)->committed_ts );
+          if ( scan_ts == invalid_ts || scan_ts > ts || ( size > 1 && scan_ts > next_ts ) )
+            lo = size;
+        }
+
+      if ( *(volatile int32_t *) &scan_objhot_p->history_slot == latest )
+        {
+          *latest_slot_p = latest;
+          return lo;
+        }
+      DBG("histsearch: new commits during search, retrying");
+    }
+
+  return -1;
+}
+
+
 inline static kogmo_rtdb_objsize_t
 kogmo_rtdb_obj_readdata__mode (kogmo_rtdb_handle_t *db_h, int mode,
                              kogmo_rtdb_objid_t oid, kogmo_timestamp_t ts,
@@ -565,20 +858,221 @@ kogmo_rtdb_obj_readdata_datayounger_ptr (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_o
 }
 
 
+// guarded pointer reads: begin remembers the commit timestamp of the slot,
+// end checks that it is unchanged, because a writer invalidates it before
+// touching the data (see kogmo_rtdb_obj_writedata__hot())
+
+kogmo_rtdb_objsize_t
+kogmo_rtdb_obj_readdata_ptr_begin (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objid_t oid,
+                                   kogmo_timestamp_t ts, void *data_pp,
+                                   kogmo_timestamp_t *committed_ts_p)
+{
+  kogmo_rtdb_subobj_base_t *scan_objbase;
+  volatile kogmo_timestamp_t scan_ts;
+  kogmo_rtdb_objsize_t err;
+
+  CHK_DBH("kogmo_rtdb_obj_readdata_ptr_begin",db_h,0);
+  CHK_PTR(data_pp);
+  CHK_PTR(committed_ts_p);
+
+  err = kogmo_rtdb_obj_readdata__mode (db_h, RTDBSEL_LAST | RTDBSEL_PTR, oid, ts, &scan_objbase, 0);
+  if ( err < 0 )
+    return err;
+
+  COPY_INT64_HIGHFIRST( scan_ts, scan_objbase->committed_ts );
+  COMPILER_BARRIER();
+  if ( scan_ts == invalid_ts || ( ts != invalid_ts && scan_ts > ts ) )
+    return -KOGMO_RTDB_ERR_HISTWRAP; // being overwritten right now
+
+  *(kogmo_rtdb_subobj_base_t**)data_pp = scan_objbase;
+  *committed_ts_p = scan_ts;
+  return err;
+}
+
+int
+kogmo_rtdb_obj_readdata_ptr_end (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objid_t oid,
+                                 void *data_pp, kogmo_timestamp_t committed_ts)
+{
+  struct kogmo_rtdb_obj_hot_t *scan_objhot_p;
+  kogmo_rtdb_subobj_base_t *scan_objbase;
+  volatile kogmo_timestamp_t final_ts;
+  long int offset;
+
+  CHK_DBH("kogmo_rtdb_obj_readdata_ptr_end",db_h,0);
+  CHK_PTR(data_pp);
+
+  scan_objbase = *(kogmo_rtdb_subobj_base_t**)data_pp;
+  scan_objhot_p = kogmo_rtdb_obj_findhot_byid (db_h, oid);
+  if ( scan_objhot_p == NULL || scan_objhot_p->buffer_idx == 0 )
+    return -KOGMO_RTDB_ERR_NOTFOUND;
+
+  // only accept pointers to a slot of this object
+  offset = (char*) scan_objbase - &db_h->heap[scan_objhot_p->buffer_idx];
+  if ( offset < 0 || offset >= (long int) scan_objhot_p->history_size * scan_objhot_p->slot_stride
+       || offset % scan_objhot_p->slot_stride != 0 )
+    return -KOGMO_RTDB_ERR_INVALID;
+
+  // all reads of the data must be done before
+  COMPILER_BARRIER();
+  COPY_INT64_LOWFIRST( final_ts, scan_objbase->committed_ts );
+  if ( final_ts != committed_ts )
+    {
+      DBG("readdata_ptr_end: history wrap-around! now %lli, should have been %lli", (long long int)final_ts, (long long int)committed_ts);
+      return -KOGMO_RTDB_ERR_HISTWRAP;
+    }
+  return 0;
+}
+
+kogmo_rtdb_objsize_t
+kogmo_rtdb_obj_readdata_range (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objid_t oid,
+                               kogmo_timestamp_t ts,
+                               kogmo_rtdb_objsize_t offset, kogmo_rtdb_objsize_t len,
+                               void *data_p)
+{
+  kogmo_rtdb_subobj_base_t *scan_objbase;
+  volatile kogmo_timestamp_t scan_ts, final_ts;
+  kogmo_rtdb_objsize_t real_size, err;
+
+  CHK_DBH("kogmo_rtdb_obj_readdata_range",db_h,0);
+  CHK_PTR(data_p);
+
+  if ( offset < 0 || len < 0 )
+    return -KOGMO_RTDB_ERR_INVALID;
+
+  err = kogmo_rtdb_obj_readdata__mode (db_h, RTDBSEL_LAST | RTDBSEL_PTR, oid, ts, &scan_objbase, 0);
+  if ( err < 0 )
+    return err;
+
+  COPY_INT64_HIGHFIRST( scan_ts, scan_objbase->committed_ts );
+  COMPILER_BARRIER();
+  if ( scan_ts == invalid_ts || ( ts != invalid_ts && scan_ts > ts ) )
+    return -KOGMO_RTDB_ERR_HISTWRAP; // being overwritten right now
+
+  // the header, then the part of the range within the real data
+  real_size = scan_objbase->size;
+  memcpy ( data_p, scan_objbase, sizeof (kogmo_rtdb_subobj_base_t) );
+  if ( offset < (kogmo_rtdb_objsize_t) sizeof (kogmo_rtdb_subobj_base_t) )
+    {
+      len = len > (kogmo_rtdb_objsize_t) sizeof (kogmo_rtdb_subobj_base_t) - offset ?
+            len - ( (kogmo_rtdb_objsize_t) sizeof (kogmo_rtdb_subobj_base_t) - offset ) : 0;
+      offset = sizeof (kogmo_rtdb_subobj_base_t);
+    }
+  // offset+len could overflow
+  if ( offset >= real_size )
+    len = 0;
+  else if ( len > real_size - offset )
+    len = real_size - offset;
+  if ( len > 0 )
+    kogmo_rtdb_copy ( db_h, (char*) data_p + offset, (char*) scan_objbase + offset, len );
+  // like readdata: the size must not exceed the buffer
+  ( (kogmo_rtdb_subobj_base_t*) data_p )->size = len > 0 ? offset + len
+                                                 : (kogmo_rtdb_objsize_t) sizeof (kogmo_rtdb_subobj_base_t);
+
+  COPY_INT64_LOWFIRST( final_ts, scan_objbase->committed_ts );
+  ((kogmo_rtdb_subobj_base_t *) data_p)->committed_ts = final_ts;
+
+  if ( final_ts != scan_ts )
+    {
+      DBG("readdata_range: history wrap-around! now %lli, should have been %lli", (long long int)final_ts, (long long int)scan_ts);
+      return -KOGMO_RTDB_ERR_HISTWRAP;
+    }
+
+  return real_size;
+}
+
+
+
+#define DATAIDX_RETRIES 3
+
+// internal: find the data for a data time read (RTDBSEL_DATATIME, _DATAOLDER,
+// _DATAYOUNGER) in the data_ts index of an object.
+// returns 0 and the data with its committed_ts and data_ts if found,
+// 1 if the object has no index or it changed too often (the caller has
+// to scan the history), or an error.
+inline static int
+kogmo_rtdb_obj_dataidx_find (kogmo_rtdb_handle_t *db_h,
+                             struct kogmo_rtdb_obj_hot_t *scan_objhot_p,
+                             int mode, kogmo_timestamp_t ts,
+                             kogmo_rtdb_subobj_base_t **scan_objbase_p,
+                             volatile kogmo_timestamp_t *scan_ts_p,
+                             volatile kogmo_timestamp_t *scan_data_ts_p)
+{
+  struct kogmo_rtdb_obj_dataidx_t *idx_p;
+  kogmo_rtdb_subobj_base_t *scan_objbase;
+  int32_t size = scan_objhot_p->history_size;
+  int32_t count, pos, slot = -1, tries;
+  uint32_t seq;
+  kogmo_timestamp_t data_ts = 0;
+
+  idx_p = kogmo_rtdb_obj_dataidx (db_h, scan_objhot_p);
+  if ( idx_p == NULL )
+    return 1;
+
+  for ( tries = 0; tries < DATAIDX_RETRIES; tries++ )
+    {
+      seq = idx_p->seq;
+      if ( seq & 1 )
+        continue; // commit in progress
+      COMPILER_BARRIER();
+      count = idx_p->count;
+      if ( count > size )
+        continue;
+      switch ( mode )
+        {
+          case RTDBSEL_DATATIME:
+            pos = kogmo_rtdb_obj_dataidx_bound (idx_p, size, count, ts, 1) - 1;
+            break;
+          case RTDBSEL_DATAOLDER:
+            pos = kogmo_rtdb_obj_dataidx_bound (idx_p, size, count, ts, 0) - 1;
+            break;
+          default: // RTDBSEL_DATAYOUNGER
+            pos = kogmo_rtdb_obj_dataidx_bound (idx_p, size, count, ts, 1);
+        }
+      slot = -1;
+      if ( pos >= 0 && pos < count )
+        {
+          slot = DATAIDX_ENTRY (idx_p, size, pos)->slot;
+          data_ts = DATAIDX_ENTRY (idx_p, size, pos)->data_ts;
+        }
+      COMPILER_BARRIER();
+      if ( idx_p->seq == seq )
+        break;
+    }
+  if ( tries >= DATAIDX_RETRIES )
+    {
+      DBG("dataidx: index changed during lookup, scanning");
+      return 1;
+    }
+  if ( slot < 0 || slot >= size )
+    return -KOGMO_RTDB_ERR_NOTFOUND;
+
+  scan_objbase = (kogmo_rtdb_subobj_base_t *)
+                   & ( db_h->heap [ scan_objhot_p->buffer_idx + slot * scan_objhot_p->slot_stride ] );
+  COPY_INT64_HIGHFIRST( *scan_ts_p, scan_objbase->committed_ts );
+  COPY_INT64_HIGHFIRST( *scan_data_ts_p, scan_objbase->data_ts );
+  if ( *scan_ts_p == invalid_ts || *scan_data_ts_p != data_ts )
+    return -KOGMO_RTDB_ERR_HISTWRAP; // overwritten meanwhile
+  *scan_objbase_p = scan_objbase;
+  return 0;
+}
+
 
+// internal: read data of an object that has already been looked up,
+// checked!=0 means that the read permission has been checked at bind time
 inline static kogmo_rtdb_objsize_t
-kogmo_rtdb_obj_readdata__mode (kogmo_rtdb_handle_t *db_h, int mode,
-                       kogmo_rtdb_objid_t oid, kogmo_timestamp_t ts,
+kogmo_rtdb_obj_readdata__hot (kogmo_rtdb_handle_t *db_h, int mode,
+                       struct kogmo_rtdb_obj_hot_t *scan_objhot_p, int checked,
+                       kogmo_timestamp_t ts,
                        void *data_p, kogmo_rtdb_objsize_t size)
 {
-  kogmo_rtdb_obj_info_t *scan_objmeta_p;
   kogmo_rtdb_subobj_base_t *scan_objbase,*next_scan_objbase;
   volatile kogmo_timestamp_t scan_ts=0,next_scan_ts=0,scan_data_ts=0,next_scan_data_ts=0,final_ts=0;
   kogmo_rtdb_objsize_t avail_size;
   int32_t sl=0,fsl=0; // state for kogmo_rtdb_obj_histscan()
-
-  CHK_DBH("kogmo_rtdb_obj_readdata_(...)",db_h,0);
-  CHK_PTR(data_p);
+  int32_t age, latest_slot; // result of kogmo_rtdb_obj_histsearch()
+  int err;
+  kogmo_rtdb_subobj_base_t *hist_objbase;
+  volatile kogmo_timestamp_t hist_ts=0,hist_next_ts=0;
 
   IFDBGL (DBGL_API)
     {
@@ -586,28 +1080,27 @@ kogmo_rtdb_obj_readdata__mode (kogmo_rtdb_handle_t *db_h, int mode,
       if (ts)
         kogmo_timestamp_to_string(ts, tstr);
       DBGL (DBGL_API,"obj_readdata_%i(oid %i, %s, %p, size %i)",
-            mode, oid, ts ? tstr : "0", data_p, size);
+            mode, scan_objhot_p->oid, ts ? tstr : "0", data_p, size);
     }
 
-  scan_objmeta_p = kogmo_rtdb_obj_findmeta_byid (db_h, oid);
-  if ( scan_objmeta_p == NULL ) return -KOGMO_RTDB_ERR_NOTFOUND;
-  if ( scan_objmeta_p->buffer_idx == 0 ) return -KOGMO_RTDB_ERR_NOTFOUND;
-  if ( scan_objmeta_p->flags.read_deny
-    && scan_objmeta_p->created_proc != db_h->ipc_h.this_process.proc_oid
+  if ( scan_objhot_p->buffer_idx == 0 ) return -KOGMO_RTDB_ERR_NOTFOUND;
+  if ( !checked
+    && scan_objhot_p->flags.read_deny
+    && scan_objhot_p->created_proc != db_h->ipc_h.this_process.proc_oid
     && !this_process_is_admin (db_h) )
     {
-      DBGL (DBGL_MSG,"read permission denied for oid %d", scan_objmeta_p ->oid);
+      DBGL (DBGL_MSG,"read permission denied for oid %d", scan_objhot_p ->oid);
       return -KOGMO_RTDB_ERR_NOPERM;
     }
 
   // the latest data
-  scan_objbase = kogmo_rtdb_obj_histscan (db_h, 0, scan_objmeta_p, &sl, &fsl);
+  scan_objbase = kogmo_rtdb_obj_histscan (db_h, 0, scan_objhot_p, &sl, &fsl);
   //xDBG("(1)selected slot %i, max %i",sl,fsl);
   if ( scan_objbase == NULL ) return -KOGMO_RTDB_ERR_NOTFOUND;
 
   switch (mode & RTDBSEL_MASK_TIME) {
     case RTDBSEL_LAST:
-      if ( ts == invalid_ts && scan_objmeta_p->deleted_ts != invalid_ts )
+      if ( ts == invalid_ts && scan_objhot_p->deleted_ts != invalid_ts )
         {
           DBG("object now deleted");
           return -KOGMO_RTDB_ERR_NOTFOUND;
@@ -615,10 +1108,26 @@ kogmo_rtdb_obj_readdata__mode (kogmo_rtdb_handle_t *db_h, int mode,
       COPY_INT64_HIGHFIRST( scan_ts, scan_objbase->committed_ts );
       DBG("scan: find latest for ts=%lli (first: %lli)",(long long int)ts,(long long int)scan_ts);
       if ( ts == invalid_ts ) break; // search for ts==0 means latest data
+      if ( scan_ts > ts )
+        {
+          age = kogmo_rtdb_obj_histsearch (db_h, scan_objhot_p, ts, &latest_slot);
+          if ( age >= scan_objhot_p->history_size )
+            return -KOGMO_RTDB_ERR_NOTFOUND;
+          if ( age >= 0 )
+            {
+              scan_objbase = kogmo_rtdb_obj_histslot (db_h, scan_objhot_p, latest_slot, age);
+              COPY_INT64_HIGHFIRST( scan_ts, scan_objbase->committed_ts );
+              if ( scan_ts == invalid_ts )
+                return -KOGMO_RTDB_ERR_NOTFOUND;
+              if ( scan_ts > ts )
+                return -KOGMO_RTDB_ERR_HISTWRAP; // overwritten meanwhile
+              break;
+            }
+        }
       while ( scan_ts > ts  )
         {
           DBG("scan: still %lli > %lli ", (long long int)scan_ts, (long long int)ts);
-          scan_objbase = kogmo_rtdb_obj_histscan (db_h, -1, scan_objmeta_p, &sl, &fsl);
+          scan_objbase = kogmo_rtdb_obj_histscan (db_h, -1, scan_objhot_p, &sl, &fsl);
           if ( scan_objbase != NULL )
             {
               COPY_INT64_HIGHFIRST( scan_ts, scan_objbase->committed_ts );
@@ -633,10 +1142,26 @@ kogmo_rtdb_obj_readdata__mode (kogmo_rtdb_handle_t *db_h, int mode,
     case RTDBSEL_OLDER:
       COPY_INT64_HIGHFIRST( scan_ts, scan_objbase->committed_ts );
       DBG("scan: find older for ts=%lli (first: %lli)",(long long int)ts,(long long int)scan_ts);
+      if ( scan_ts >= ts )
+        {
+          age = kogmo_rtdb_obj_histsearch (db_h, scan_objhot_p, ts - 1, &latest_slot);
+          if ( age >= scan_objhot_p->history_size )
+            return -KOGMO_RTDB_ERR_NOTFOUND;
+          if ( age >= 0 )
+            {
+              scan_objbase = kogmo_rtdb_obj_histslot (db_h, scan_objhot_p, latest_slot, age);
+              COPY_INT64_HIGHFIRST( scan_ts, scan_objbase->committed_ts );
+              if ( scan_ts == invalid_ts )
+                return -KOGMO_RTDB_ERR_NOTFOUND;
+              if ( scan_ts >= ts )
+                return -KOGMO_RTDB_ERR_HISTWRAP; // overwritten meanwhile
+              break;
+            }
+        }
       while ( scan_ts >= ts  )
         {
           DBG("scan: still %lli > %lli ", (long long int)scan_ts, (long long int)ts);
-          scan_objbase = kogmo_rtdb_obj_histscan (db_h, -1, scan_objmeta_p, &sl, &fsl);
+          scan_objbase = kogmo_rtdb_obj_histscan (db_h, -1, scan_objhot_p, &sl, &fsl);
           if ( scan_objbase != NULL )
             {
               COPY_INT64_HIGHFIRST( scan_ts, scan_objbase->committed_ts);
@@ -658,12 +1183,33 @@ kogmo_rtdb_obj_readdata__mode (kogmo_rtdb_handle_t *db_h, int mode,
           DBG("scan: eod");
           return -KOGMO_RTDB_ERR_NOTFOUND;
         }
+      // the oldest entry that is younger than ts is the one before the latest
+      // entry that is not, or the oldest valid entry
+      age = kogmo_rtdb_obj_histsearch (db_h, scan_objhot_p, ts, &latest_slot);
+      if ( age >= scan_objhot_p->history_size && scan_objhot_p->history_size > 1 )
+        {
+          // the oldest entry is valid if it is still older than its successor
+          hist_objbase = kogmo_rtdb_obj_histslot (db_h, scan_objhot_p, latest_slot, age - 1);
+          COPY_INT64_HIGHFIRST( hist_ts, hist_objbase->committed_ts );
+          hist_objbase = kogmo_rtdb_obj_histslot (db_h, scan_objhot_p, latest_slot, age - 2);
+          COPY_INT64_HIGHFIRST( hist_next_ts, hist_objbase->committed_ts );
+          if ( hist_ts == invalid_ts || hist_ts > hist_next_ts )
+            age--;
+        }
+      if ( age > 0 )
+        {
+          scan_objbase = kogmo_rtdb_obj_histslot (db_h, scan_objhot_p, latest_slot, age - 1);
+          COPY_INT64_HIGHFIRST( scan_ts, scan_objbase->committed_ts );
+          if ( scan_ts <= ts )
+            return -KOGMO_RTDB_ERR_HISTWRAP; // overwritten meanwhile
+          break;
+        }
       while ( next_scan_ts > ts  )
         {
           DBG("scan: still %lli > %lli ", (long long int)scan_ts, (long long int)ts);
           scan_objbase = next_scan_objbase;
           scan_ts = next_scan_ts;
-          next_scan_objbase = kogmo_rtdb_obj_histscan (db_h, -1, scan_objmeta_p, &sl, &fsl);
+          next_scan_objbase = kogmo_rtdb_obj_histscan (db_h, -1, scan_objhot_p, &sl, &fsl);
           if ( next_scan_objbase != NULL )
             {
               COPY_INT64_HIGHFIRST( next_scan_ts, next_scan_objbase->committed_ts);
@@ -675,13 +1221,20 @@ kogmo_rtdb_obj_readdata__mode (kogmo_rtdb_handle_t *db_h, int mode,
         }
       break;
     case RTDBSEL_DATATIME:
+      err = kogmo_rtdb_obj_dataidx_find (db_h, scan_objhot_p, RTDBSEL_DATATIME, ts,
+                                         &scan_objbase, &scan_ts, &scan_data_ts);
+      if ( err <= 0 )
+        {
+          if ( err < 0 ) return err;
+          break;
+        }
       COPY_INT64_HIGHFIRST( scan_ts, scan_objbase->committed_ts );
       COPY_INT64_HIGHFIRST( scan_data_ts, scan_objbase->data_ts );
       DBG("scan: find datatime for ts=%lli (first: %lli)",(long long int)ts,(long long int)scan_ts);
       while ( scan_data_ts > ts  )
         {
           DBG("scan: still %lli > %lli ", (long long int)scan_ts, (long long int)ts);
-          scan_objbase = kogmo_rtdb_obj_histscan (db_h, -1, scan_objmeta_p, &sl, &fsl);
+          scan_objbase = kogmo_rtdb_obj_histscan (db_h, -1, scan_objhot_p, &sl, &fsl);
           if ( scan_objbase != NULL )
             {
               COPY_INT64_HIGHFIRST( scan_ts, scan_objbase->committed_ts);
@@ -695,13 +1248,20 @@ kogmo_rtdb_obj_readdata__mode (kogmo_rtdb_handle_t *db_h, int mode,
         }
       break;
     case RTDBSEL_DATAOLDER:
+      err = kogmo_rtdb_obj_dataidx_find (db_h, scan_objhot_p, RTDBSEL_DATAOLDER, ts,
+                                         &scan_objbase, &scan_ts, &scan_data_ts);
+      if ( err <= 0 )
+        {
+          if ( err < 0 ) return err;
+          break;
+        }
       COPY_INT64_HIGHFIRST( scan_ts, scan_objbase->committed_ts );
       COPY_INT64_HIGHFIRST( scan_data_ts, scan_objbase->data_ts );
       DBG("scan: find data older for ts=%lli (first: %lli)",(long long int)ts,(long long int)scan_ts);
       while ( scan_data_ts >= ts  )
         {
           DBG("scan: still %lli > %lli ", (long long int)scan_ts, (long long int)ts);
-          scan_objbase = kogmo_rtdb_obj_histscan (db_h, -1, scan_objmeta_p, &sl, &fsl);
+          scan_objbase = kogmo_rtdb_obj_histscan (db_h, -1, scan_objhot_p, &sl, &fsl);
           if ( scan_objbase != NULL )
             {
               COPY_INT64_HIGHFIRST( scan_ts, scan_objbase->committed_ts);
@@ -715,6 +1275,13 @@ kogmo_rtdb_obj_readdata__mode (kogmo_rtdb_handle_t *db_h, int mode,
         }
       break;
     case RTDBSEL_DATAYOUNGER:
+      err = kogmo_rtdb_obj_dataidx_find (db_h, scan_objhot_p, RTDBSEL_DATAYOUNGER, ts,
+                                         &scan_objbase, &scan_ts, &scan_data_ts);
+      if ( err <= 0 )
+        {
+          if ( err < 0 ) return err;
+          break;
+        }
       COPY_INT64_HIGHFIRST( scan_ts, scan_objbase->committed_ts );
       next_scan_ts = scan_ts;
       COPY_INT64_HIGHFIRST( scan_data_ts, scan_objbase->data_ts );
@@ -732,7 +1299,7 @@ kogmo_rtdb_obj_readdata__mode (kogmo_rtdb_handle_t *db_h, int mode,
           scan_objbase = next_scan_objbase;
           scan_ts = next_scan_ts;
           scan_data_ts = next_scan_data_ts;
-          next_scan_objbase = kogmo_rtdb_obj_histscan (db_h, -1, scan_objmeta_p, &sl, &fsl);
+          next_scan_objbase = kogmo_rtdb_obj_histscan (db_h, -1, scan_objhot_p, &sl, &fsl);
           if ( next_scan_objbase != NULL )
             {
               COPY_INT64_HIGHFIRST( next_scan_ts, next_scan_objbase->committed_ts);
@@ -764,7 +1331,7 @@ kogmo_rtdb_obj_readdata__mode (kogmo_rtdb_handle_t *db_h, int mode,
   // NO. Better truncate it and return real size:
   // ==>
   avail_size = scan_objbase->size <= size ? scan_objbase->size : size;
-  memcpy ( data_p, scan_objbase, avail_size );
+  kogmo_rtdb_copy ( db_h, data_p, scan_objbase, avail_size );
   // update used size. otherwise a later dump or re-commit etc. will segfault!!
   ( (kogmo_rtdb_subobj_base_t*) data_p )->size = avail_size;
 
@@ -777,14 +1344,14 @@ kogmo_rtdb_obj_readdata__mode (kogmo_rtdb_handle_t *db_h, int mode,
       return -KOGMO_RTDB_ERR_HISTWRAP;
     }
 
-  if ( scan_objmeta_p->flags.withhold_stale )
+  if ( scan_objhot_p->flags.withhold_stale )
     {
-      float max_cycle_time = MAX_CYCLETIME(scan_objmeta_p->min_cycletime, scan_objmeta_p->max_cycletime);
+      float max_cycle_time = MAX_CYCLETIME(scan_objhot_p->min_cycletime, scan_objhot_p->max_cycletime);
       float time_since_last_commit = kogmo_timestamp_diff_secs (scan_objbase->committed_ts, kogmo_rtdb_timestamp_now (db_h));
       DBGL (DBGL_MSG,"withhold-stale-check: commit-age %f > %f ?", time_since_last_commit, max_cycle_time);
       if ( time_since_last_commit > max_cycle_time )
         {
-          DBGL (DBGL_MSG,"commit-age too old at withhold-stale-check for oid %d: %f > %f", scan_objmeta_p ->oid, time_since_last_commit, max_cycle_time);
+          DBGL (DBGL_MSG,"commit-age too old at withhold-stale-check for oid %d: %f > %f", scan_objhot_p ->oid, time_since_last_commit, max_cycle_time);
           return -KOGMO_RTDB_ERR_TOOFAST; // TODO: choose better error code, but ESTALE already defined for HISTWRAP :-(
         }
     }
@@ -793,21 +1360,37 @@ kogmo_rtdb_obj_readdata__mode (kogmo_rtdb_handle_t *db_h, int mode,
 }
 
 
+inline static kogmo_rtdb_objsize_t
+kogmo_rtdb_obj_readdata__mode (kogmo_rtdb_handle_t *db_h, int mode,
+                       kogmo_rtdb_objid_t oid, kogmo_timestamp_t ts,
+                       void *data_p, kogmo_rtdb_objsize_t size)
+{
+  struct kogmo_rtdb_obj_hot_t *scan_objhot_p;
+
+  CHK_DBH("kogmo_rtdb_obj_readdata_(...)",db_h,0);
+  CHK_PTR(data_p);
+
+  scan_objhot_p = kogmo_rtdb_obj_findhot_byid (db_h, oid);
+  if ( scan_objhot_p == NULL ) return -KOGMO_RTDB_ERR_NOTFOUND;
 
+  return kogmo_rtdb_obj_readdata__hot (db_h, mode, scan_objhot_p, 0, ts, data_p, size);
+}
 
-kogmo_rtdb_objsize_t
-_kogmo_rtdb_obj_readdata_waitnext_until (kogmo_rtdb_handle_t *db_h,
-                            kogmo_rtdb_objid_t oid, kogmo_timestamp_t old_ts,
+
+
+// internal: wait for new data of an object that has already been looked up
+inline static kogmo_rtdb_objsize_t
+kogmo_rtdb_obj_readdata_waitnext__hot (kogmo_rtdb_handle_t *db_h,
+                            struct kogmo_rtdb_obj_hot_t *scan_objhot_p, int checked,
+                            kogmo_timestamp_t old_ts,
                             void *data_p, kogmo_rtdb_objsize_t size, kogmo_timestamp_t wakeup_ts,
                             int do_ptr)
 {
-  kogmo_rtdb_obj_info_t *scan_objmeta_p;
+  kogmo_rtdb_objid_t oid = scan_objhot_p->oid;
   kogmo_rtdb_obj_base_t  base_obj;
   kogmo_rtdb_objsize_t ret;
-  int no_notifies;
-
-  CHK_DBH("kogmo_rtdb_obj_readdata_waitnext(until)(ptr)",db_h,0);
-  CHK_PTR(data_p);
+  int no_notifies, waited = 0;
+  uint32_t notify_seq = 0;
 
   IFDBGL (DBGL_API)
     {
@@ -818,55 +1401,75 @@ _kogmo_rtdb_obj_readdata_waitnext_until (kogmo_rtdb_handle_t *db_h,
             oid, old_ts ? tstr : "0", do_ptr);
     }
 
-  scan_objmeta_p = kogmo_rtdb_obj_findmeta_byid (db_h, oid);
-  if ( scan_objmeta_p == NULL ) return -KOGMO_RTDB_ERR_NOTFOUND;
-
-  no_notifies = scan_objmeta_p->flags.no_notifies | db_h->localdata_p->flags.no_notifies;
+  no_notifies = scan_objhot_p->flags.no_notifies | db_h->localdata_p->flags.no_notifies;
 
   do
   {
 
   if ( ! no_notifies )
-    kogmo_rtdb_obj_wait_notify_prepare (db_h, scan_objmeta_p);
+    notify_seq = kogmo_rtdb_obj_wait_notify_prepare (db_h, scan_objhot_p);
+
+  // the slot gets reused if the object has been purged while waiting
+  if ( *(volatile kogmo_rtdb_objid_t *) &scan_objhot_p->oid != oid )
+    {
+      if ( ! no_notifies )
+        kogmo_rtdb_obj_wait_notify_done (db_h, scan_objhot_p);
+      DBG("kogmo_rtdb_obj_readdata_waitnext: object purged");
+      return -KOGMO_RTDB_ERR_NOTFOUND;
+    }
 
   // for searching, reading the header is enough:
-  ret = kogmo_rtdb_obj_readdata (db_h, oid, 0, &base_obj, sizeof(base_obj));
+  ret = kogmo_rtdb_obj_readdata__hot (db_h, RTDBSEL_LAST, scan_objhot_p, checked,
+                                      0, &base_obj, sizeof(base_obj));
   DBG("kogmo_rtdb_obj_readdata_waitnext: kogmo_rtdb_obj_readdata()=%lli", (long long int)ret);
 
   if ( ret >=0 && old_ts < base_obj.base.committed_ts)
     {
       if ( ! no_notifies )
-        kogmo_rtdb_obj_wait_notify_done (db_h, scan_objmeta_p);
+        kogmo_rtdb_obj_wait_notify_done (db_h, scan_objhot_p);
       break; // end wait-loop
     }
 
   if ( ret < 0 && ret != -KOGMO_RTDB_ERR_NOTFOUND )
     {
       if ( ! no_notifies )
-        kogmo_rtdb_obj_wait_notify_done (db_h, scan_objmeta_p);
+        kogmo_rtdb_obj_wait_notify_done (db_h, scan_objhot_p);
       DBG("kogmo_rtdb_obj_readdata_waitnext: unknown error %i",-ret);
       return ret;
     }
 
   if ( ret == -KOGMO_RTDB_ERR_NOTFOUND )
     {
-      if ( scan_objmeta_p->deleted_ts != invalid_ts )
+      if ( scan_objhot_p->deleted_ts != invalid_ts )
         {
           if ( ! no_notifies )
-            kogmo_rtdb_obj_wait_notify_done (db_h, scan_objmeta_p);
+            kogmo_rtdb_obj_wait_notify_done (db_h, scan_objhot_p);
           DBG("kogmo_rtdb_obj_readdata_waitnext: object deleted");
           return -KOGMO_RTDB_ERR_NOTFOUND;
         }
       DBG("kogmo_rtdb_obj_readdata_waitnext: object has no data yet");
     }
 
+  if ( ! waited )
+    {
+      waited = 1;
+      db_h->waitstats.waits++;
+    }
+
   if ( ! no_notifies )
     {
-      ret = kogmo_rtdb_obj_wait_notify (db_h, scan_objmeta_p, wakeup_ts);
+      // a commit within the spin time saves the sleep and wakeup in the kernel
+      if ( kogmo_rtdb_obj_wait_notify_spin (db_h, scan_objhot_p, notify_seq, wakeup_ts) )
+        {
+          db_h->waitstats.spin_wakeups++;
+          continue;
+        }
+      db_h->waitstats.blocks++;
+      ret = kogmo_rtdb_obj_wait_notify (db_h, scan_objhot_p, notify_seq, wakeup_ts);
       if ( ret == -KOGMO_RTDB_ERR_TIMEOUT )
         {
           DBG("timeout");
-          kogmo_rtdb_obj_wait_notify_done (db_h, scan_objmeta_p);
+          kogmo_rtdb_obj_wait_notify_done (db_h, scan_objhot_p);
           return ret;
         }
     }
@@ -874,13 +1477,13 @@ _kogmo_rtdb_obj_readdata_waitnext_until (kogmo_rtdb_handle_t *db_h,
     {
       kogmo_timestamp_t poll_ts;
       float poll_time;
-      poll_time = KOGMO_RTDB_NONOTIFIES_POLLTIME_FACTOR * MIN_CYCLETIME(scan_objmeta_p->min_cycletime, scan_objmeta_p->max_cycletime);
+      poll_time = KOGMO_RTDB_NONOTIFIES_POLLTIME_FACTOR * MIN_CYCLETIME(scan_objhot_p->min_cycletime, scan_objhot_p->max_cycletime);
       poll_time = poll_time < KOGMO_RTDB_NONOTIFIES_POLLTIME_MAX ? poll_time : KOGMO_RTDB_NONOTIFIES_POLLTIME_MAX;
       poll_ts = kogmo_timestamp_add_secs ( kogmo_timestamp_now(), poll_time);
       if ( wakeup_ts != 0 && poll_ts > wakeup_ts )
         {
           DBG("poll-timeout");
-          kogmo_rtdb_obj_wait_notify_done (db_h, scan_objmeta_p);
+          kogmo_rtdb_obj_wait_notify_done (db_h, scan_objhot_p);
           return ret;
         }
       kogmo_rtdb_sleep_until (db_h, poll_ts);
@@ -891,15 +1494,36 @@ _kogmo_rtdb_obj_readdata_waitnext_until (kogmo_rtdb_handle_t *db_h,
 
   // found->now read full object with latest data
   if ( do_ptr )
-    ret = kogmo_rtdb_obj_readdata_ptr (db_h, oid, 0, data_p);
+    ret = kogmo_rtdb_obj_readdata__hot (db_h, RTDBSEL_LAST | RTDBSEL_PTR, scan_objhot_p, checked,
+                                        0, data_p, 0);
   else
-    ret = kogmo_rtdb_obj_readdata (db_h, oid, 0, data_p, size);
+    ret = kogmo_rtdb_obj_readdata__hot (db_h, RTDBSEL_LAST, scan_objhot_p, checked,
+                                        0, data_p, size);
 
    DBG("kogmo_rtdb_obj_readdata_waitnext: success: found new data. kogmo_rtdb_obj_readdata%s()=%lli", do_ptr ? "_ptr" : "", (long long int)ret);
    return ret;
 }
 
 
+kogmo_rtdb_objsize_t
+_kogmo_rtdb_obj_readdata_waitnext_until (kogmo_rtdb_handle_t *db_h,
+                            kogmo_rtdb_objid_t oid, kogmo_timestamp_t old_ts,
+                            void *data_p, kogmo_rtdb_objsize_t size, kogmo_timestamp_t wakeup_ts,
+                            int do_ptr)
+{
+  struct kogmo_rtdb_obj_hot_t *scan_objhot_p;
+
+  CHK_DBH("kogmo_rtdb_obj_readdata_waitnext(until)(ptr)",db_h,0);
+  CHK_PTR(data_p);
+
+  scan_objhot_p = kogmo_rtdb_obj_findhot_byid (db_h, oid);
+  if ( scan_objhot_p == NULL ) return -KOGMO_RTDB_ERR_NOTFOUND;
+
+  return kogmo_rtdb_obj_readdata_waitnext__hot (db_h, scan_objhot_p, 0, old_ts,
+                                                data_p, size, wakeup_ts, do_ptr);
+}
+
+
 kogmo_rtdb_objsize_t
 kogmo_rtdb_obj_readdata_waitnext_until (kogmo_rtdb_handle_t *db_h,
                             kogmo_rtdb_objid_t oid, kogmo_timestamp_t old_ts,
@@ -934,3 +1558,712 @@ kogmo_rtdb_obj_readdata_waitnext_ptr (kogmo_rtdb_handle_t *db_h,
 {
   return _kogmo_rtdb_obj_readdata_waitnext_until (db_h, oid, old_ts, data_pp, size, 0, 1);
 }
+
+
+// interrupt_p: return 0 if *interrupt_p gets set while waiting,
+// set it and call kogmo_rtdb_obj_wait_anynotify_interrupt()
+int
+_kogmo_rtdb_obj_wait_any (kogmo_rtdb_handle_t *db_h,
+                          const kogmo_rtdb_objid_t *oids,
+                          const kogmo_timestamp_t *old_ts,
+                          int count, kogmo_timestamp_t wakeup_ts,
+                          int *changed, volatile int *interrupt_p)
+{
+  struct kogmo_rtdb_obj_hot_t *scan_objhot_p;
+  kogmo_rtdb_obj_base_t base_obj;
+  kogmo_rtdb_objsize_t ret;
+  kogmo_timestamp_t poll_ts;
+  float poll_time, obj_poll_time;
+  uint32_t notify_seq = 0;
+  int i, found, do_poll;
+
+  CHK_DBH("kogmo_rtdb_obj_wait_any",db_h,0);
+  CHK_PTR(oids);
+  CHK_PTR(old_ts);
+  CHK_PTR(changed);
+  if ( count <= 0 )
+    return -KOGMO_RTDB_ERR_INVALID;
+
+  DBGL (DBGL_API,"kogmo_rtdb_obj_wait_any(%i objects)", count);
+
+  do
+  {
+    found = 0;
+#ifdef KOGMO_RTDB_OBJ_WAIT_ANY_POLLING
+    do_poll = 1;
+#else
+    do_poll = db_h->localdata_p->flags.no_notifies;
+#endif
+    poll_time = KOGMO_RTDB_NONOTIFIES_POLLTIME_MAX;
+
+    if ( ! do_poll )
+      notify_seq = kogmo_rtdb_obj_wait_anynotify_prepare (db_h);
+
+    for ( i = 0; i < count; i++ )
+      {
+        changed[i] = 0;
+        scan_objhot_p = kogmo_rtdb_obj_findhot_byid (db_h, oids[i]);
+        if ( scan_objhot_p == NULL )
+          {
+            changed[i] = -1;
+            found++;
+            continue;
+          }
+
+        // objects without notifies have to be polled, like in waitnext()
+        if ( scan_objhot_p->flags.no_notifies )
+          do_poll = 1;
+        obj_poll_time = KOGMO_RTDB_NONOTIFIES_POLLTIME_FACTOR * MIN_CYCLETIME(scan_objhot_p->min_cycletime, scan_objhot_p->max_cycletime);
+        if ( obj_poll_time < poll_time )
+          poll_time = obj_poll_time;
+
+        // flag before checking, so that every later commit wakes us up
+        if ( ! do_poll )
+          kogmo_rtdb_obj_wait_anynotify_add (db_h, scan_objhot_p);
+
+        ret = kogmo_rtdb_obj_readdata__hot (db_h, RTDBSEL_LAST, scan_objhot_p, 0,
+                                            0, &base_obj, sizeof(base_obj));
+        if ( ret >= 0 && old_ts[i] < base_obj.base.committed_ts )
+          {
+            changed[i] = 1;
+            found++;
+            continue;
+          }
+        if ( ret == -KOGMO_RTDB_ERR_NOTFOUND )
+          {
+            if ( scan_objhot_p->deleted_ts != invalid_ts
+                 || *(volatile kogmo_rtdb_objid_t *) &scan_objhot_p->oid != oids[i] )
+              {
+                changed[i] = -1;
+                found++;
+              }
+            continue; // otherwise the object has no data yet
+          }
+        if ( ret < 0 )
+          {
+            DBG("kogmo_rtdb_obj_wait_any: error %i for oid %i", -ret, oids[i]);
+            return ret;
+          }
+      }
+
+    if ( found )
+      {
+        DBG("kogmo_rtdb_obj_wait_any: %i objects changed", found);
+        return found;
+      }
+
+    if ( interrupt_p && *interrupt_p )
+      {
+        DBG("kogmo_rtdb_obj_wait_any: interrupted");
+        return 0;
+      }
+
+    if ( ! do_poll )
+      {
+        ret = kogmo_rtdb_obj_wait_anynotify (db_h, notify_seq, wakeup_ts);
+        if ( ret == -KOGMO_RTDB_ERR_TIMEOUT )
+          {
+            DBG("kogmo_rtdb_obj_wait_any: timeout");
+            return ret;
+          }
+      }
+    else
+      {
+        if ( wakeup_ts != 0 && kogmo_timestamp_now() >= wakeup_ts )
+          {
+            DBG("kogmo_rtdb_obj_wait_any: poll-timeout");
+            return -KOGMO_RTDB_ERR_TIMEOUT;
+          }
+        poll_ts = kogmo_timestamp_add_secs ( kogmo_timestamp_now(), poll_time);
+        if ( wakeup_ts != 0 && poll_ts > wakeup_ts )
+          poll_ts = wakeup_ts;
+        kogmo_rtdb_sleep_until (db_h, poll_ts);
+      }
+  } while (1);
+}
+
+int
+kogmo_rtdb_obj_wait_any (kogmo_rtdb_handle_t *db_h,
+                         const kogmo_rtdb_objid_t *oids,
+                         const kogmo_timestamp_t *old_ts,
+                         int count, kogmo_timestamp_t wakeup_ts,
+                         int *changed)
+{
+  return _kogmo_rtdb_obj_wait_any (db_h, oids, old_ts, count, wakeup_ts, changed, NULL);
+}
+
+
+// internal: the data_ts and committed_ts of the latest data of an object,
+// 0 if it has no data yet
+inline static kogmo_rtdb_objsize_t
+kogmo_rtdb_obj_latest_ts (kogmo_rtdb_handle_t *db_h,
+                          struct kogmo_rtdb_obj_hot_t *scan_objhot_p,
+                          kogmo_timestamp_t *data_ts_p, kogmo_timestamp_t *committed_ts_p)
+{
+  kogmo_rtdb_obj_base_t base_obj;
+  kogmo_rtdb_objsize_t ret;
+  ret = kogmo_rtdb_obj_readdata__hot (db_h, RTDBSEL_LAST, scan_objhot_p, 0,
+                                      0, &base_obj, sizeof(base_obj));
+  *data_ts_p = ret >= 0 ? base_obj.base.data_ts : 0;
+  *committed_ts_p = ret >= 0 ? base_obj.base.committed_ts : 0;
+  if ( ret == -KOGMO_RTDB_ERR_NOTFOUND && scan_objhot_p->deleted_ts == invalid_ts )
+    return 0; // no data yet
+  return ret;
+}
+
+int
+kogmo_rtdb_obj_wait_all (kogmo_rtdb_handle_t *db_h,
+                         const kogmo_rtdb_objid_t *oids, int count,
+                         kogmo_timestamp_t data_ts_tolerance,
+                         kogmo_timestamp_t wakeup_ts,
+                         kogmo_timestamp_t *set_ts_p,
+                         void *ptrs_p, kogmo_timestamp_t *committed_ts)
+{
+  struct kogmo_rtdb_obj_hot_t *scan_objhot_p, *last_objhot_p;
+  kogmo_rtdb_subobj_base_t **ptrs = (kogmo_rtdb_subobj_base_t **) ptrs_p;
+  kogmo_rtdb_subobj_base_t *scan_objbase;
+  volatile kogmo_timestamp_t scan_ts;
+  kogmo_timestamp_t data_ts, window_ts, min_ts, max_ts, poll_ts, last_ts, last_committed_ts;
+  kogmo_rtdb_objsize_t ret;
+  float poll_time, obj_poll_time;
+  uint32_t notify_seq = 0;
+  int i, do_poll, retry;
+
+  CHK_DBH("kogmo_rtdb_obj_wait_all",db_h,0);
+  CHK_PTR(oids);
+  CHK_PTR(set_ts_p);
+  CHK_PTR(ptrs_p);
+  if ( count <= 0 || data_ts_tolerance < 0 )
+    return -KOGMO_RTDB_ERR_INVALID;
+
+  DBGL (DBGL_API,"kogmo_rtdb_obj_wait_all(%i objects)", count);
+
+  do
+  {
+#ifdef KOGMO_RTDB_OBJ_WAIT_ANY_POLLING
+    do_poll = 1;
+#else
+    do_poll = db_h->localdata_p->flags.no_notifies;
+#endif
+    poll_time = KOGMO_RTDB_NONOTIFIES_POLLTIME_MAX;
+    retry = 0;
+
+    if ( ! do_poll )
+      notify_seq = kogmo_rtdb_obj_wait_anynotify_prepare (db_h);
+
+    // the window ends at the latest frame of the slowest object
+    window_ts = 0;
+    for ( i = 0; i < count; i++ )
+      {
+        scan_objhot_p = kogmo_rtdb_obj_findhot_byid (db_h, oids[i]);
+        if ( scan_objhot_p == NULL )
+          return -KOGMO_RTDB_ERR_NOTFOUND;
+        if ( scan_objhot_p->flags.no_notifies )
+          do_poll = 1;
+        obj_poll_time = KOGMO_RTDB_NONOTIFIES_POLLTIME_FACTOR * MIN_CYCLETIME(scan_objhot_p->min_cycletime, scan_objhot_p->max_cycletime);
+        if ( obj_poll_time < poll_time )
+          poll_time = obj_poll_time;
+        ret = kogmo_rtdb_obj_latest_ts (db_h, scan_objhot_p, &data_ts, &last_committed_ts);
+        if ( ret < 0 )
+          return ret;
+        if ( i == 0 || data_ts < window_ts )
+          window_ts = data_ts;
+      }
+
+    // take the frame of each object that is next to the window,
+    // all of them must be within the tolerance and newer than the last set
+    if ( window_ts > *set_ts_p )
+      {
+        min_ts = max_ts = window_ts;
+        for ( i = 0; i < count && !retry; i++ )
+          {
+            scan_objhot_p = kogmo_rtdb_obj_findhot_byid (db_h, oids[i]);
+            if ( scan_objhot_p == NULL )
+              return -KOGMO_RTDB_ERR_NOTFOUND;
+            ret = kogmo_rtdb_obj_readdata__hot (db_h, RTDBSEL_DATATIME | RTDBSEL_PTR, scan_objhot_p, 0,
+                                                window_ts + data_ts_tolerance, &scan_objbase, 0);
+            if ( ret == -KOGMO_RTDB_ERR_HISTWRAP )
+              {
+                retry = 1;
+                break;
+              }
+            if ( ret < 0 )
+              return ret;
+            COPY_INT64_HIGHFIRST( scan_ts, scan_objbase->committed_ts );
+            COMPILER_BARRIER();
+            if ( scan_ts == invalid_ts )
+              {
+                retry = 1; // being overwritten right now
+                break;
+              }
+            ptrs[i] = scan_objbase;
+            if ( committed_ts )
+              committed_ts[i] = scan_ts;
+            data_ts = scan_objbase->data_ts;
+            if ( data_ts < min_ts )
+              min_ts = data_ts;
+            if ( data_ts > max_ts )
+              max_ts = data_ts;
+          }
+        if ( retry )
+          continue;
+        if ( max_ts - min_ts <= data_ts_tolerance && min_ts > *set_ts_p )
+          {
+            DBG("kogmo_rtdb_obj_wait_all: found a set of %i objects", count);
+            *set_ts_p = max_ts;
+            return count;
+          }
+      }
+
+    // only new frames of all objects that have nothing newer than the window
+    // or the last set can complete a set, so wait for the one of them that
+    // is usually the last: the one that committed last before;
+    // flag it before checking again (deletions wake up all waiters)
+    if ( ! do_poll )
+      {
+        if ( window_ts < *set_ts_p )
+          window_ts = *set_ts_p;
+        last_objhot_p = NULL;
+        last_ts = 0;
+        for ( i = 0; i < count; i++ )
+          {
+            scan_objhot_p = kogmo_rtdb_obj_findhot_byid (db_h, oids[i]);
+            if ( scan_objhot_p == NULL )
+              return -KOGMO_RTDB_ERR_NOTFOUND;
+            ret = kogmo_rtdb_obj_latest_ts (db_h, scan_objhot_p, &data_ts, &last_committed_ts);
+            if ( ret < 0 )
+              return ret;
+            if ( data_ts <= window_ts && ( last_objhot_p == NULL || last_committed_ts >= last_ts ) )
+              {
+                last_objhot_p = scan_objhot_p;
+                last_ts = last_committed_ts;
+              }
+          }
+        if ( last_objhot_p == NULL )
+          continue; // new frames meanwhile
+        kogmo_rtdb_obj_wait_anynotify_add (db_h, last_objhot_p);
+        ret = kogmo_rtdb_obj_latest_ts (db_h, last_objhot_p, &data_ts, &last_committed_ts);
+        if ( ret < 0 )
+          return ret;
+        if ( last_committed_ts != last_ts )
+          continue; // a new frame meanwhile
+      }
+
+    if ( ! do_poll )
+      {
+        ret = kogmo_rtdb_obj_wait_anynotify (db_h, notify_seq, wakeup_ts);
+        if ( ret == -KOGMO_RTDB_ERR_TIMEOUT )
+          {
+            DBG("kogmo_rtdb_obj_wait_all: timeout");
+            return ret;
+          }
+      }
+    else
+      {
+        if ( wakeup_ts != 0 && kogmo_timestamp_now() >= wakeup_ts )
+          {
+            DBG("kogmo_rtdb_obj_wait_all: poll-timeout");
+            return -KOGMO_RTDB_ERR_TIMEOUT;
+          }
+        poll_ts = kogmo_timestamp_add_secs ( kogmo_timestamp_now(), poll_time);
+        if ( wakeup_ts != 0 && poll_ts > wakeup_ts )
+          poll_ts = wakeup_ts;
+        kogmo_rtdb_sleep_until (db_h, poll_ts);
+      }
+  } while (1);
+}
+
+
+
+int
+kogmo_rtdb_obj_bind (kogmo_rtdb_handle_t *db_h,
+                     kogmo_rtdb_objid_t oid,
+                     kogmo_rtdb_obj_handle_t *objh)
+{
+  struct kogmo_rtdb_obj_hot_t *scan_objhot_p;
+  int is_owner;
+
+  CHK_DBH("kogmo_rtdb_obj_bind",db_h,0);
+  CHK_PTR(objh);
+
+  DBGL (DBGL_API,"kogmo_rtdb_obj_bind(oid %i)", oid);
+
+  memset (objh, 0, sizeof (kogmo_rtdb_obj_handle_t));
+
+  scan_objhot_p = kogmo_rtdb_obj_findhot_byid (db_h, oid);
+  if ( scan_objhot_p == NULL ) return -KOGMO_RTDB_ERR_NOTFOUND;
+  if ( scan_objhot_p->buffer_idx == 0 ) return -KOGMO_RTDB_ERR_NOTFOUND;
+
+  // the flags of an object cannot be changed after its creation,
+  // so the permissions can be checked once here
+  is_owner = scan_objhot_p->created_proc == db_h->ipc_h.this_process.proc_oid
+             || this_process_is_admin (db_h);
+  if ( !scan_objhot_p->flags.read_deny || is_owner )
+    objh->access |= KOGMO_RTDB_OBJ_HANDLE_READ;
+  if ( scan_objhot_p->flags.write_allow || is_owner )
+    objh->access |= KOGMO_RTDB_OBJ_HANDLE_WRITE;
+
+  objh->object_slot = kogmo_rtdb_obj_hot_slotnum (db_h, scan_objhot_p);
+  objh->oid = oid;
+  return 0;
+}
+
+
+// internal: check a bound handle.
+// oids are never reused, so a slot that still carries the oid of the
+// handle contains the bound object
+inline static struct kogmo_rtdb_obj_hot_t *
+kogmo_rtdb_obj_handle_hot (kogmo_rtdb_handle_t *db_h,
+                           kogmo_rtdb_obj_handle_t *objh)
+{
+  struct kogmo_rtdb_obj_hot_t *scan_objhot_p;
+  if ( objh->object_slot < 0 || objh->object_slot >= (int32_t) db_h->obj_max )
+    return NULL;
+  scan_objhot_p = &db_h->objhot[objh->object_slot];
+  if ( *(volatile kogmo_rtdb_objid_t *) &scan_objhot_p->oid != objh->oid )
+    return NULL;
+  return scan_objhot_p;
+}
+
+
+int
+kogmo_rtdb_obj_writedata_bound (kogmo_rtdb_handle_t *db_h,
+                                kogmo_rtdb_obj_handle_t *objh,
+                                void *data_p)
+{
+  struct kogmo_rtdb_obj_hot_t *used_objhot_p;
+  kogmo_timestamp_t committed_ts;
+
+  committed_ts = kogmo_rtdb_timestamp_now (db_h);
+
+  CHK_DBH("kogmo_rtdb_obj_writedata_bound",db_h,0);
+  CHK_PTR(objh);
+  CHK_PTR(data_p);
+
+  used_objhot_p = kogmo_rtdb_obj_handle_hot (db_h, objh);
+  if ( used_objhot_p == NULL ) return -KOGMO_RTDB_ERR_NOTFOUND;
+  if ( ! ( objh->access & KOGMO_RTDB_OBJ_HANDLE_WRITE ) )
+    {
+      DBGL (DBGL_MSG,"commit permission denied for oid %d", objh->oid);
+      return -KOGMO_RTDB_ERR_NOPERM;
+    }
+
+  return kogmo_rtdb_obj_writedata__hot (db_h, used_objhot_p, 1, data_p, committed_ts, NULL, 0);
+}
+
+
+kogmo_rtdb_objsize_t
+kogmo_rtdb_obj_readdata_bound (kogmo_rtdb_handle_t *db_h,
+                               kogmo_rtdb_obj_handle_t *objh,
+                               kogmo_timestamp_t ts,
+                               void *data_p, kogmo_rtdb_objsize_t size)
+{
+  struct kogmo_rtdb_obj_hot_t *scan_objhot_p;
+
+  CHK_DBH("kogmo_rtdb_obj_readdata_bound",db_h,0);
+  CHK_PTR(objh);
+  CHK_PTR(data_p);
+
+  scan_objhot_p = kogmo_rtdb_obj_handle_hot (db_h, objh);
+  if ( scan_objhot_p == NULL ) return -KOGMO_RTDB_ERR_NOTFOUND;
+  if ( ! ( objh->access & KOGMO_RTDB_OBJ_HANDLE_READ ) )
+    {
+      DBGL (DBGL_MSG,"read permission denied for oid %d", objh->oid);
+      return -KOGMO_RTDB_ERR_NOPERM;
+    }
+
+  return kogmo_rtdb_obj_readdata__hot (db_h, RTDBSEL_LAST, scan_objhot_p, 1, ts, data_p, size);
+}
+
+
+kogmo_rtdb_objsize_t
+kogmo_rtdb_obj_readdata_waitnext_bound (kogmo_rtdb_handle_t *db_h,
+                            kogmo_rtdb_obj_handle_t *objh, kogmo_timestamp_t old_ts,
+                            void *data_p, kogmo_rtdb_objsize_t size, kogmo_timestamp_t wakeup_ts)
+{
+  struct kogmo_rtdb_obj_hot_t *scan_objhot_p;
+
+  CHK_DBH("kogmo_rtdb_obj_readdata_waitnext_bound",db_h,0);
+  CHK_PTR(objh);
+  CHK_PTR(data_p);
+
+  scan_objhot_p = kogmo_rtdb_obj_handle_hot (db_h, objh);
+  if ( scan_objhot_p == NULL ) return -KOGMO_RTDB_ERR_NOTFOUND;
+  if ( ! ( objh->access & KOGMO_RTDB_OBJ_HANDLE_READ ) )
+    {
+      DBGL (DBGL_MSG,"read permission denied for oid %d", objh->oid);
+      return -KOGMO_RTDB_ERR_NOPERM;
+    }
+
+  return kogmo_rtdb_obj_readdata_waitnext__hot (db_h, scan_objhot_p, 1, old_ts,
+                                                data_p, size, wakeup_ts, 0);
+}
+
+
+/* ******************** SNAPSHOT READS ******************** */
+
+#define READMULTI_RETRIES 10
+
+// internal: read the latest data of an object committed at or before ts
+// (0: the latest data) with a commit sequence number up to seq_bound.
+// a commit with a number up to seq_bound that is not yet visible here
+// has not been seen by anybody, the snapshot may leave it out.
+inline static kogmo_rtdb_objsize_t
+kogmo_rtdb_obj_readdata__snapshot (kogmo_rtdb_handle_t *db_h,
+                                   struct kogmo_rtdb_obj_hot_t *scan_objhot_p,
+                                   kogmo_timestamp_t ts, uint64_t seq_bound,
+                                   void *data_p, kogmo_rtdb_objsize_t size)
+{
+  kogmo_rtdb_subobj_base_t *scan_objbase;
+  volatile kogmo_timestamp_t scan_ts, prev_ts, final_ts;
+  kogmo_rtdb_objsize_t avail_size, err;
+  uint64_t *seq_p;
+  int32_t slot, steps;
+
+  // the data for ts, then go back to the latest commit within the snapshot,
+  // this is usually the same or the previous one
+  err = kogmo_rtdb_obj_readdata__hot (db_h, RTDBSEL_LAST|RTDBSEL_PTR, scan_objhot_p, 0,
+                                      ts, &scan_objbase, 0);
+  if ( err < 0 )
+    return err;
+  seq_p = kogmo_rtdb_obj_commitseq (db_h, scan_objhot_p);
+  slot = ( (char*) scan_objbase - &db_h->heap[scan_objhot_p->buffer_idx] )
+         / scan_objhot_p->slot_stride;
+  COPY_INT64_HIGHFIRST( scan_ts, scan_objbase->committed_ts );
+  COMPILER_BARRIER();
+  if ( scan_ts == invalid_ts )
+    return -KOGMO_RTDB_ERR_HISTWRAP; // the data is being overwritten
+  for ( steps = 1; __atomic_load_n (&seq_p[slot], __ATOMIC_RELAXED) > seq_bound; steps++ )
+    {
+      if ( steps >= scan_objhot_p->history_size )
+        return -KOGMO_RTDB_ERR_HISTWRAP; // all data is newer than the snapshot
+      slot = ( slot - 1 + scan_objhot_p->history_size ) % scan_objhot_p->history_size;
+      scan_objbase = (kogmo_rtdb_subobj_base_t *)
+                       & ( db_h->heap [ scan_objhot_p->buffer_idx + slot * scan_objhot_p->slot_stride ] );
+      COPY_INT64_HIGHFIRST( prev_ts, scan_objbase->committed_ts );
+      COMPILER_BARRIER();
+      if ( prev_ts == invalid_ts && __atomic_load_n (&seq_p[slot], __ATOMIC_RELAXED) == 0 )
+        return -KOGMO_RTDB_ERR_NOTFOUND; // no more data
+      if ( prev_ts == invalid_ts || prev_ts >= scan_ts )
+        return -KOGMO_RTDB_ERR_HISTWRAP; // the data has been overwritten meanwhile
+      scan_ts = prev_ts;
+    }
+
+  avail_size = scan_objbase->size <= size ? scan_objbase->size : size;
+  kogmo_rtdb_copy ( db_h, data_p, scan_objbase, avail_size );
+  ( (kogmo_rtdb_subobj_base_t*) data_p )->size = avail_size;
+
+  COPY_INT64_LOWFIRST( final_ts, scan_objbase->committed_ts );
+  ((kogmo_rtdb_subobj_base_t *) data_p)->committed_ts = final_ts;
+
+  if ( final_ts != scan_ts )
+    {
+      DBG("snapshot read: history wrap-around! now %lli, should have been %lli", (long long int)final_ts, (long long int)scan_ts);
+      return -KOGMO_RTDB_ERR_HISTWRAP;
+    }
+
+  return scan_objbase->size;
+}
+
+// internal: read all entries of kogmo_rtdb_obj_readdata_multi() with
+// the commit sequence number seq_bound, returns the number of successful reads
+static int
+kogmo_rtdb_obj_readdata__multi (kogmo_rtdb_handle_t *db_h,
+                                kogmo_rtdb_obj_readmulti_t *reads, int count,
+                                uint64_t seq_bound)
+{
+  struct kogmo_rtdb_obj_hot_t *scan_objhot_p;
+  int i, found = 0;
+
+  for ( i = 0; i < count; i++ )
+    {
+      if ( reads[i].data_p == NULL )
+        {
+          reads[i].result = -KOGMO_RTDB_ERR_INVALID;
+          continue;
+        }
+      scan_objhot_p = kogmo_rtdb_obj_findhot_byid (db_h, reads[i].oid);
+      if ( scan_objhot_p == NULL )
+        {
+          reads[i].result = -KOGMO_RTDB_ERR_NOTFOUND;
+          continue;
+        }
+      reads[i].result = kogmo_rtdb_obj_readdata__snapshot (db_h, scan_objhot_p,
+                          reads[i].ts, seq_bound, reads[i].data_p, reads[i].size);
+      if ( reads[i].result >= 0 )
+        found++;
+    }
+
+  return found;
+}
+
+int
+kogmo_rtdb_obj_readdata_multi (kogmo_rtdb_handle_t *db_h,
+                               kogmo_rtdb_obj_readmulti_t *reads, int count)
+{
+  uint64_t seq_bound;
+  int i, retries, found = 0;
+
+  CHK_DBH("kogmo_rtdb_obj_readdata_multi",db_h,0);
+  CHK_PTR(reads);
+
+  DBGL (DBGL_API,"obj_readdata_multi(%p, %i)", reads, count);
+
+  for ( retries = 0; retries < READMULTI_RETRIES; retries++ )
+    {
+      // the snapshot holds all commits numbered up to now,
+      // a single load (also on 32-bit cpus)
+      seq_bound = __atomic_load_n (&db_h->localdata_p->commit_seq, __ATOMIC_ACQUIRE);
+
+      found = kogmo_rtdb_obj_readdata__multi (db_h, reads, count, seq_bound);
+
+      // start again with a new snapshot if later commits have
+      // overwritten data of the snapshot
+      for ( i = 0; i < count; i++ )
+        if ( reads[i].result == -KOGMO_RTDB_ERR_HISTWRAP )
+          break;
+      if ( i == count )
+        break;
+      DBG("readdata_multi: history wrap-around, new snapshot");
+    }
+
+  return found;
+}
+
+
+/* ******************** HISTORY RANGE READS ******************** */
+
+// internal: collect all history entries with begin_ts <= committed_ts <= end_ts,
+// the oldest first. with ptrs!=NULL only the pointers are stored, otherwise
+// the data is copied to data_p with a stride of size bytes.
+// the writers overwrite the entries from the oldest to the latest, so if
+// the first (oldest) collected entry is still unchanged at the end, all
+// the others are too and wrap-around is checked only once for the batch.
+static int
+kogmo_rtdb_obj_readdata__between (kogmo_rtdb_handle_t *db_h,
+                                  kogmo_rtdb_objid_t oid,
+                                  kogmo_timestamp_t begin_ts,
+                                  kogmo_timestamp_t end_ts,
+                                  void *data_p, kogmo_rtdb_objsize_t size,
+                                  kogmo_rtdb_subobj_base_t **ptrs,
+                                  int max_count)
+{
+  struct kogmo_rtdb_obj_hot_t *scan_objhot_p;
+  kogmo_rtdb_subobj_base_t *scan_objbase, *first_objbase = NULL;
+  volatile kogmo_timestamp_t scan_ts, prev_ts = 0, first_ts = 0, final_ts;
+  kogmo_rtdb_objsize_t avail_size;
+  char *copy_p;
+  int32_t age, latest_slot;
+  int count = 0;
+
+  IFDBGL (DBGL_API)
+    {
+      kogmo_timestamp_string_t tstr1, tstr2;
+      kogmo_timestamp_to_string(begin_ts, tstr1);
+      kogmo_timestamp_to_string(end_ts, tstr2);
+      DBGL (DBGL_API,"obj_readdata_between%s(oid %i, %s, %s, max %i)",
+            ptrs ? "_ptr" : "", oid, tstr1, tstr2, max_count);
+    }
+
+  if ( max_count <= 0 || begin_ts > end_ts )
+    return -KOGMO_RTDB_ERR_INVALID;
+  if ( ptrs == NULL && size < sizeof (kogmo_rtdb_subobj_base_t) )
+    return -KOGMO_RTDB_ERR_INVALID;
+
+  scan_objhot_p = kogmo_rtdb_obj_findhot_byid (db_h, oid);
+  if ( scan_objhot_p == NULL || scan_objhot_p->buffer_idx == 0 )
+    return -KOGMO_RTDB_ERR_NOTFOUND;
+  if ( scan_objhot_p->flags.read_deny
+    && scan_objhot_p->created_proc != db_h->ipc_h.this_process.proc_oid
+    && !this_process_is_admin (db_h) )
+    {
+      DBGL (DBGL_MSG,"read permission denied for oid %d", scan_objhot_p ->oid);
+      return -KOGMO_RTDB_ERR_NOPERM;
+    }
+
+  // all entries younger than the latest one before begin_ts are in the window,
+  // if the history changes too often, check all entries
+  age = kogmo_rtdb_obj_histsearch (db_h, scan_objhot_p, begin_ts - 1, &latest_slot);
+  if ( age < 0 )
+    {
+      latest_slot = *(volatile int32_t *) &scan_objhot_p->history_slot;
+      age = scan_objhot_p->history_size;
+    }
+  if ( latest_slot < 0 )
+    return 0; // no writes yet
+
+  for ( age--; age >= 0 && count < max_count; age-- )
+    {
+      scan_objbase = kogmo_rtdb_obj_histslot (db_h, scan_objhot_p, latest_slot, age);
+      COPY_INT64_HIGHFIRST( scan_ts, scan_objbase->committed_ts );
+      if ( scan_ts == invalid_ts || scan_ts < begin_ts || scan_ts <= prev_ts )
+        {
+          // unused, being overwritten or the oldest entry that is already
+          // newer than its successor: only possible before the first one
+          if ( count > 0 )
+            return -KOGMO_RTDB_ERR_HISTWRAP;
+          continue;
+        }
+      if ( scan_ts > end_ts )
+        break;
+      if ( count == 0 )
+        {
+          first_objbase = scan_objbase;
+          first_ts = scan_ts;
+        }
+      if ( ptrs )
+        {
+          ptrs[count] = scan_objbase;
+        }
+      else
+        {
+          copy_p = (char*) data_p + (size_t) count * size;
+          avail_size = scan_objbase->size <= size ? scan_objbase->size : size;
+          kogmo_rtdb_copy ( db_h, copy_p, scan_objbase, avail_size );
+          ( (kogmo_rtdb_subobj_base_t*) copy_p )->size = avail_size;
+          ( (kogmo_rtdb_subobj_base_t*) copy_p )->committed_ts = scan_ts;
+        }
+      prev_ts = scan_ts;
+      count++;
+    }
+
+  if ( count > 0 )
+    {
+      COPY_INT64_LOWFIRST( final_ts, first_objbase->committed_ts );
+      if ( final_ts != first_ts )
+        {
+          DBG("read between: history wrap-around! now %lli, should have been %lli", (long long int)final_ts, (long long int)first_ts);
+          return -KOGMO_RTDB_ERR_HISTWRAP;
+        }
+    }
+
+  return count;
+}
+
+int
+kogmo_rtdb_obj_readdata_between (kogmo_rtdb_handle_t *db_h,
+                                 kogmo_rtdb_objid_t oid,
+                                 kogmo_timestamp_t begin_ts,
+                                 kogmo_timestamp_t end_ts,
+                                 void *data_p, kogmo_rtdb_objsize_t size,
+                                 int max_count)
+{
+  CHK_DBH("kogmo_rtdb_obj_readdata_between",db_h,0);
+  CHK_PTR(data_p);
+  return kogmo_rtdb_obj_readdata__between (db_h, oid, begin_ts, end_ts,
+                                           data_p, size, NULL, max_count);
+}
+
+int
+kogmo_rtdb_obj_readdata_between_ptr (kogmo_rtdb_handle_t *db_h,
+                                     kogmo_rtdb_objid_t oid,
+                                     kogmo_timestamp_t begin_ts,
+                                     kogmo_timestamp_t end_ts,
+                                     void *ptrs_p, int max_count)
+{
+  CHK_DBH("kogmo_rtdb_obj_readdata_between_ptr",db_h,0);
+  CHK_PTR(ptrs_p);
+  return kogmo_rtdb_obj_readdata__between (db_h, oid, begin_ts, end_ts,
+                                           NULL, 0, (kogmo_rtdb_subobj_base_t **) ptrs_p,
+                                           max_count);
+}
@@ -15,4 +15,17 @@ extern const volatile kogmo_timestamp_t invalid_ts;
 // t_poll is limited to MAX seconds
 #define KOGMO_RTDB_NONOTIFIES_POLLTIME_MAX (0.1)
 
+int
+_kogmo_rtdb_obj_wait_any (kogmo_rtdb_handle_t *db_h,
+                          const kogmo_rtdb_objid_t *oids,
+                          const kogmo_timestamp_t *old_ts,
+                          int count, kogmo_timestamp_t wakeup_ts,
+                          int *changed, volatile int *interrupt_p);
+
+// subscriptions of this process, see kogmo_rtdb_obj_subscribe_fd()
+void
+kogmo_rtdb_obj_subscribe_init (kogmo_rtdb_handle_t *db_h);
+void
+kogmo_rtdb_obj_subscribe_destroy (kogmo_rtdb_handle_t *db_h);
+
 #endif /* KOGMO_RTDB_OBJDATA_H */
@@ -25,7 +25,7 @@ kogmo_rtdb_obj_readdataslot_ptr (kogmo_rtdb_handle_t *db_h,
                                  kogmo_rtdb_obj_slot_t *objslot,
                                  void *data_pp)
 {
-  kogmo_rtdb_obj_info_t *scan_objmeta_p;
+  struct kogmo_rtdb_obj_hot_t *scan_objhot_p;
   kogmo_rtdb_subobj_base_t *scan_objbase_p, *last_scan_objbase_p = NULL;
   volatile kogmo_timestamp_t scan_ts,final_ts;
 
@@ -35,11 +35,11 @@ kogmo_rtdb_obj_readdataslot_ptr (kogmo_rtdb_handle_t *db_h,
   if ( mode == 0 )
     {
         // TODO: optimize
-        scan_objmeta_p = kogmo_rtdb_obj_findmeta_byid (db_h, objslot->oid );
-        if ( scan_objmeta_p == NULL )
+        scan_objhot_p = kogmo_rtdb_obj_findhot_byid (db_h, objslot->oid );
+        if ( scan_objhot_p == NULL )
           return -KOGMO_RTDB_ERR_NOTFOUND;
-        objslot->object_slot = kogmo_rtdb_obj_slotnum (db_h, scan_objmeta_p );
-        objslot->history_slot =  scan_objmeta_p->history_slot;
+        objslot->object_slot = kogmo_rtdb_obj_hot_slotnum (db_h, scan_objhot_p );
+        objslot->history_slot =  scan_objhot_p->history_slot;
         if ( objslot->history_slot < 0 ) // no writes yet
           return -KOGMO_RTDB_ERR_NOTFOUND;
         objslot->committed_ts = invalid_ts;
@@ -48,12 +48,12 @@ kogmo_rtdb_obj_readdataslot_ptr (kogmo_rtdb_handle_t *db_h,
   else
     {
       // now objslot->object_slot must be valid
-      if ( objslot->object_slot < 0 || objslot->object_slot >= KOGMO_RTDB_OBJ_MAX )
+      if ( objslot->object_slot < 0 || objslot->object_slot >= (int)db_h->obj_max )
         return -KOGMO_RTDB_ERR_INVALID;
 
-      scan_objmeta_p = &db_h->localdata_p->objmeta[objslot->object_slot];
+      scan_objhot_p = &db_h->objhot[objslot->object_slot];
 
-      if ( objslot->oid != scan_objmeta_p ->oid )
+      if ( objslot->oid != scan_objhot_p ->oid )
         return -KOGMO_RTDB_ERR_NOTFOUND;
     }
 
@@ -61,21 +61,23 @@ kogmo_rtdb_obj_readdataslot_ptr (kogmo_rtdb_handle_t *db_h,
     {
       // remember old position with committed_ts
       last_scan_objbase_p = (kogmo_rtdb_subobj_base_t *)
-                 & ( db_h->localdata_p->heap [
-                                                 scan_objmeta_p->buffer_idx +
-                                                 objslot->history_slot * scan_objmeta_p->size_max
+                 & ( db_h->heap [
+                                                 scan_objhot_p->buffer_idx +
+                                                 objslot->history_slot * scan_objhot_p->slot_stride
                                                ] );
     }
 
+  objslot->slot_stride = scan_objhot_p->slot_stride;
+
   // calculate next slot position
-  objslot->history_slot = ( objslot->history_slot + ( offset % scan_objmeta_p->history_size ) + scan_objmeta_p->history_size )
-                          % scan_objmeta_p->history_size;
+  objslot->history_slot = ( objslot->history_slot + ( offset % scan_objhot_p->history_size ) + scan_objhot_p->history_size )
+                          % scan_objhot_p->history_size;
 
   // calculate object data pointer from history slot number
   scan_objbase_p = (kogmo_rtdb_subobj_base_t *)
-             & ( db_h->localdata_p->heap [
-                                             scan_objmeta_p->buffer_idx +
-                                             objslot->history_slot * scan_objmeta_p->size_max
+             & ( db_h->heap [
+                                             scan_objhot_p->buffer_idx +
+                                             objslot->history_slot * scan_objhot_p->slot_stride
                                            ] );
 
   COPY_INT64_HIGHFIRST( scan_ts, scan_objbase_p->committed_ts);
@@ -147,7 +149,7 @@ kogmo_rtdb_obj_readdataslot_relative (kogmo_rtdb_handle_t *db_h,
       return olen;
     }
   realsize = olen;
-  memcpy(data_p, objdata_p, realsize < size ? realsize : size);
+  kogmo_rtdb_copy (db_h, data_p, objdata_p, realsize < size ? realsize : size);
   olen = kogmo_rtdb_obj_readdataslot_ptr (db_h, 1, 0, objslot, NULL);
   if ( olen < 0 )
     {
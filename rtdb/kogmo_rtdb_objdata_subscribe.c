@@ -0,0 +1,314 @@
+/* KogMo-RTDB: Real-time Database for Cognitive Automobiles
+ * Copyright (c) 2003-2007 Matthias Goebl <matthias.goebl*goebl.net>
+ *     Lehrstuhl fuer Realzeit-Computersysteme (RCS)
+ *     Technische Universitaet Muenchen (TUM)
+ * Licensed under the Apache License Version 2.0.
+ */
+/*! \file kogmo_rtdb_objdata_subscribe.c
+ * \brief Pollable File Descriptors for Object Updates
+ *
+ * A notifier thread per process waits for all subscribed objects with
+ * kogmo_rtdb_obj_wait_any() and signals an eventfd for each changed one.
+ * Writers do not know about the subscriptions, commits to objects without
+ * subscribers cost nothing extra.
+ */
+
+#include "kogmo_rtdb_internal.h"
+
+#if !defined(MACOSX) && !defined(KOGMO_RTDB_HARDREALTIME)
+#include <sys/eventfd.h>
+#define KOGMO_RTDB_OBJ_SUBSCRIBE_EVENTFD
+#endif
+
+// maximum number of subscribed objects per process
+#ifndef KOGMO_RTDB_OBJ_SUBSCRIBE_MAX
+#define KOGMO_RTDB_OBJ_SUBSCRIBE_MAX 64
+#endif
+
+struct kogmo_rtdb_obj_subscription_t {
+ int fd;                    // -1: unused entry
+ kogmo_rtdb_objid_t oid;    // 0: the object has been deleted, no more events
+ kogmo_timestamp_t old_ts;  // last commit signalled
+};
+
+struct kogmo_rtdb_obj_subscriptions_t {
+ pthread_mutex_t lock;      // protects everything here
+ pthread_cond_t  change;    // wakes up the thread if it has nothing to wait for
+ pthread_t thread;
+ volatile int changed;      // interrupts the thread to rebuild its list
+ int stop;
+ int dead;                  // the thread has failed, no more events
+ struct kogmo_rtdb_obj_subscription_t sub[KOGMO_RTDB_OBJ_SUBSCRIBE_MAX];
+};
+
+
+void
+kogmo_rtdb_obj_subscribe_init (kogmo_rtdb_handle_t *db_h)
+{
+  db_h->subscriptions = NULL; // created with the first subscription
+}
+
+
+#ifdef KOGMO_RTDB_OBJ_SUBSCRIBE_EVENTFD
+
+// internal: tell the thread that the subscriptions have changed,
+// call with the lock held
+static void
+kogmo_rtdb_obj_subscribe_changed (kogmo_rtdb_handle_t *db_h)
+{
+  db_h->subscriptions->changed = 1;
+  pthread_cond_signal (&db_h->subscriptions->change);
+  kogmo_rtdb_obj_wait_anynotify_interrupt (db_h);
+}
+
+// internal: the notifier thread
+static void *
+kogmo_rtdb_obj_subscribe_thread (void *arg)
+{
+  kogmo_rtdb_handle_t *db_h = (kogmo_rtdb_handle_t *) arg;
+  struct kogmo_rtdb_obj_subscriptions_t *subs = db_h->subscriptions;
+  kogmo_rtdb_objid_t oids[KOGMO_RTDB_OBJ_SUBSCRIBE_MAX];
+  kogmo_timestamp_t old_ts[KOGMO_RTDB_OBJ_SUBSCRIBE_MAX];
+  int changed[KOGMO_RTDB_OBJ_SUBSCRIBE_MAX], entry[KOGMO_RTDB_OBJ_SUBSCRIBE_MAX];
+  int fds[KOGMO_RTDB_OBJ_SUBSCRIBE_MAX];
+  kogmo_rtdb_obj_base_t base_obj;
+  kogmo_rtdb_objsize_t err;
+  uint64_t one = 1;
+  int i, j, n, ret;
+
+  DBGL (DBGL_API,"subscription notifier thread started");
+
+  pthread_mutex_lock (&subs->lock);
+  while ( ! subs->stop )
+    {
+      // take a copy of the subscriptions, so that they can change while waiting
+      subs->changed = 0;
+      for ( i = 0, n = 0; i < KOGMO_RTDB_OBJ_SUBSCRIBE_MAX; i++ )
+        if ( subs->sub[i].fd >= 0 && subs->sub[i].oid != 0 )
+          {
+            oids[n] = subs->sub[i].oid;
+            old_ts[n] = subs->sub[i].old_ts;
+            fds[n] = subs->sub[i].fd;
+            entry[n] = i;
+            n++;
+          }
+      if ( n == 0 )
+        {
+          pthread_cond_wait (&subs->change, &subs->lock);
+          continue;
+        }
+      pthread_mutex_unlock (&subs->lock);
+
+      ret = _kogmo_rtdb_obj_wait_any (db_h, oids, old_ts, n, 0, changed, &subs->changed);
+
+      pthread_mutex_lock (&subs->lock);
+      if ( ret < 0 )
+        {
+          // a last event for every subscriber, so that nobody waits forever
+          ERR("subscription notifier thread: waiting for objects failed with error %i, no more events",-ret);
+          subs->dead = 1;
+          for ( i = 0; i < KOGMO_RTDB_OBJ_SUBSCRIBE_MAX; i++ )
+            if ( subs->sub[i].fd >= 0 )
+              {
+                subs->sub[i].oid = 0;
+                if ( write (subs->sub[i].fd, &one, sizeof(one)) != sizeof(one) && errno != EAGAIN )
+                  DBG("subscription notifier thread: cannot signal fd %i: %s", subs->sub[i].fd, strerror(errno));
+              }
+          break;
+        }
+      for ( j = 0; j < n; j++ )
+        {
+          i = entry[j];
+          // skip entries that have been unsubscribed meanwhile
+          if ( changed[j] == 0 || subs->sub[i].fd != fds[j] || subs->sub[i].oid != oids[j] )
+            continue;
+          if ( changed[j] > 0 )
+            {
+              // continue after the latest commit, the subscriber reads that one
+              do
+                err = kogmo_rtdb_obj_readdata (db_h, oids[j], 0, &base_obj, sizeof(base_obj));
+              while ( err == -KOGMO_RTDB_ERR_HISTWRAP );
+              changed[j] = err >= 0 ? 1 : -1;
+              if ( err >= 0 )
+                subs->sub[i].old_ts = base_obj.base.committed_ts;
+            }
+          if ( changed[j] < 0 )
+            subs->sub[i].oid = 0; // a last event for the deletion
+          if ( write (subs->sub[i].fd, &one, sizeof(one)) != sizeof(one) && errno != EAGAIN )
+            DBG("subscription notifier thread: cannot signal fd %i: %s", subs->sub[i].fd, strerror(errno));
+        }
+    }
+  pthread_mutex_unlock (&subs->lock);
+
+  DBGL (DBGL_API,"subscription notifier thread stopped");
+  return NULL;
+}
+
+int
+kogmo_rtdb_obj_subscribe_fd (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objid_t oid)
+{
+  struct kogmo_rtdb_obj_subscriptions_t *subs;
+  kogmo_rtdb_obj_info_t objinfo;
+  kogmo_rtdb_obj_base_t base_obj;
+  kogmo_rtdb_objsize_t err;
+  sigset_t allsigs, oldsigs;
+  int i, fd, ret;
+
+  CHK_DBH("kogmo_rtdb_obj_subscribe_fd",db_h,0);
+
+  DBGL (DBGL_API,"kogmo_rtdb_obj_subscribe_fd(oid %i)", oid);
+
+  // the object must exist and be readable, events are for commits after now
+  err = kogmo_rtdb_obj_readinfo (db_h, oid, 0, &objinfo);
+  if ( err < 0 )
+    return err;
+  do
+    err = kogmo_rtdb_obj_readdata (db_h, oid, 0, &base_obj, sizeof(base_obj));
+  while ( err == -KOGMO_RTDB_ERR_HISTWRAP );
+  if ( err == -KOGMO_RTDB_ERR_NOTFOUND )
+    base_obj.base.committed_ts = 0; // no data yet
+  else if ( err < 0 )
+    return err;
+
+  if ( db_h->subscriptions == NULL )
+    {
+      subs = malloc ( sizeof (struct kogmo_rtdb_obj_subscriptions_t) );
+      if ( subs == NULL )
+        return -KOGMO_RTDB_ERR_NOMEMORY;
+      memset (subs, 0, sizeof (struct kogmo_rtdb_obj_subscriptions_t));
+      for ( i = 0; i < KOGMO_RTDB_OBJ_SUBSCRIBE_MAX; i++ )
+        subs->sub[i].fd = -1;
+      pthread_mutex_init (&subs->lock, NULL); // process-local
+      pthread_cond_init (&subs->change, NULL);
+      db_h->subscriptions = subs;
+      // signals go to the threads of the application, not to the notifier
+      sigfillset (&allsigs);
+      pthread_sigmask (SIG_SETMASK, &allsigs, &oldsigs);
+      ret = pthread_create (&subs->thread, NULL, kogmo_rtdb_obj_subscribe_thread, db_h);
+      pthread_sigmask (SIG_SETMASK, &oldsigs, NULL);
+      if ( ret != 0 )
+        {
+          ERR("cannot start the subscription notifier thread: %s",strerror(ret));
+          db_h->subscriptions = NULL;
+          pthread_cond_destroy (&subs->change);
+          pthread_mutex_destroy (&subs->lock);
+          free (subs);
+          return -KOGMO_RTDB_ERR_NOMEMORY;
+        }
+    }
+  subs = db_h->subscriptions;
+
+  fd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if ( fd < 0 )
+    {
+      DBG("cannot create an eventfd: %s",strerror(errno));
+      return -KOGMO_RTDB_ERR_NOMEMORY;
+    }
+
+  pthread_mutex_lock (&subs->lock);
+  if ( subs->dead )
+    {
+      pthread_mutex_unlock (&subs->lock);
+      close (fd);
+      DBGL (DBGL_MSG,"the subscription notifier thread has failed, reconnect to subscribe again");
+      return -KOGMO_RTDB_ERR_UNKNOWN;
+    }
+  for ( i = 0; i < KOGMO_RTDB_OBJ_SUBSCRIBE_MAX; i++ )
+    if ( subs->sub[i].fd < 0 )
+      break;
+  if ( i >= KOGMO_RTDB_OBJ_SUBSCRIBE_MAX )
+    {
+      pthread_mutex_unlock (&subs->lock);
+      close (fd);
+      DBGL (DBGL_MSG,"too many subscriptions, the maximum is %i", KOGMO_RTDB_OBJ_SUBSCRIBE_MAX);
+      return -KOGMO_RTDB_ERR_OUTOFOBJ;
+    }
+  subs->sub[i].fd = fd;
+  subs->sub[i].oid = oid;
+  subs->sub[i].old_ts = base_obj.base.committed_ts;
+  kogmo_rtdb_obj_subscribe_changed (db_h);
+  pthread_mutex_unlock (&subs->lock);
+
+  return fd;
+}
+
+int
+kogmo_rtdb_obj_unsubscribe_fd (kogmo_rtdb_handle_t *db_h, int fd)
+{
+  struct kogmo_rtdb_obj_subscriptions_t *subs = db_h->subscriptions;
+  int i;
+
+  CHK_DBH("kogmo_rtdb_obj_unsubscribe_fd",db_h,0);
+
+  DBGL (DBGL_API,"kogmo_rtdb_obj_unsubscribe_fd(fd %i)", fd);
+
+  if ( subs == NULL || fd < 0 )
+    return -KOGMO_RTDB_ERR_INVALID;
+
+  pthread_mutex_lock (&subs->lock);
+  for ( i = 0; i < KOGMO_RTDB_OBJ_SUBSCRIBE_MAX; i++ )
+    if ( subs->sub[i].fd == fd )
+      break;
+  if ( i >= KOGMO_RTDB_OBJ_SUBSCRIBE_MAX )
+    {
+      pthread_mutex_unlock (&subs->lock);
+      return -KOGMO_RTDB_ERR_INVALID;
+    }
+  subs->sub[i].fd = -1;
+  subs->sub[i].oid = 0;
+  close (fd);
+  kogmo_rtdb_obj_subscribe_changed (db_h);
+  pthread_mutex_unlock (&subs->lock);
+
+  return 0;
+}
+
+void
+kogmo_rtdb_obj_subscribe_destroy (kogmo_rtdb_handle_t *db_h)
+{
+  struct kogmo_rtdb_obj_subscriptions_t *subs = db_h->subscriptions;
+  int i;
+
+  if ( subs == NULL )
+    return;
+
+  pthread_mutex_lock (&subs->lock);
+  subs->stop = 1;
+  kogmo_rtdb_obj_subscribe_changed (db_h);
+  pthread_mutex_unlock (&subs->lock);
+
+  // the thread itself can get here through the exit handler
+  if ( pthread_equal (subs->thread, pthread_self ()) )
+    return;
+  pthread_join (subs->thread, NULL);
+
+  for ( i = 0; i < KOGMO_RTDB_OBJ_SUBSCRIBE_MAX; i++ )
+    if ( subs->sub[i].fd >= 0 )
+      close (subs->sub[i].fd);
+  pthread_cond_destroy (&subs->change);
+  pthread_mutex_destroy (&subs->lock);
+  free (subs);
+  db_h->subscriptions = NULL;
+}
+
+#else /* KOGMO_RTDB_OBJ_SUBSCRIBE_EVENTFD */
+
+int
+kogmo_rtdb_obj_subscribe_fd (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objid_t oid)
+{
+  DBGL (DBGL_MSG,"kogmo_rtdb_obj_subscribe_fd: no eventfds on this system");
+  return -KOGMO_RTDB_ERR_UNKNOWN;
+}
+
+int
+kogmo_rtdb_obj_unsubscribe_fd (kogmo_rtdb_handle_t *db_h, int fd)
+{
+  return -KOGMO_RTDB_ERR_INVALID;
+}
+
+void
+kogmo_rtdb_obj_subscribe_destroy (kogmo_rtdb_handle_t *db_h)
+{
+}
+
+#endif /* KOGMO_RTDB_OBJ_SUBSCRIBE_EVENTFD */
@@ -13,6 +13,7 @@
  */
 
 #include "kogmo_rtdb_internal.h"
+#include <ctype.h>
 
  /* ******************** OBJECT MANAGEMENT ******************** */
 
@@ -37,78 +38,218 @@ kogmo_rtdb_obj_initinfo (kogmo_rtdb_handle_t *db_h,
 }
 
 
-kogmo_rtdb_objid_t
-_kogmo_rtdb_obj_searchinfo(kogmo_rtdb_handle_t *db_h,
-                           _const char *name,
-                           kogmo_rtdb_objtype_t otype,
-                           kogmo_rtdb_objid_t parent_oid,
-                           kogmo_rtdb_objid_t proc_oid,
-                           kogmo_timestamp_t ts,
-                           kogmo_rtdb_objid_list_t idlist,
-                           int nth, int nolock, int includedeleted)
+/* ******************** SEARCH PATTERNS ******************** */
+
+void
+kogmo_rtdb_regex_cache_init (kogmo_rtdb_handle_t *db_h)
 {
-  int i=-1;
-  kogmo_rtdb_obj_info_t *scan_objmeta_p;
-  int regex = 0;
-  regex_t re;
-  int nfound = 0;
-  kogmo_rtdb_objid_t oid = 0;
-  char searchname[KOGMO_RTDB_OBJMETA_NAME_MAXLEN];
+  memset (db_h->regex_cache, 0, sizeof (db_h->regex_cache));
+  db_h->regex_cache_clock = 0;
+  pthread_mutex_init (&db_h->regex_cache_lock, NULL); // process-local
+}
 
-  DBGL (DBGL_API,"kogmo_rtdb_obj_searchinfo(%s, 0x%llX, %lli, %lli, %lli,, %i)",
-                 name, (long long)otype, (long long)parent_oid,
-                 (long long)proc_oid, (long long)ts, nth);
+void
+kogmo_rtdb_regex_cache_destroy (kogmo_rtdb_handle_t *db_h)
+{
+  int i;
+  pthread_mutex_lock (&db_h->regex_cache_lock);
+  for ( i = 0; i < KOGMO_RTDB_REGEX_CACHE_SIZE; i++ )
+    {
+      if ( db_h->regex_cache[i].pattern == NULL )
+        continue;
+      regfree (&db_h->regex_cache[i].re);
+      free (db_h->regex_cache[i].pattern);
+      db_h->regex_cache[i].pattern = NULL;
+    }
+  pthread_mutex_unlock (&db_h->regex_cache_lock);
+}
+
+// get a compiled pattern from the cache, compile it and replace the least
+// recently used entry if not found. the entry is in use until regex_cache_put().
+// if all entries are in use, the pattern is compiled into *tmp_re_p.
+// (the cache lock is not held during the search, because searchinfo_nolock()
+// can be called with objmeta_lock held)
+static regex_t *
+regex_cache_get (kogmo_rtdb_handle_t *db_h, _const char *pattern, regex_t *tmp_re_p)
+{
+  int i, victim = -1;
+  struct kogmo_rtdb_regex_cache_t *entry_p;
+
+  pthread_mutex_lock (&db_h->regex_cache_lock);
+  db_h->regex_cache_clock++;
+  for ( i = 0; i < KOGMO_RTDB_REGEX_CACHE_SIZE; i++ )
+    {
+      entry_p = &db_h->regex_cache[i];
+      if ( entry_p->pattern != NULL && strcmp (entry_p->pattern, pattern) == 0 )
+        {
+          entry_p->lastuse = db_h->regex_cache_clock;
+          entry_p->users++;
+          pthread_mutex_unlock (&db_h->regex_cache_lock);
+          return &entry_p->re;
+        }
+      if ( entry_p->users )
+        continue;
+      if ( victim < 0 || entry_p->pattern == NULL ||
+           ( db_h->regex_cache[victim].pattern != NULL &&
+             entry_p->lastuse < db_h->regex_cache[victim].lastuse ) )
+        victim = i;
+    }
+
+  if ( victim < 0 )
+    {
+      pthread_mutex_unlock (&db_h->regex_cache_lock);
+      if ( regcomp (tmp_re_p, pattern, REG_EXTENDED|REG_NOSUB|REG_ICASE) != 0 )
+        return NULL;
+      return tmp_re_p;
+    }
+
+  entry_p = &db_h->regex_cache[victim];
+  if ( entry_p->pattern != NULL )
+    {
+      regfree (&entry_p->re);
+      free (entry_p->pattern);
+      entry_p->pattern = NULL;
+    }
+  if ( regcomp (&entry_p->re, pattern, REG_EXTENDED|REG_NOSUB|REG_ICASE) != 0 )
+    {
+      pthread_mutex_unlock (&db_h->regex_cache_lock);
+      return NULL;
+    }
+  entry_p->pattern = strdup (pattern);
+  if ( entry_p->pattern == NULL )
+    {
+      regfree (&entry_p->re);
+      pthread_mutex_unlock (&db_h->regex_cache_lock);
+      return NULL;
+    }
+  entry_p->lastuse = db_h->regex_cache_clock;
+  entry_p->users = 1;
+  pthread_mutex_unlock (&db_h->regex_cache_lock);
+  return &entry_p->re;
+}
 
-  if ( name != NULL && name[0] == '~' )
+static void
+regex_cache_put (kogmo_rtdb_handle_t *db_h, regex_t *re_p, regex_t *tmp_re_p)
+{
+  int i;
+  if ( re_p == tmp_re_p )
     {
-      regmatch_t re_match[1];
-      oid = 0;
+      regfree (tmp_re_p);
+      return;
+    }
+  pthread_mutex_lock (&db_h->regex_cache_lock);
+  for ( i = 0; i < KOGMO_RTDB_REGEX_CACHE_SIZE; i++ )
+    if ( re_p == &db_h->regex_cache[i].re && db_h->regex_cache[i].users )
+      db_h->regex_cache[i].users--;
+  pthread_mutex_unlock (&db_h->regex_cache_lock);
+}
+
+// parse a number at the end of a name: <open>NUMBER<close> followed by blanks,
+// NUMBER can be decimal, octal (leading 0) or hex (0x..).
+// close may be '\0' for none.
+// returns the position of <open> and the number in *value_p, or -1 if not found
+static int
+parse_name_suffix (_const char *name, char open, char close, long long int *value_p)
+{
+  int start, end = strlen (name);
+
+  while ( end > 0 && name[end-1] == ' ' )
+    end--;
+  if ( close != '\0' )
+    {
+      if ( end == 0 || name[end-1] != close )
+        return -1;
+      end--;
+    }
+
+  start = end;
+  while ( start > 0 && isxdigit ( (unsigned char) name[start-1] ) )
+    start--;
+  if ( start < end && start >= 2 && ( name[start-1] == 'x' || name[start-1] == 'X' )
+       && name[start-2] == '0' )
+    {
+      start -= 2; // hex
+    }
+  else
+    {
+      start = end;
+      while ( start > 0 && isdigit ( (unsigned char) name[start-1] ) )
+        start--;
+      if ( start == end )
+        return -1;
+    }
+
+  if ( start == 0 || name[start-1] != open )
+    return -1;
+  *value_p = strtoll (&name[start], NULL, 0);
+  return start-1;
+}
+
+
+// index that is scanned by a search
+#define SEARCH_FULLSCAN 0 // slot order, for regular expressions and all-objects queries
+#define SEARCH_BYNAME   1
+#define SEARCH_BYPARENT 2
+#define SEARCH_BYTYPE   3
+#define SEARCH_BYOID    4 // direct oid in the name, no scan
+
+#define SEARCH_STATE_RUNNING  1
+#define SEARCH_STATE_FINISHED 2
+
+// number of slots a search cursor visits before it releases objmeta_lock
+#define SEARCH_CHUNK_SLOTS 1024
+
+// internal: parse the search parameters into a search cursor
+static int
+searchinfo_prepare (kogmo_rtdb_handle_t *db_h,
+                    kogmo_rtdb_obj_search_t *search_p,
+                    _const char *name,
+                    kogmo_rtdb_objtype_t otype,
+                    kogmo_rtdb_objid_t parent_oid,
+                    kogmo_rtdb_objid_t proc_oid,
+                    kogmo_timestamp_t ts,
+                    int flags)
+{
+  int namelen = 0;
+
+  memset (search_p, 0, sizeof (kogmo_rtdb_obj_search_t));
+  search_p->otype = otype;
+  search_p->parent_oid = parent_oid;
+  search_p->proc_oid = proc_oid;
+  search_p->ts = ts;
+  search_p->flags = flags;
+  search_p->slot = -1;
+
+  if ( name == NULL )
+    name = "";
+
+  if ( name[0] == '~' )
+    {
+      long long int value;
+      int pos;
 
       // a direct OID can be given as: ~(42) ~BlaBla(42) ~(0x2A) ~(052)
-      if ( regcomp (&re, "\\(([0-9][0-9]*|0[xX]([0-9a-fA-F][0-9a-fA-F]*))\\) *$", REG_EXTENDED) != 0)
-        return -KOGMO_RTDB_ERR_INVALID;
-      if ( regexec(&re, name, (size_t) 1, re_match, 0) == 0 && re_match[0].rm_so >= 0 )
-        oid = strtoll(&name[re_match[0].rm_so+1],NULL,0);
-      regfree(&re);
-      if ( oid )
+      if ( parse_name_suffix (name, '(', ')', &value) >= 0 && value != 0 )
         {
-          if ( kogmo_rtdb_obj_findmeta_byid (db_h, oid ) == NULL )
-            return -KOGMO_RTDB_ERR_NOTFOUND;
-          nfound = 1;
-          if ( idlist == NULL && nth == nfound )
-            return oid;
-          if ( idlist == NULL && nth != nfound )
-            return -KOGMO_RTDB_ERR_NOTFOUND;
-          if ( KOGMO_RTDB_OBJIDLIST_MAX >= 1 ) // we do not assume its >= 2, will be optimized away by the compiler
-            idlist[0] = oid;
-          if ( KOGMO_RTDB_OBJIDLIST_MAX >= 2 ) // dito
-            idlist[1] = 0;
-          return nfound;
+          search_p->index = SEARCH_BYOID;
+          search_p->oid = value;
+          return 0;
         }
 
       // a Type-ID can be given as: ~BlaBla#42 ~BlaBla#0xC30003
-      if ( regcomp (&re, "\\#([0-9][0-9]*|0[xX]([0-9a-fA-F][0-9a-fA-F]*)) *$", REG_EXTENDED) != 0)
-        return -KOGMO_RTDB_ERR_INVALID;
-      if ( regexec(&re, name, (size_t) 1, re_match, 0) == 0 && re_match[0].rm_so >= 0 )
+      pos = parse_name_suffix (name, '#', '\0', &value);
+      if ( pos >= 0 && pos < KOGMO_RTDB_SEARCH_NAME_MAXLEN )
         {
-          otype = strtoll(&name[re_match[0].rm_so+1],NULL,0);
-          strncpy(searchname,name,sizeof(searchname));
-          searchname[re_match[0].rm_so]='\0';
-          name = searchname;
-          printf("type: %i %x s.%s.\n", otype,otype,name);
+          search_p->otype = value;
+          namelen = pos;
         }
-      regfree(&re);
-
-      if ( regcomp (&re, &name[1], REG_EXTENDED|REG_NOSUB|REG_ICASE) != 0)
-        return -KOGMO_RTDB_ERR_INVALID;
-      regex = 1;
     }
 
-  if ( kogmo_rtdb_debug && !regex && name && getenv ("KOGMO_RTDB_NAMEREMAP") ) // syntax: KOGMO_RTDB_NAMEREMAP=origname=newname,origname2=newname2,...
+  if ( kogmo_rtdb_debug && name[0] != '~' && getenv ("KOGMO_RTDB_NAMEREMAP") ) // syntax: KOGMO_RTDB_NAMEREMAP=origname=newname,origname2=newname2,...
     {
       char *q, *p = getenv ("KOGMO_RTDB_NAMEREMAP");
-      int namelen = strlen ( name );
       int len;
+      namelen = strlen ( name );
       while ( p != NULL && p[0] != '\0' ) // until terminating NUL
         {
           q = strchr( p, '=' );
@@ -122,11 +263,10 @@ _kogmo_rtdb_obj_searchinfo(kogmo_rtdb_handle_t *db_h,
                 len = p-q;
               else
                 len = strlen ( q );
-              if ( len > (int)(sizeof(searchname)) )
-                len = sizeof(searchname); // error! remapped name to long!
-              strncpy(searchname, q, len);
-              searchname[len] = '\0'; // ensure NUL termination
-              name = searchname;
+              if ( len >= KOGMO_RTDB_OBJMETA_NAME_MAXLEN )
+                len = KOGMO_RTDB_OBJMETA_NAME_MAXLEN-1; // error! remapped name to long!
+              name = q;
+              namelen = len;
               break;
             }
           p = strchr( q, ',' );
@@ -134,54 +274,194 @@ _kogmo_rtdb_obj_searchinfo(kogmo_rtdb_handle_t *db_h,
         }
     }
 
-  if (!nolock)
-    kogmo_rtdb_objmeta_lock(db_h);
+  if ( namelen == 0 )
+    namelen = strlen ( name );
+  if ( namelen >= KOGMO_RTDB_SEARCH_NAME_MAXLEN )
+    return -KOGMO_RTDB_ERR_INVALID;
+  memcpy (search_p->name, name, namelen);
+  search_p->name[namelen] = '\0';
+
+  // use the name, parent or type index if possible, the chains are ordered by oid
+  // (a full scan returns the objects in the order of their slots)
+  if ( search_p->name[0] != '\0' && search_p->name[0] != '~' )
+    search_p->index = SEARCH_BYNAME;
+  else if ( search_p->parent_oid != 0 )
+    search_p->index = SEARCH_BYPARENT;
+  else if ( search_p->otype != 0 )
+    search_p->index = SEARCH_BYTYPE;
+  else
+    search_p->index = SEARCH_FULLSCAN;
+  return 0;
+}
 
-  while ( ++i < KOGMO_RTDB_OBJ_MAX )
+// internal: next[] of the chains of the index used by a search, NULL for a full scan
+static int32_t *
+searchinfo_chain (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_obj_search_t *search_p)
+{
+  switch ( search_p->index )
     {
-      scan_objmeta_p = &db_h->localdata_p->objmeta[i];
+      case SEARCH_BYNAME:   return db_h->objmeta_name_next;
+      case SEARCH_BYPARENT: return db_h->objmeta_parent_next;
+      case SEARCH_BYTYPE:   return db_h->objmeta_type_next;
+      default:              return NULL;
+    }
+}
 
-      // skip empty slots
-      if ( scan_objmeta_p->oid == 0 || scan_objmeta_p->created_ts == 0 )
-          continue;
+// internal: first slot to visit for a search, -1 if there is none
+static int
+searchinfo_first (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_obj_search_t *search_p)
+{
+  struct kogmo_rtdb_obj_local_t *l = db_h->localdata_p;
+  switch ( search_p->index )
+    {
+      case SEARCH_BYNAME:
+        return l->objmeta_name_hash[kogmo_rtdb_obj_hash_name (search_p->name)] - 1;
+      case SEARCH_BYPARENT:
+        return l->objmeta_parent_hash[kogmo_rtdb_obj_hash_parent (search_p->parent_oid)] - 1;
+      case SEARCH_BYTYPE:
+        return l->objmeta_type_hash[kogmo_rtdb_obj_hash_type (search_p->otype)] - 1;
+      default:
+        return 0;
+    }
+}
 
-      // skip objects with wrong type if type-parameter is set
-      if ( scan_objmeta_p->otype != otype && otype != 0 )
-          continue;
+// internal: whether a slot is still linked into the chain a search scans
+static int
+searchinfo_inchain (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_obj_search_t *search_p, int i)
+{
+  kogmo_rtdb_obj_info_t *scan_objmeta_p = &db_h->objmeta[i];
+  switch ( search_p->index )
+    {
+      case SEARCH_BYNAME:
+        return db_h->objmeta_name_prev[i] != 0 &&
+               kogmo_rtdb_obj_hash_name (scan_objmeta_p->name) == kogmo_rtdb_obj_hash_name (search_p->name);
+      case SEARCH_BYPARENT:
+        return db_h->objmeta_parent_prev[i] != 0 &&
+               kogmo_rtdb_obj_hash_parent (scan_objmeta_p->parent_oid) == kogmo_rtdb_obj_hash_parent (search_p->parent_oid);
+      case SEARCH_BYTYPE:
+        return db_h->objmeta_type_prev[i] != 0 &&
+               kogmo_rtdb_obj_hash_type (scan_objmeta_p->otype) == kogmo_rtdb_obj_hash_type (search_p->otype);
+      default:
+        return 1;
+    }
+}
 
-      // skip objects with wrong parent if parent-parameter is set
-      if ( scan_objmeta_p->parent_oid != parent_oid && parent_oid != 0 )
-          continue;
+// internal: whether the object in a slot matches a search
+static int
+searchinfo_match (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_obj_search_t *search_p,
+                  regex_t *re_p, int i)
+{
+  // filter on the hot table, only matching objects touch their full metadata
+  struct kogmo_rtdb_obj_hot_t *scan_objhot_p = &db_h->objhot[i];
+  kogmo_rtdb_obj_info_t *scan_objmeta_p;
 
-      // skip objects with wrong creator if creator-parameter is set
-      if ( scan_objmeta_p->created_proc != proc_oid && proc_oid != 0 )
-          continue;
+  // skip empty slots
+  if ( scan_objhot_p->oid == 0 || scan_objhot_p->created_ts == 0 )
+      return 0;
 
-      // skip deleted objects if time-parameter is not set
-      // skip deleted objects if time-parameter is set and
-      // the object didn't exist at the given time
-      // (warning: don't use "deleted_ts <= ts"! otherwise a trace reader won't find
-      // a deleted object!)
-      if ( scan_objmeta_p->deleted_ts != 0 && !includedeleted )
-        if ( scan_objmeta_p->deleted_ts < ts || ts == 0 )
-          continue;
+  // skip objects with wrong type if type-parameter is set
+  if ( scan_objhot_p->otype != search_p->otype && search_p->otype != 0 )
+      return 0;
 
-      // skip not yet created objects if time-parameter is set
-      if ( scan_objmeta_p->created_ts > ts && ts != 0 )
-          continue;
+  // skip objects with wrong parent if parent-parameter is set
+  if ( scan_objhot_p->parent_oid != search_p->parent_oid && search_p->parent_oid != 0 )
+      return 0;
 
-      // skip if regex doesn't match and regex-parameter is set
-      if ( regex &&
-           ( regexec(&re, scan_objmeta_p->name, (size_t) 0, NULL, 0) != 0 ) )
-          continue;
+  // skip objects with wrong creator if creator-parameter is set
+  if ( scan_objhot_p->created_proc != search_p->proc_oid && search_p->proc_oid != 0 )
+      return 0;
+
+  // skip deleted objects if time-parameter is not set
+  // skip deleted objects if time-parameter is set and
+  // the object didn't exist at the given time
+  // (warning: don't use "deleted_ts <= ts"! otherwise a trace reader won't find
+  // a deleted object!)
+  if ( scan_objhot_p->deleted_ts != 0 && !( search_p->flags & KOGMO_RTDB_SEARCH_FLAGS_DELETED ) )
+    if ( scan_objhot_p->deleted_ts < search_p->ts || search_p->ts == 0 )
+      return 0;
+
+  // skip not yet created objects if time-parameter is set
+  if ( scan_objhot_p->created_ts > search_p->ts && search_p->ts != 0 )
+      return 0;
+
+  scan_objmeta_p = &db_h->objmeta[i];
+
+  // skip if regex doesn't match and regex-parameter is set
+  if ( re_p != NULL &&
+       ( regexec(re_p, scan_objmeta_p->name, (size_t) 0, NULL, 0) != 0 ) )
+      return 0;
+
+  // skip if name doesn't match and no regex and name is not empty
+  if ( re_p == NULL && search_p->name[0] != '\0' &&
+       ( strncmp (search_p->name, scan_objmeta_p->name, KOGMO_RTDB_OBJMETA_NAME_MAXLEN) != 0 ) )
+      return 0;
+
+  return 1;
+}
 
-      // skip if name doesn't match and no regex and name is not empty
-      if ( !regex && name != NULL && name[0] != '\0' &&
-           ( strncmp (name, scan_objmeta_p->name, KOGMO_RTDB_OBJMETA_NAME_MAXLEN) != 0 ) )
+
+kogmo_rtdb_objid_t
+_kogmo_rtdb_obj_searchinfo(kogmo_rtdb_handle_t *db_h,
+                           _const char *name,
+                           kogmo_rtdb_objtype_t otype,
+                           kogmo_rtdb_objid_t parent_oid,
+                           kogmo_rtdb_objid_t proc_oid,
+                           kogmo_timestamp_t ts,
+                           kogmo_rtdb_objid_list_t idlist,
+                           int nth, int nolock, int includedeleted)
+{
+  int i, err;
+  kogmo_rtdb_obj_search_t search;
+  int32_t *chain_next;
+  regex_t *re_p = NULL, tmp_re;
+  int nfound = 0;
+  kogmo_rtdb_objid_t oid = 0;
+
+  DBGL (DBGL_API,"kogmo_rtdb_obj_searchinfo(%s, 0x%llX, %lli, %lli, %lli,, %i)",
+                 name, (long long)otype, (long long)parent_oid,
+                 (long long)proc_oid, (long long)ts, nth);
+
+  err = searchinfo_prepare (db_h, &search, name, otype, parent_oid, proc_oid, ts,
+                            includedeleted ? KOGMO_RTDB_SEARCH_FLAGS_DELETED : 0);
+  if ( err < 0 )
+    return err;
+
+  if ( search.index == SEARCH_BYOID )
+    {
+      oid = search.oid;
+      if ( kogmo_rtdb_obj_findhot_byid (db_h, oid ) == NULL )
+        return -KOGMO_RTDB_ERR_NOTFOUND;
+      nfound = 1;
+      if ( idlist == NULL && nth == nfound )
+        return oid;
+      if ( idlist == NULL && nth != nfound )
+        return -KOGMO_RTDB_ERR_NOTFOUND;
+      if ( KOGMO_RTDB_OBJIDLIST_MAX >= 1 ) // we do not assume its >= 2, will be optimized away by the compiler
+        idlist[0] = oid;
+      if ( KOGMO_RTDB_OBJIDLIST_MAX >= 2 ) // dito
+        idlist[1] = 0;
+      return nfound;
+    }
+
+  if ( search.name[0] == '~' )
+    {
+      re_p = regex_cache_get (db_h, &search.name[1], &tmp_re);
+      if ( re_p == NULL )
+        return -KOGMO_RTDB_ERR_INVALID;
+    }
+
+  if (!nolock)
+    kogmo_rtdb_objmeta_lock(db_h);
+
+  chain_next = searchinfo_chain (db_h, &search);
+  for ( i = searchinfo_first (db_h, &search); i >= 0 && i < (int)db_h->obj_max;
+          i = chain_next ? chain_next[i] - 1 : i + 1 )
+    {
+      if ( !searchinfo_match (db_h, &search, re_p, i) )
           continue;
 
       // found!!! this is a match
-      oid = scan_objmeta_p->oid;
+      oid = db_h->objhot[i].oid;
       nfound++;
 
       // insert match into result-list if given and there's space
@@ -192,10 +472,10 @@ _kogmo_rtdb_obj_searchinfo(kogmo_rtdb_handle_t *db_h,
       if ( nth == nfound )
         break;
     }
-  if ( regex )
-    regfree(&re);
   if (!nolock)
     kogmo_rtdb_objmeta_unlock(db_h);
+  if ( re_p != NULL )
+    regex_cache_put (db_h, re_p, &tmp_re);
   if ( nfound == 0 )
     {
       kogmo_rtdb_obj_info_t *scan_objmeta_p;
@@ -273,6 +553,149 @@ kogmo_rtdb_obj_searchinfo_deleted (kogmo_rtdb_handle_t *db_h,
 
 
 
+int
+kogmo_rtdb_obj_searchinfo_begin (kogmo_rtdb_handle_t *db_h,
+                                 kogmo_rtdb_obj_search_t *search_p,
+                                 _const char *name,
+                                 kogmo_rtdb_objtype_t otype,
+                                 kogmo_rtdb_objid_t parent_oid,
+                                 kogmo_rtdb_objid_t proc_oid,
+                                 kogmo_timestamp_t ts,
+                                 int flags)
+{
+  regex_t *re_p, tmp_re;
+  int err;
+
+  CHK_DBH("kogmo_rtdb_obj_searchinfo_begin",db_h,0);
+  CHK_PTR(search_p);
+
+  DBGL (DBGL_API,"kogmo_rtdb_obj_searchinfo_begin(%s, 0x%llX, %lli, %lli, %lli, 0x%X)",
+                 name, (long long)otype, (long long)parent_oid,
+                 (long long)proc_oid, (long long)ts, flags);
+
+  err = searchinfo_prepare (db_h, search_p, name, otype, parent_oid, proc_oid, ts, flags);
+  if ( err < 0 )
+    return err;
+
+  // check the regular expression now, it is compiled again by each _next()
+  // (normally from the cache)
+  if ( search_p->name[0] == '~' && search_p->index != SEARCH_BYOID )
+    {
+      re_p = regex_cache_get (db_h, &search_p->name[1], &tmp_re);
+      if ( re_p == NULL )
+        return -KOGMO_RTDB_ERR_INVALID;
+      regex_cache_put (db_h, re_p, &tmp_re);
+    }
+
+  search_p->state = SEARCH_STATE_RUNNING;
+  return 0;
+}
+
+
+// internal: slot where a search cursor continues.
+// the chains are ordered by oid, so if the last visited slot has been
+// removed from its chain meanwhile, the search continues with the first
+// object in the chain that has a higher oid.
+static int
+searchinfo_resume (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_obj_search_t *search_p)
+{
+  int32_t *chain_next = searchinfo_chain (db_h, search_p);
+  int i = search_p->slot;
+
+  if ( i < 0 )
+    return searchinfo_first (db_h, search_p);
+  if ( chain_next == NULL )
+    return i + 1;
+  if ( db_h->objmeta[i].oid == search_p->oid && searchinfo_inchain (db_h, search_p, i) )
+    return chain_next[i] - 1;
+
+  DBG("searchinfo_next: slot %i has been removed, searching for oid > %i", i, search_p->oid);
+  for ( i = searchinfo_first (db_h, search_p); i >= 0 && i < (int)db_h->obj_max;
+          i = chain_next[i] - 1 )
+    {
+      if ( db_h->objmeta[i].oid > search_p->oid )
+        break;
+    }
+  return i;
+}
+
+
+int
+kogmo_rtdb_obj_searchinfo_next (kogmo_rtdb_handle_t *db_h,
+                                kogmo_rtdb_obj_search_t *search_p,
+                                kogmo_rtdb_objid_t *oids,
+                                int n)
+{
+  int i, visited, nfound = 0;
+  int32_t *chain_next;
+  regex_t *re_p = NULL, tmp_re;
+
+  CHK_DBH("kogmo_rtdb_obj_searchinfo_next",db_h,0);
+  CHK_PTR(search_p);
+  CHK_PTR(oids);
+
+  if ( n <= 0 || search_p->state == 0 )
+    return -KOGMO_RTDB_ERR_INVALID;
+  if ( search_p->state == SEARCH_STATE_FINISHED )
+    return 0;
+
+  if ( search_p->index == SEARCH_BYOID )
+    {
+      search_p->state = SEARCH_STATE_FINISHED;
+      if ( kogmo_rtdb_obj_findhot_byid (db_h, search_p->oid ) == NULL )
+        return 0;
+      oids[0] = search_p->oid;
+      return 1;
+    }
+
+  if ( search_p->name[0] == '~' )
+    {
+      re_p = regex_cache_get (db_h, &search_p->name[1], &tmp_re);
+      if ( re_p == NULL )
+        return -KOGMO_RTDB_ERR_INVALID;
+    }
+
+  chain_next = searchinfo_chain (db_h, search_p);
+
+  // visit the slots in chunks, others can modify the objects in between
+  while ( nfound < n && search_p->state == SEARCH_STATE_RUNNING )
+    {
+      kogmo_rtdb_objmeta_lock(db_h);
+      for ( i = searchinfo_resume (db_h, search_p), visited = 0;
+            i >= 0 && i < (int)db_h->obj_max && visited < SEARCH_CHUNK_SLOTS && nfound < n;
+            i = chain_next ? chain_next[i] - 1 : i + 1, visited++ )
+        {
+          search_p->slot = i;
+          search_p->oid = db_h->objmeta[i].oid;
+          if ( searchinfo_match (db_h, search_p, re_p, i) )
+            oids[nfound++] = db_h->objhot[i].oid;
+        }
+      if ( i < 0 || i >= (int)db_h->obj_max )
+        search_p->state = SEARCH_STATE_FINISHED;
+      kogmo_rtdb_objmeta_unlock(db_h);
+    }
+
+  if ( re_p != NULL )
+    regex_cache_put (db_h, re_p, &tmp_re);
+
+  DBGL (DBGL_API,"kogmo_rtdb_obj_searchinfo_next() = %i%s", nfound,
+        search_p->state == SEARCH_STATE_FINISHED ? " (finished)" : "");
+  return nfound;
+}
+
+
+int
+kogmo_rtdb_obj_searchinfo_end (kogmo_rtdb_handle_t *db_h,
+                               kogmo_rtdb_obj_search_t *search_p)
+{
+  CHK_DBH("kogmo_rtdb_obj_searchinfo_end",db_h,0);
+  CHK_PTR(search_p);
+  search_p->state = 0;
+  return 0;
+}
+
+
+
 
 kogmo_rtdb_objid_t
 kogmo_rtdb_obj_insert (kogmo_rtdb_handle_t *db_h,
@@ -282,16 +705,18 @@ kogmo_rtdb_obj_insert (kogmo_rtdb_handle_t *db_h,
   int found_slot = -1, purge_retry = 0;
   float cycle_time;
   kogmo_rtdb_obj_info_t *scan_objmeta_p, *tmp_objmeta_p;
-  kogmo_rtdb_objid_t free_oid,scan_oid,tmp_oid;
+  struct kogmo_rtdb_obj_hot_t *scan_objhot_p, *tmp_objhot_p;
+  kogmo_rtdb_objid_t free_oid,scan_oid;
   kogmo_timestamp_t ts,scan_delete_ts;
   kogmo_rtdb_objsize_t new_allocated_heap_idx=0;
+  int numa_node = -1;
 
   CHK_DBH("kogmo_rtdb_obj_insert",db_h,0);
   CHK_PTR(metadata_p);
 
   ts = kogmo_rtdb_timestamp_now (db_h);
 
-//  DxBGL (DBGL_API,"obj_insert(%p = %s, db_h=%p,%p)", metadata_p, metadata_p->name,db_h,&db_h->localdata_p->objmeta[0]);
+//  DxBGL (DBGL_API,"obj_insert(%p = %s, db_h=%p,%p)", metadata_p, metadata_p->name,db_h,&db_h->objmeta[0]);
 //  DxBG("obj_insert: handle is at %p and points to %p",&db_h,db_h);
   DBGL (DBGL_API,"obj_insert(%p = %s, %i)", metadata_p, metadata_p->name, metadata_p->size_max);
 
@@ -375,43 +800,55 @@ kogmo_rtdb_obj_insert (kogmo_rtdb_handle_t *db_h,
   if ( metadata_p->size_max & 1 )
     metadata_p->size_max++; // make size even
 
+  // NUMA node for a new history buffer, by default the node of the inserting process
+  if ( metadata_p->size_max != 0 && kogmo_rtdb_numa_nodes () > 1 )
+    numa_node = metadata_p->flags.numa_node ? metadata_p->flags.numa_node - 1
+                                            : kogmo_rtdb_numa_node_self ();
+  metadata_p->flags.numa_node = 0;
+
 
   kogmo_rtdb_objmeta_lock(db_h);
 
   // Try to find an object metadata slot
   // - First try: reuse an unused keep-alloc slot of this process
   //  => Then we need not allocate new memory
-  for(i=0;i<KOGMO_RTDB_OBJ_MAX;i++)
+  // the deleted keep-alloc slots are listed by creator and total size
+  i = db_h->localdata_p->objmeta_keepalloc_hash[kogmo_rtdb_obj_hash_keepalloc (
+        db_h->ipc_h.this_process.proc_oid,
+        KOGMO_RTDB_OBJ_BUFFER_SIZE (metadata_p))] - 1;
+  for( ; i >= 0 && i < (int)db_h->obj_max; i = db_h->objmeta_free_next[i] - 1 )
     {
-      scan_objmeta_p = &db_h->localdata_p->objmeta[i];
-      if ( !scan_objmeta_p->oid )
+      scan_objhot_p = &db_h->objhot[i];
+      if ( !scan_objhot_p->oid )
         continue; // used
-      if ( !scan_objmeta_p->deleted_ts )
+      if ( !scan_objhot_p->deleted_ts )
         continue; // not deleted
-      if ( scan_objmeta_p->created_proc != db_h->ipc_h.this_process.proc_oid )
+      if ( scan_objhot_p->created_proc != db_h->ipc_h.this_process.proc_oid )
         continue; // not ours
-      if ( !scan_objmeta_p->flags.keep_alloc )
+      if ( !scan_objhot_p->flags.keep_alloc )
         continue; // no keep-alloc
-      if ( scan_objmeta_p->size_max * scan_objmeta_p->history_size !=
-           metadata_p->size_max * metadata_p->history_size)
+      if ( KOGMO_RTDB_OBJ_BUFFER_SIZE (scan_objhot_p) !=
+           KOGMO_RTDB_OBJ_BUFFER_SIZE (metadata_p) )
         continue; // different size
       // matching object-type-ids are not necessary, relevant is only the total memory size
 
       scan_delete_ts = kogmo_timestamp_add_secs(
-               scan_objmeta_p->deleted_ts,
-               scan_objmeta_p->history_interval > db_h->localdata_p->default_keep_deleted_interval ?
-               scan_objmeta_p->history_interval : db_h->localdata_p->default_keep_deleted_interval);
+               scan_objhot_p->deleted_ts,
+               scan_objhot_p->history_interval > db_h->localdata_p->default_keep_deleted_interval ?
+               scan_objhot_p->history_interval : db_h->localdata_p->default_keep_deleted_interval);
       if ( scan_delete_ts < ts ) // reached deletion time or is 0
         {
           // the slot: has an id + is deleted + was owned by this proc + is flagged
           // + has the same total size + reached deletion time
           found_slot = i;
-          scan_oid = scan_objmeta_p->oid;
-          metadata_p->buffer_idx = scan_objmeta_p->buffer_idx;
+          scan_objmeta_p = &db_h->objmeta[i];
+          scan_oid = scan_objhot_p->oid;
+          metadata_p->buffer_idx = scan_objhot_p->buffer_idx;
+          metadata_p->flags.numa_node = scan_objhot_p->flags.numa_node; // keeps its placement
           DBGL (DBGL_DB,"reusing pre-allocated metadata slot %d with old "
                         "oid %lli and bufferindex %lli",
                     found_slot, (long long int) scan_oid, (long long int)
-                    scan_objmeta_p->buffer_idx);
+                    scan_objhot_p->buffer_idx);
           break;
         }
     }
@@ -442,7 +879,8 @@ kogmo_rtdb_obj_insert (kogmo_rtdb_handle_t *db_h,
 
               // allocate memory for object data, this may fail if there is insufficient space
               new_allocated_heap_idx = kogmo_rtdb_obj_mem_alloc (db_h,
-                             metadata_p->size_max * metadata_p->history_size );
+                             KOGMO_RTDB_OBJ_BUFFER_SIZE (metadata_p),
+                             KOGMO_RTDB_OBJ_SLOT_ALIGN (metadata_p->size_max), &numa_node );
               DBG("alloc returned index %i",new_allocated_heap_idx);
               if ( new_allocated_heap_idx < 0 )
                 {
@@ -456,23 +894,21 @@ kogmo_rtdb_obj_insert (kogmo_rtdb_handle_t *db_h,
                   return -KOGMO_RTDB_ERR_NOMEMORY;
                 }
               metadata_p->buffer_idx = new_allocated_heap_idx;
+              metadata_p->flags.numa_node = numa_node >= 0 ? numa_node + 1 : 0;
 
               kogmo_rtdb_objmeta_lock(db_h); // re-acquire lock. Warning: global metadata might have changed in the meantime!
             }
 
-          // find free slot
-          for(i=0;i<KOGMO_RTDB_OBJ_MAX;i++)
+          // find free slot, it is taken from the free list when the object is committed
+          i = db_h->localdata_p->objmeta_free_head - 1;
+          if ( i >= 0 )
             {
-              scan_objmeta_p = &db_h->localdata_p->objmeta[i];
-              if ( scan_objmeta_p->oid == 0 )
-                {
-                  found_slot = i;
-                  scan_oid = scan_objmeta_p->oid;
-                  db_h->localdata_p->objmeta_free--;
-                  DBGL (DBGL_DB,"using empty object metadata slot %d", i);
-                  break; // leave retry-loop
-                }
-             }
+              found_slot = i;
+              scan_objhot_p = &db_h->objhot[i];
+              scan_objmeta_p = &db_h->objmeta[i];
+              scan_oid = 0;
+              DBGL (DBGL_DB,"using empty object metadata slot %d", i);
+            }
 
           if ( found_slot >= 0 )
             break; // leave retry-loop
@@ -488,7 +924,8 @@ kogmo_rtdb_obj_insert (kogmo_rtdb_handle_t *db_h,
               kogmo_rtdb_objmeta_unlock(db_h);
               if ( new_allocated_heap_idx ) // allocated memory that is useless now
                 kogmo_rtdb_obj_mem_free (db_h, new_allocated_heap_idx,
-                                         metadata_p->size_max * metadata_p->history_size);
+                                         KOGMO_RTDB_OBJ_BUFFER_SIZE (metadata_p),
+                                         KOGMO_RTDB_OBJ_SLOT_ALIGN (metadata_p->size_max));
               DBGL (DBGL_DB,"found no free object metadata slot");
               return -KOGMO_RTDB_ERR_OUTOFOBJ;
             }
@@ -498,21 +935,24 @@ kogmo_rtdb_obj_insert (kogmo_rtdb_handle_t *db_h,
 
   // Check whether there is already an unique object with this typeid and name,
   // or this unique object shall be unique, but there is already another object with this typeid and name
-  for(i=0;i<KOGMO_RTDB_OBJ_MAX;i++)
+  // (only objects with the same name hash need to be checked)
+  i = db_h->localdata_p->objmeta_name_hash[kogmo_rtdb_obj_hash_name (metadata_p->name)] - 1;
+  for( ; i >= 0 && i < (int)db_h->obj_max; i = db_h->objmeta_name_next[i] - 1 )
     {
-      tmp_oid = kogmo_rtdb_obj_searchinfo_nolock(db_h, NULL, metadata_p->otype, 0, 0, 0, NULL, i+1);
-      if ( tmp_oid <= 0 )
-        break;
-      tmp_objmeta_p = kogmo_rtdb_obj_findmeta_byid (db_h, tmp_oid);
-      if ( tmp_objmeta_p == NULL )
+      tmp_objhot_p = &db_h->objhot[i];
+      if ( tmp_objhot_p->oid == 0 || tmp_objhot_p->created_ts == 0 || tmp_objhot_p->deleted_ts != 0 )
         continue;
+      if ( tmp_objhot_p->otype != metadata_p->otype )
+        continue;
+      tmp_objmeta_p = &db_h->objmeta[i];
       if ( ( strncmp (metadata_p->name, tmp_objmeta_p->name, KOGMO_RTDB_OBJMETA_NAME_MAXLEN) == 0 )
            && ( tmp_objmeta_p->flags.unique || metadata_p->flags.unique) )
           {
             kogmo_rtdb_objmeta_unlock(db_h);
             if ( new_allocated_heap_idx ) // allocated memory that is useless now
               kogmo_rtdb_obj_mem_free (db_h, new_allocated_heap_idx,
-                                       metadata_p->size_max * metadata_p->history_size);
+                                       KOGMO_RTDB_OBJ_BUFFER_SIZE (metadata_p),
+                                       KOGMO_RTDB_OBJ_SLOT_ALIGN (metadata_p->size_max));
             DBGL (DBGL_DB,"unique object already exists");
             return -KOGMO_RTDB_ERR_NOTUNIQ;
           }
@@ -523,8 +963,21 @@ kogmo_rtdb_obj_insert (kogmo_rtdb_handle_t *db_h,
   if ( found_slot == -1 )
       return -KOGMO_RTDB_ERR_OUTOFOBJ;
 
+  // a reused keep-alloc slot is still listed and indexed by its old oid,
+  // a free slot is taken from the free list
+  if ( scan_oid )
+    {
+      kogmo_rtdb_obj_keepalloc_remove (db_h, found_slot);
+      kogmo_rtdb_obj_index_remove (db_h, scan_oid, found_slot);
+    }
+  else
+    {
+      kogmo_rtdb_obj_freeslot_get (db_h);
+    }
+
   // copy metadata with oid still 0
   memcpy (scan_objmeta_p, metadata_p, sizeof(kogmo_rtdb_obj_info_t));
+  kogmo_rtdb_obj_hot_fill (db_h, found_slot);
 
   // get new oid
   free_oid = db_h->localdata_p->objmeta_oid_next++;
@@ -532,21 +985,33 @@ kogmo_rtdb_obj_insert (kogmo_rtdb_handle_t *db_h,
     {
       if ( metadata_p->buffer_idx != 0 )
         kogmo_rtdb_obj_mem_free (db_h, metadata_p->buffer_idx,
-                     metadata_p->size_max * metadata_p->history_size );
+                     KOGMO_RTDB_OBJ_BUFFER_SIZE (metadata_p),
+                     KOGMO_RTDB_OBJ_SLOT_ALIGN (metadata_p->size_max) );
       kogmo_rtdb_objmeta_unlock(db_h);
       ERR("OUT OF OBJECT-IDs!!!");
       return -KOGMO_RTDB_ERR_OUTOFOBJ;
     }
 
+  // a new or reused buffer starts without commit sequence numbers
+  // and with an empty data_ts index
+  if ( scan_objhot_p->history_size )
+    memset (kogmo_rtdb_obj_commitseq (db_h, scan_objhot_p), 0,
+            scan_objhot_p->history_size * sizeof (uint64_t));
+  if ( kogmo_rtdb_obj_dataidx (db_h, scan_objhot_p) != NULL )
+    memset (kogmo_rtdb_obj_dataidx (db_h, scan_objhot_p), 0, sizeof (struct kogmo_rtdb_obj_dataidx_t));
+
   // if this is not the root object, make sure that parent_oid!=0
-  if(!metadata_p->parent_oid && free_oid>1) scan_objmeta_p->parent_oid=metadata_p->parent_oid=1;
+  if(!metadata_p->parent_oid && free_oid>1)
+    scan_objhot_p->parent_oid=scan_objmeta_p->parent_oid=metadata_p->parent_oid=1;
 
 #ifdef KOGMO_RTDB_IPC_DO_POLLING
-  kogmo_rtdb_obj_unlock (db_h, scan_objmeta_p);
+  kogmo_rtdb_obj_unlock (db_h, scan_objhot_p);
 #endif
 
-  // set oid in db->object activated
+  // set oid in db->object activated, the hot table last, lock-free readers verify it
   scan_objmeta_p->oid = free_oid;
+  kogmo_rtdb_obj_index_add (db_h, free_oid, found_slot);
+  *(volatile kogmo_rtdb_objid_t *) &scan_objhot_p->oid = free_oid;
 
   DBGL (DBGL_DB,"object metadata inserted with new oid %lli",
         (long long int)free_oid );
@@ -578,15 +1043,19 @@ kogmo_rtdb_obj_purgeslot (kogmo_rtdb_handle_t *db_h,
                           int slot)
 {
   kogmo_rtdb_obj_info_t *objmeta_p;
-  objmeta_p = &db_h->localdata_p->objmeta[slot];
+  objmeta_p = &db_h->objmeta[slot];
   DBGL (DBGL_DB,"purging object metadata slot %d with old oid %lli",
         slot, (long long int) objmeta_p->oid);
   if ( objmeta_p->buffer_idx != 0 )
     kogmo_rtdb_obj_mem_free (db_h, objmeta_p->buffer_idx,
-                             objmeta_p->size_max *
-                             objmeta_p->history_size );
+                             KOGMO_RTDB_OBJ_BUFFER_SIZE (objmeta_p),
+                             KOGMO_RTDB_OBJ_SLOT_ALIGN (objmeta_p->size_max) );
+  if ( db_h->objhot[slot].deleted_ts && db_h->objhot[slot].flags.keep_alloc )
+    kogmo_rtdb_obj_keepalloc_remove (db_h, slot);
+  kogmo_rtdb_obj_index_remove (db_h, objmeta_p->oid, slot);
+  db_h->objhot[slot].oid = 0;
   objmeta_p->oid = 0;
-  db_h->localdata_p->objmeta_free++;
+  kogmo_rtdb_obj_freeslot_put (db_h, slot);
   return 0;
 }
 
@@ -596,10 +1065,12 @@ kogmo_rtdb_obj_delete_imm (kogmo_rtdb_handle_t *db_h,
                        int immediately_delete)
 {
   kogmo_rtdb_obj_info_t *used_objmeta_p;
+  struct kogmo_rtdb_obj_hot_t *used_objhot_p;
   kogmo_rtdb_obj_info_t child_objmeta;
-  kogmo_rtdb_objid_list_t child_objlist;
+  kogmo_rtdb_obj_search_t search;
+  kogmo_rtdb_objid_t child_objlist[64];
   int err;
-  int i;
+  int i, n, was_deleted;
 
   CHK_DBH("kogmo_rtdb_obj_delete",db_h,0);
   CHK_PTR(metadata_p);
@@ -640,15 +1111,13 @@ kogmo_rtdb_obj_delete_imm (kogmo_rtdb_handle_t *db_h,
       return -KOGMO_RTDB_ERR_NOTFOUND;
     }
 
-  // find objects depending on this object
-  child_objlist[0]=0;
-  err = kogmo_rtdb_obj_searchinfo_nolock (db_h, "", 0, metadata_p->oid, 0, 0, child_objlist, 0);
-  if (err < 0 )
-    child_objlist[0]=0;
-
-  // mark as deleted
+  // mark as deleted, a keep-alloc slot can be reused by its process from now on
+  used_objhot_p = &db_h->objhot[ kogmo_rtdb_obj_slotnum (db_h, used_objmeta_p) ];
+  was_deleted = used_objhot_p->deleted_ts != 0;
   used_objmeta_p->deleted_proc = db_h->ipc_h.this_process.proc_oid;
-  used_objmeta_p->deleted_ts = kogmo_rtdb_timestamp_now (db_h);
+  used_objhot_p->deleted_ts = used_objmeta_p->deleted_ts = kogmo_rtdb_timestamp_now (db_h);
+  if ( !was_deleted && used_objhot_p->flags.keep_alloc )
+    kogmo_rtdb_obj_keepalloc_add (db_h, kogmo_rtdb_obj_hot_slotnum (db_h, used_objhot_p));
 
   // clear data in return context
   // bad. better update it (add deleted_time etc..). unique oid will stay invalid forever->no problem
@@ -657,6 +1126,7 @@ kogmo_rtdb_obj_delete_imm (kogmo_rtdb_handle_t *db_h,
 
   // update local context
   memcpy (metadata_p, used_objmeta_p, sizeof(kogmo_rtdb_obj_info_t));
+  metadata_p->history_slot = used_objhot_p->history_slot;
 
   // don't wait for purge if immediately_delete is set
   if ( used_objmeta_p ->flags.immediately_delete || immediately_delete )
@@ -667,14 +1137,22 @@ kogmo_rtdb_obj_delete_imm (kogmo_rtdb_handle_t *db_h,
   kogmo_rtdb_objmeta_unlock_notify(db_h);
 
   // inform listeners
-  kogmo_rtdb_obj_do_notify_prepare(db_h, used_objmeta_p);
-  kogmo_rtdb_obj_do_notify (db_h, used_objmeta_p);
+  kogmo_rtdb_obj_do_notify_prepare(db_h, used_objhot_p);
+  kogmo_rtdb_obj_do_notify (db_h, used_objhot_p);
+  // kogmo_rtdb_obj_wait_all() flags only one of its objects, but ends
+  // with the deletion of any of them
+  kogmo_rtdb_obj_wait_anynotify_interrupt (db_h);
 
   kogmo_rtdb_obj_trace_send (db_h, metadata_p->oid, metadata_p->deleted_ts, KOGMO_RTDB_TRACE_DELETED,
         kogmo_rtdb_obj_slotnum (db_h, metadata_p), -1);
 
   // delete all objects that depend on this as parent
-  for (i=0; child_objlist[i] != 0; i++ )
+  err = kogmo_rtdb_obj_searchinfo_begin (db_h, &search, "", 0, metadata_p->oid, 0, 0, 0);
+  if ( err < 0 )
+    return 0;
+  while ( ( n = kogmo_rtdb_obj_searchinfo_next (db_h, &search, child_objlist,
+                  sizeof(child_objlist)/sizeof(child_objlist[0])) ) > 0 )
+    for (i=0; i<n; i++ )
     {
       err = kogmo_rtdb_obj_readinfo (db_h, child_objlist[i], 0, &child_objmeta );
       if ( err < 0 )
@@ -686,6 +1164,7 @@ kogmo_rtdb_obj_delete_imm (kogmo_rtdb_handle_t *db_h,
           continue;
         }
     }
+  kogmo_rtdb_obj_searchinfo_end (db_h, &search);
   return 0;
 }
 
@@ -735,8 +1214,10 @@ kogmo_rtdb_obj_readinfo (kogmo_rtdb_handle_t *db_h,
         }
     }
 
-  // copy data in return context
+  // copy data in return context, the latest history slot is only kept in the hot table
   memcpy (metadata_p, used_objmeta_p, sizeof(kogmo_rtdb_obj_info_t));
+  metadata_p->history_slot =
+    db_h->objhot[ kogmo_rtdb_obj_slotnum (db_h, used_objmeta_p) ].history_slot;
 
   kogmo_rtdb_objmeta_unlock(db_h);
   return 0;
@@ -790,7 +1271,10 @@ char* kogmo_rtdb_obj_dumpinfo_str (kogmo_rtdb_handle_t *db_h,
    metadata_p->history_interval, metadata_p->min_cycletime, metadata_p->max_cycletime,
    metadata_p->history_slot+1, metadata_p->history_size );
 
-  STRPRINTF(buf,"Buffer %lli\n", (long long int)metadata_p->buffer_idx );
+  STRPRINTF(buf,"Buffer %lli", (long long int)metadata_p->buffer_idx );
+  if ( metadata_p->flags.numa_node )
+    STRPRINTF(buf," on NUMA node %d", metadata_p->flags.numa_node - 1);
+  STRPRINTF(buf,"\n");
 
   return buf;
 }
@@ -1063,6 +1547,7 @@ kogmo_rtdb_obj_changeinfo (kogmo_rtdb_handle_t *db_h,
                            kogmo_rtdb_obj_info_t *metadata_p)
 {
   kogmo_rtdb_obj_info_t *used_objmeta_p;
+  struct kogmo_rtdb_obj_hot_t *used_objhot_p;
   kogmo_timestamp_t ts;
 
   CHK_DBH("kogmo_rtdb_obj_changeinfo",db_h,0);
@@ -1086,9 +1571,13 @@ kogmo_rtdb_obj_changeinfo (kogmo_rtdb_handle_t *db_h,
       return -KOGMO_RTDB_ERR_NOTFOUND;
     }
 
+  used_objhot_p = &db_h->objhot[ kogmo_rtdb_obj_slotnum (db_h, used_objmeta_p) ];
   used_objmeta_p->lastmodified_proc = db_h->ipc_h.this_process.proc_oid;
   used_objmeta_p->lastmodified_ts = ts;
 
+  // name, type and parent are indexed
+  kogmo_rtdb_obj_searchindex_remove (db_h, kogmo_rtdb_obj_slotnum (db_h, used_objmeta_p));
+
   metadata_p->name[KOGMO_RTDB_OBJMETA_NAME_MAXLEN-1] = '\0';
   if ( metadata_p->name[0] != '\0' )
     strncpy(used_objmeta_p->name,metadata_p->name,sizeof(metadata_p->name));
@@ -1096,20 +1585,22 @@ kogmo_rtdb_obj_changeinfo (kogmo_rtdb_handle_t *db_h,
   // here: allow change to 0?..
 
   if ( metadata_p->otype )
-    used_objmeta_p->otype = metadata_p->otype;
+    used_objhot_p->otype = used_objmeta_p->otype = metadata_p->otype;
 
   if ( metadata_p->parent_oid )
-    used_objmeta_p->parent_oid = metadata_p->parent_oid;
+    used_objhot_p->parent_oid = used_objmeta_p->parent_oid = metadata_p->parent_oid;
+
+  kogmo_rtdb_obj_searchindex_add (db_h, kogmo_rtdb_obj_slotnum (db_h, used_objmeta_p));
 
   //if ( metadata_p->flags ) // hmm.. does not allow setting to 0.. (TODO)
   //  used_objmeta_p->flags = metadata_p->flags;
 
   if ( metadata_p->max_cycletime > 0 )
-    used_objmeta_p->max_cycletime = metadata_p->max_cycletime;
+    used_objhot_p->max_cycletime = used_objmeta_p->max_cycletime = metadata_p->max_cycletime;
   if ( metadata_p->min_cycletime > 0 )
-    used_objmeta_p->min_cycletime = metadata_p->min_cycletime;
+    used_objhot_p->min_cycletime = used_objmeta_p->min_cycletime = metadata_p->min_cycletime;
   if ( metadata_p->history_interval > 0 )
-    used_objmeta_p->history_interval = metadata_p->history_interval;
+    used_objhot_p->history_interval = used_objmeta_p->history_interval = metadata_p->history_interval;
 
   kogmo_rtdb_objmeta_unlock_notify(db_h);
 
@@ -27,6 +27,12 @@ kogmo_rtdb_obj_searchinfo_deleted (kogmo_rtdb_handle_t *db_h,
                            kogmo_rtdb_objid_list_t idlist,
                            int nth);
 
+void
+kogmo_rtdb_regex_cache_init (kogmo_rtdb_handle_t *db_h);
+
+void
+kogmo_rtdb_regex_cache_destroy (kogmo_rtdb_handle_t *db_h);
+
 kogmo_rtdb_objid_t
 kogmo_rtdb_obj_changeinfo (kogmo_rtdb_handle_t *db_h,
                            kogmo_rtdb_objid_t oid,
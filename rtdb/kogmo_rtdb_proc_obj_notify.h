@@ -31,19 +31,19 @@ kogmo_rtdb_objmeta_unlock (kogmo_rtdb_handle_t *db_h)
 
 inline static void
 kogmo_rtdb_obj_lock (kogmo_rtdb_handle_t *db_h,
-                     kogmo_rtdb_obj_info_t *objmeta_p)
+                     struct kogmo_rtdb_obj_hot_t *objhot_p)
 {
-  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_lock(objslot %i)",kogmo_rtdb_obj_slotnum (db_h, objmeta_p));
+  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_lock(objslot %i)",kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p));
   kogmo_rtdb_ipc_mutex_lock(
-   &db_h->localdata_p -> obj_lock[ kogmo_rtdb_obj_slotnum (db_h, objmeta_p) ] );
+   &db_h->obj_lock[ kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p) ] );
 }
 inline static void
 kogmo_rtdb_obj_unlock (kogmo_rtdb_handle_t *db_h,
-                       kogmo_rtdb_obj_info_t *objmeta_p)
+                       struct kogmo_rtdb_obj_hot_t *objhot_p)
 {
-  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_unlock(objslot %i)",kogmo_rtdb_obj_slotnum (db_h, objmeta_p));
+  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_unlock(objslot %i)",kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p));
   kogmo_rtdb_ipc_mutex_unlock(
-   &db_h->localdata_p -> obj_lock[ kogmo_rtdb_obj_slotnum (db_h, objmeta_p) ] );
+   &db_h->obj_lock[ kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p) ] );
 }
 
 
@@ -92,56 +92,247 @@ kogmo_rtdb_obj_wait_metanotify (kogmo_rtdb_handle_t *db_h, kogmo_timestamp_t wak
 }
 
 // passing notifications
+#ifdef KOGMO_RTDB_IPC_FUTEX
+// The hot object carries a sequence word that every commit increments.
+// Readers remember it before looking at the data and sleep on it only
+// if it is still unchanged. Writers do a syscall only if a reader has
+// set KOGMO_RTDB_IPC_FUTEX_WAITERS, so commits without waiters stay in
+// user space.
+// Readers waiting for several objects set KOGMO_RTDB_OBJ_NOTIFY_ANYWAITERS
+// in each of them instead and sleep on the global anynotify_seq.
+#define KOGMO_RTDB_OBJ_NOTIFY_ANYWAITERS 0x40000000U
+
+// internal: increment a futex word and clear the flags,
+// wake up its waiters if they are flagged, returns the old value
+inline static uint32_t
+kogmo_rtdb_obj_notify_bump (volatile uint32_t *word, uint32_t flags)
+{
+  uint32_t old_seq, new_seq;
+  do
+    {
+      old_seq = *word;
+      new_seq = ( old_seq + 1 ) & ~flags;
+    }
+  while ( __sync_val_compare_and_swap (word, old_seq, new_seq) != old_seq );
+  if ( old_seq & KOGMO_RTDB_IPC_FUTEX_WAITERS )
+    kogmo_rtdb_ipc_futex_wake (word);
+  return old_seq;
+}
+// internal: flag a waiter in a futex word that still has the value seq,
+// returns 0 if it has changed meanwhile
+inline static int
+kogmo_rtdb_obj_notify_flag (volatile uint32_t *word, uint32_t *seq_p, uint32_t flag)
+{
+  if ( *seq_p & flag )
+    return 1;
+  if ( __sync_val_compare_and_swap (word, *seq_p, *seq_p | flag) != *seq_p )
+    return 0;
+  *seq_p |= flag;
+  return 1;
+}
+
 inline static void
 kogmo_rtdb_obj_do_notify_prepare (kogmo_rtdb_handle_t *db_h,
-                     kogmo_rtdb_obj_info_t *objmeta_p)
+                     struct kogmo_rtdb_obj_hot_t *objhot_p)
 {
-  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_do_notify_prepare(objslot %i)",kogmo_rtdb_obj_slotnum (db_h, objmeta_p));
+  // nothing to block: readers detect commits by the sequence word
+}
+inline static void
+kogmo_rtdb_obj_do_notify (kogmo_rtdb_handle_t *db_h,
+                       struct kogmo_rtdb_obj_hot_t *objhot_p)
+{
+  uint32_t old_seq;
+  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_do_notify(objslot %i)",kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p));
+  old_seq = kogmo_rtdb_obj_notify_bump (&objhot_p->notify_seq,
+              KOGMO_RTDB_IPC_FUTEX_WAITERS | KOGMO_RTDB_OBJ_NOTIFY_ANYWAITERS);
+  if ( old_seq & KOGMO_RTDB_OBJ_NOTIFY_ANYWAITERS )
+    kogmo_rtdb_obj_notify_bump (&db_h->localdata_p->anynotify_seq,
+                                KOGMO_RTDB_IPC_FUTEX_WAITERS);
+}
+inline static uint32_t
+kogmo_rtdb_obj_wait_notify_prepare (kogmo_rtdb_handle_t *db_h,
+                       struct kogmo_rtdb_obj_hot_t *objhot_p)
+{
+  uint32_t seq;
+  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_wait_notify_prepare(objslot %i)",kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p));
+  seq = objhot_p->notify_seq;
+  __sync_synchronize(); // read the sequence before the data it guards
+  return seq;
+}
+inline static void
+kogmo_rtdb_obj_wait_notify_done (kogmo_rtdb_handle_t *db_h,
+                       struct kogmo_rtdb_obj_hot_t *objhot_p)
+{
+}
+inline static int
+kogmo_rtdb_obj_wait_notify (kogmo_rtdb_handle_t *db_h,
+                            struct kogmo_rtdb_obj_hot_t *objhot_p, uint32_t seq,
+                            kogmo_timestamp_t wakeup_ts)
+{
+  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_wait_notify(objslot %i)",kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p));
+  // flag us as waiter, a failing swap means there has been a commit meanwhile
+  if ( ! kogmo_rtdb_obj_notify_flag (&objhot_p->notify_seq, &seq, KOGMO_RTDB_IPC_FUTEX_WAITERS) )
+    return 0;
+  return kogmo_rtdb_ipc_futex_wait (&objhot_p->notify_seq, seq, wakeup_ts);
+}
+// busy wait for a commit before kogmo_rtdb_obj_wait_notify(), as long as
+// configured by kogmo_rtdb_setwaitspin(), returns 1 if there was a commit
+inline static int
+kogmo_rtdb_obj_wait_notify_spin (kogmo_rtdb_handle_t *db_h,
+                                 struct kogmo_rtdb_obj_hot_t *objhot_p, uint32_t seq,
+                                 kogmo_timestamp_t wakeup_ts)
+{
+  const uint32_t flags = KOGMO_RTDB_IPC_FUTEX_WAITERS | KOGMO_RTDB_OBJ_NOTIFY_ANYWAITERS;
+  kogmo_timestamp_t end_ts;
+  int i;
+  if ( db_h->wait_spin_ticks <= 0 )
+    return 0;
+  end_ts = kogmo_timestamp_now () + db_h->wait_spin_ticks;
+  if ( wakeup_ts != 0 && end_ts > wakeup_ts )
+    end_ts = wakeup_ts;
+  seq &= ~flags;
+  while (1)
+    {
+      // look at the word after yielding, other processes may have committed
+      for ( i = 0; i < KOGMO_RTDB_WAIT_SPIN_CHECKS; i++ )
+        {
+          if ( ( objhot_p->notify_seq & ~flags ) != seq )
+            {
+              __sync_synchronize(); // read the sequence before the data it guards
+              return 1;
+            }
+          CPU_RELAX();
+        }
+      if ( kogmo_timestamp_now () >= end_ts )
+        return 0;
+      if ( db_h->wait_spin_yield )
+        sched_yield ();
+    }
+}
+
+// waiting for notifications of several objects (kogmo_rtdb_obj_wait_any()):
+// remember the global sequence, flag all objects, check their data, then wait
+inline static uint32_t
+kogmo_rtdb_obj_wait_anynotify_prepare (kogmo_rtdb_handle_t *db_h)
+{
+  uint32_t seq;
+  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_wait_anynotify_prepare");
+  seq = db_h->localdata_p->anynotify_seq;
+  __sync_synchronize();
+  return seq;
+}
+inline static void
+kogmo_rtdb_obj_wait_anynotify_add (kogmo_rtdb_handle_t *db_h,
+                                   struct kogmo_rtdb_obj_hot_t *objhot_p)
+{
+  uint32_t seq;
+  // retry until flagged, a commit meanwhile is seen by the following data check
+  do
+    seq = objhot_p->notify_seq;
+  while ( ! kogmo_rtdb_obj_notify_flag (&objhot_p->notify_seq, &seq, KOGMO_RTDB_OBJ_NOTIFY_ANYWAITERS) );
+}
+inline static int
+kogmo_rtdb_obj_wait_anynotify (kogmo_rtdb_handle_t *db_h, uint32_t seq,
+                               kogmo_timestamp_t wakeup_ts)
+{
+  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_wait_anynotify");
+  if ( ! kogmo_rtdb_obj_notify_flag (&db_h->localdata_p->anynotify_seq, &seq, KOGMO_RTDB_IPC_FUTEX_WAITERS) )
+    return 0;
+  return kogmo_rtdb_ipc_futex_wait (&db_h->localdata_p->anynotify_seq, seq, wakeup_ts);
+}
+// wake up all waiters for several objects, they check their interrupt flags
+inline static void
+kogmo_rtdb_obj_wait_anynotify_interrupt (kogmo_rtdb_handle_t *db_h)
+{
+  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_wait_anynotify_interrupt");
+  kogmo_rtdb_obj_notify_bump (&db_h->localdata_p->anynotify_seq,
+                              KOGMO_RTDB_IPC_FUTEX_WAITERS);
+}
+#else /* KOGMO_RTDB_IPC_FUTEX */
+inline static void
+kogmo_rtdb_obj_do_notify_prepare (kogmo_rtdb_handle_t *db_h,
+                     struct kogmo_rtdb_obj_hot_t *objhot_p)
+{
+  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_do_notify_prepare(objslot %i)",kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p));
   kogmo_rtdb_ipc_mutex_lock(
-   &db_h->localdata_p -> obj_changenotify_lock[ kogmo_rtdb_obj_slotnum (db_h, objmeta_p) ] );
+   &db_h->obj_changenotify_lock[ kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p) ] );
 }
 inline static void
 kogmo_rtdb_obj_do_notify (kogmo_rtdb_handle_t *db_h,
-                       kogmo_rtdb_obj_info_t *objmeta_p)
+                       struct kogmo_rtdb_obj_hot_t *objhot_p)
 {
-  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_do_notify(objslot %i)",kogmo_rtdb_obj_slotnum (db_h, objmeta_p));
+  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_do_notify(objslot %i)",kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p));
   kogmo_rtdb_ipc_condvar_signalall(
-   &db_h->localdata_p -> obj_changenotify[ kogmo_rtdb_obj_slotnum (db_h, objmeta_p) ] );
+   &db_h->obj_changenotify[ kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p) ] );
   kogmo_rtdb_ipc_mutex_unlock(
-   &db_h->localdata_p -> obj_changenotify_lock[ kogmo_rtdb_obj_slotnum (db_h, objmeta_p) ] );
+   &db_h->obj_changenotify_lock[ kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p) ] );
 }
-inline static void
+inline static uint32_t
 kogmo_rtdb_obj_wait_notify_prepare (kogmo_rtdb_handle_t *db_h,
-                       kogmo_rtdb_obj_info_t *objmeta_p)
+                       struct kogmo_rtdb_obj_hot_t *objhot_p)
 {
-  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_wait_notify_prepare(objslot %i)",kogmo_rtdb_obj_slotnum (db_h, objmeta_p));
+  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_wait_notify_prepare(objslot %i)",kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p));
   kogmo_rtdb_ipc_mutex_lock(
-   &db_h->localdata_p -> obj_changenotify_lock[ kogmo_rtdb_obj_slotnum (db_h, objmeta_p) ] );
+   &db_h->obj_changenotify_lock[ kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p) ] );
+  return 0;
 }
 inline static void
 kogmo_rtdb_obj_wait_notify_done (kogmo_rtdb_handle_t *db_h,
-                       kogmo_rtdb_obj_info_t *objmeta_p)
+                       struct kogmo_rtdb_obj_hot_t *objhot_p)
 {
-  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_wait_notify_done(objslot %i)",kogmo_rtdb_obj_slotnum (db_h, objmeta_p));
+  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_wait_notify_done(objslot %i)",kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p));
   kogmo_rtdb_ipc_mutex_unlock(
-   &db_h->localdata_p -> obj_changenotify_lock[ kogmo_rtdb_obj_slotnum (db_h, objmeta_p) ] );
+   &db_h->obj_changenotify_lock[ kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p) ] );
 }
 inline static int
 kogmo_rtdb_obj_wait_notify (kogmo_rtdb_handle_t *db_h,
-                            kogmo_rtdb_obj_info_t *objmeta_p, kogmo_timestamp_t wakeup_ts)
+                            struct kogmo_rtdb_obj_hot_t *objhot_p, uint32_t seq,
+                            kogmo_timestamp_t wakeup_ts)
 {
   int ret;
-  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_wait_notify(objslot %i)",kogmo_rtdb_obj_slotnum (db_h, objmeta_p));
+  DBGL(DBGL_LOCK,"kogmo_rtdb_obj_wait_notify(objslot %i)",kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p));
   ret = kogmo_rtdb_ipc_condvar_wait(
-         &db_h->localdata_p ->
-           obj_changenotify[ kogmo_rtdb_obj_slotnum (db_h, objmeta_p) ],
-         &db_h->localdata_p ->
-           obj_changenotify_lock[ kogmo_rtdb_obj_slotnum (db_h, objmeta_p) ],
+         &db_h->obj_changenotify[ kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p) ],
+         &db_h->obj_changenotify_lock[ kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p) ],
          wakeup_ts);
   kogmo_rtdb_ipc_mutex_unlock(
-   &db_h->localdata_p -> obj_changenotify_lock[ kogmo_rtdb_obj_slotnum (db_h, objmeta_p) ] );
+   &db_h->obj_changenotify_lock[ kogmo_rtdb_obj_hot_slotnum (db_h, objhot_p) ] );
   return ret;
 }
+inline static int
+kogmo_rtdb_obj_wait_notify_spin (kogmo_rtdb_handle_t *db_h,
+                                 struct kogmo_rtdb_obj_hot_t *objhot_p, uint32_t seq,
+                                 kogmo_timestamp_t wakeup_ts)
+{
+  // the waiter holds the notify lock here, the writer could not commit
+  return 0;
+}
+
+// there is no shared wait primitive for several objects here,
+// kogmo_rtdb_obj_wait_any() polls
+#define KOGMO_RTDB_OBJ_WAIT_ANY_POLLING
+inline static uint32_t
+kogmo_rtdb_obj_wait_anynotify_prepare (kogmo_rtdb_handle_t *db_h)
+{
+  return 0;
+}
+inline static void
+kogmo_rtdb_obj_wait_anynotify_add (kogmo_rtdb_handle_t *db_h,
+                                   struct kogmo_rtdb_obj_hot_t *objhot_p)
+{
+}
+inline static int
+kogmo_rtdb_obj_wait_anynotify (kogmo_rtdb_handle_t *db_h, uint32_t seq,
+                               kogmo_timestamp_t wakeup_ts)
+{
+  return 0;
+}
+inline static void
+kogmo_rtdb_obj_wait_anynotify_interrupt (kogmo_rtdb_handle_t *db_h)
+{
+  // the polling waiters see their interrupt flags within the poll time
+}
+#endif /* KOGMO_RTDB_IPC_FUTEX */
 
 
 
@@ -13,6 +13,11 @@
  */
 
 #include "kogmo_rtdb_internal.h"
+#include <dirent.h>
+#include <ctype.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
 
 
 #if defined(RTMALLOC_tlsf)
@@ -30,6 +35,88 @@ int suba_free(void *suba, void *ptr);
 #endif
 
 
+/* ******************** NUMA PLACEMENT ******************** */
+
+#if defined(__linux__) && defined(SYS_mbind) && defined(SYS_getcpu)
+#define KOGMO_RTDB_NUMA
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1
+#endif
+#ifndef MPOL_MF_MOVE
+#define MPOL_MF_MOVE (1<<1)
+#endif
+#endif
+
+/*! \brief Number of NUMA nodes of this system, 1 if unknown.
+ */
+int
+kogmo_rtdb_numa_nodes (void)
+{
+  static int nodes = 0;
+  if ( nodes == 0 )
+    {
+      int n = 0;
+#ifdef KOGMO_RTDB_NUMA
+      DIR *dir = opendir ("/sys/devices/system/node");
+      struct dirent *entry;
+      if ( dir != NULL )
+        {
+          while ( ( entry = readdir (dir) ) != NULL )
+            if ( strncmp (entry->d_name, "node", 4) == 0 && isdigit (entry->d_name[4]) )
+              n++;
+          closedir (dir);
+        }
+#endif
+      nodes = n > 0 ? n : 1;
+    }
+  return nodes;
+}
+
+/*! \brief NUMA node the calling thread currently runs on, -1 if unknown.
+ */
+int
+kogmo_rtdb_numa_node_self (void)
+{
+#ifdef KOGMO_RTDB_NUMA
+  unsigned int cpu, node;
+  if ( syscall (SYS_getcpu, &cpu, &node, NULL) == 0 )
+    return node;
+#endif
+  return -1;
+}
+
+// internal: prefer numa_node for the pages of a heap range;
+// pages that were already touched by other processes stay where they are.
+// MPOL_PREFERRED instead of MPOL_BIND, so that a full node never fails a commit.
+static int
+kogmo_rtdb_obj_mem_bind (void *ptr, kogmo_rtdb_objsize_t size, int numa_node)
+{
+#ifdef KOGMO_RTDB_NUMA
+  unsigned long nodemask[KOGMO_RTDB_NUMA_NODES_MAX / (8*sizeof(unsigned long))];
+  unsigned long pagesize = sysconf (_SC_PAGESIZE);
+  unsigned long start = (unsigned long) ptr & ~(pagesize-1);
+  unsigned long end = (unsigned long) ptr + size;
+
+  if ( numa_node < 0 || numa_node >= KOGMO_RTDB_NUMA_NODES_MAX )
+    return -KOGMO_RTDB_ERR_INVALID;
+  memset (nodemask, 0, sizeof (nodemask));
+  nodemask[numa_node / (8*sizeof(unsigned long))] |= 1UL << (numa_node % (8*sizeof(unsigned long)));
+
+  if ( syscall (SYS_mbind, start, end - start, MPOL_PREFERRED,
+                nodemask, 8*sizeof(nodemask) + 1, MPOL_MF_MOVE) != 0 )
+    {
+      DBGL(DBGL_DB,"mem_bind: placing %i bytes at %p on node %i failed: %s",
+           size, ptr, numa_node, strerror(errno));
+      return -KOGMO_RTDB_ERR_UNKNOWN;
+    }
+  DBGL(DBGL_DB,"mem_bind: %i bytes at %p on node %i", size, ptr, numa_node);
+  return 0;
+#else
+  return -KOGMO_RTDB_ERR_UNKNOWN;
+#endif
+}
+
+
 /* ******************** HEAP MANAGEMENT ******************** */
 
 inline static void
@@ -44,18 +131,32 @@ kogmo_rtdb_heap_unlock (kogmo_rtdb_handle_t *db_h)
 }
 
 
+// internal: bytes to allocate for size bytes aligned to align (a power of 2),
+// an aligned block is preceded by its distance to the allocated block
+inline static kogmo_rtdb_objsize_t
+kogmo_rtdb_obj_mem_total (kogmo_rtdb_objsize_t size, kogmo_rtdb_objsize_t align)
+{
+  return align > 1 ? size + align - 1 + sizeof (int32_t) : size;
+}
+
 /*! \brief Allocate Memory for Object Data with Object Data Heap.
  * For internal use only.
+ * The memory starts at a multiple of align (a power of 2, 0 for don't care),
+ * the same align must be given to kogmo_rtdb_obj_mem_free().
+ * If numa_node_p points to a node >= 0, the memory is placed on that NUMA node
+ * before it is touched; it is set to -1 if that was not possible.
  * returns Index-Pointer relative to Heap begin.
  */
 kogmo_rtdb_objsize_t
-kogmo_rtdb_obj_mem_alloc (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objsize_t size )
+kogmo_rtdb_obj_mem_alloc (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objsize_t size,
+                          kogmo_rtdb_objsize_t align, int *numa_node_p )
 {
-  void *ptr = NULL;
-  void *base = db_h->localdata_p->heap;
+  void *ptr = NULL, *aligned;
+  void *base = db_h->heap;
+  kogmo_rtdb_objsize_t total = kogmo_rtdb_obj_mem_total (size, align);
 
   DBGL(DBGL_DB,"mem_alloc: heap pointers: base %p",
-       db_h->localdata_p->heap);
+       db_h->heap);
 
   DBGL(DBGL_DB,"mem_alloc: %lli bytes (%lli used, %lli free)",
        (long long int) size,
@@ -66,11 +167,11 @@ kogmo_rtdb_obj_mem_alloc (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objsize_t size )
   // speedup: round size to page_size (achieved with tlsf parameters)
   kogmo_rtdb_heap_lock(db_h);
 #if defined(RTMALLOC_tlsf)
-  ptr = malloc_ex (size, base);
+  ptr = malloc_ex (total, base);
 #elif defined(RTMALLOC_suba)
-  ptr = suba_alloc(db_h->heapinfo, size, 0/* dont zero*/);
+  ptr = suba_alloc(db_h->heapinfo, total, 0/* dont zero*/);
 #else
-  if ( size <= db_h->localdata_p->heap_free )
+  if ( total <= db_h->localdata_p->heap_free )
     {
       ptr = base + db_h->localdata_p->heap_used;
     }
@@ -79,26 +180,40 @@ kogmo_rtdb_obj_mem_alloc (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objsize_t size )
   if ( ptr == NULL )
     {
       kogmo_rtdb_heap_unlock(db_h);
-      ERR("object mem_alloc failed for %i continuous bytes, %lli (discontinuous) bytes free", size,
+      ERR("object mem_alloc failed for %i continuous bytes, %lli (discontinuous) bytes free", total,
           (long long int) db_h->localdata_p->heap_free );
       return -1;
     }
-  db_h->localdata_p->heap_free -= size;
-  db_h->localdata_p->heap_used += size;
+  db_h->localdata_p->heap_free -= total;
+  db_h->localdata_p->heap_used += total;
   kogmo_rtdb_heap_unlock(db_h);
-  memset (ptr, 0, size);
+  if ( numa_node_p != NULL && *numa_node_p >= 0 )
+    if ( kogmo_rtdb_obj_mem_bind (ptr, total, *numa_node_p) < 0 )
+      *numa_node_p = -1;
+  memset (ptr, 0, total);
   DBG("allocated mem cleared");
-  return ptr-base;
+  aligned = ptr;
+  if ( align > 1 )
+    {
+      // the mappings of all processes start at a page, so aligned addresses are the same for all
+      aligned = (void *) ( ( (unsigned long) ptr + sizeof (int32_t) + align - 1 )
+                           & ~ (unsigned long) ( align - 1 ) );
+      ( (int32_t *) aligned ) [-1] = (char *) aligned - (char *) ptr;
+    }
+  return aligned-base;
 }
 
 void
 kogmo_rtdb_obj_mem_free (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objsize_t idx,
-                         kogmo_rtdb_objsize_t size )
+                         kogmo_rtdb_objsize_t size, kogmo_rtdb_objsize_t align )
 {
 #if defined(RTMALLOC_tlsf)
-  void *base = db_h->localdata_p->heap;
+  void *base = db_h->heap;
 #endif
-  void *ptr = db_h->localdata_p->heap + idx;
+  void *ptr = db_h->heap + idx;
+  if ( align > 1 )
+    ptr -= ( (int32_t *) ptr ) [-1];
+  size = kogmo_rtdb_obj_mem_total (size, align);
   DBGL(DBGL_DB,"mem_free: %i bytes at %p", size, ptr);
   kogmo_rtdb_heap_lock(db_h);
 #if defined(RTMALLOC_tlsf)
@@ -120,7 +235,7 @@ kogmo_rtdb_obj_mem_init (kogmo_rtdb_handle_t *db_h)
 {
   kogmo_rtdb_objsize_t size = db_h->localdata_p->heap_size;
   kogmo_rtdb_objsize_t free;
-  void *base = db_h->localdata_p->heap;
+  void *base = db_h->heap;
   DBGL(DBGL_DB,"mem_init: %i bytes at %p", size, base);
 #if defined(RTMALLOC_tlsf)
   free = init_memory_pool (size, base);
@@ -141,7 +256,7 @@ kogmo_rtdb_obj_mem_attach (kogmo_rtdb_handle_t *db_h)
 {
 #if !defined(RTMALLOC_tlsf)
   kogmo_rtdb_objsize_t size = db_h->localdata_p->heap_size;
-  void *base = db_h->localdata_p ->heap;
+  void *base = db_h->heap;
 #endif
 #if defined(RTMALLOC_tlsf)
   DBGL(DBGL_DB,"mem_attach(tlsf)");
@@ -161,7 +276,7 @@ kogmo_rtdb_obj_mem_attach (kogmo_rtdb_handle_t *db_h)
 void
 kogmo_rtdb_obj_mem_destroy (kogmo_rtdb_handle_t *db_h)
 {
-  void *base = db_h->localdata_p->heap;
+  void *base = db_h->heap;
   DBGL(DBGL_DB,"mem_destroy: release %p, %lli bytes were used, %lli free",
       base,
       (long long int) db_h->localdata_p->heap_used,
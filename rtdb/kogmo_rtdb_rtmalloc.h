@@ -17,11 +17,12 @@
 
 
 kogmo_rtdb_objsize_t
-kogmo_rtdb_obj_mem_alloc (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objsize_t size );
+kogmo_rtdb_obj_mem_alloc (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objsize_t size,
+                          kogmo_rtdb_objsize_t align, int *numa_node_p );
 
 void
 kogmo_rtdb_obj_mem_free (kogmo_rtdb_handle_t *db_h, kogmo_rtdb_objsize_t idx,
-                         kogmo_rtdb_objsize_t size );
+                         kogmo_rtdb_objsize_t size, kogmo_rtdb_objsize_t align );
 
 kogmo_rtdb_objsize_t
 kogmo_rtdb_obj_mem_init (kogmo_rtdb_handle_t *db_h);
@@ -32,5 +33,14 @@ kogmo_rtdb_obj_mem_attach (kogmo_rtdb_handle_t *db_h);
 void
 kogmo_rtdb_obj_mem_destroy (kogmo_rtdb_handle_t *db_h);
 
+//! highest NUMA node + 1 that object buffers can be placed on
+#define KOGMO_RTDB_NUMA_NODES_MAX 64
+
+int
+kogmo_rtdb_numa_nodes (void);
+
+int
+kogmo_rtdb_numa_node_self (void);
+
 
 #endif /* KOGMO_RTDB_RTMALLOC_H */
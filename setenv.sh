@@ -4,6 +4,12 @@
 # with histories,  e.g. 64MB for local tests, 500MB on kognimobil-refsys
 export KOGMO_RTDB_HEAPSIZE=128M
 
+# Back the database with huge pages to save TLB misses on large histories:
+# "madvise" (transparent huge pages), "memfd" or a hugetlbfs mount point.
+# hugetlbfs and memfd need enough reserved pages (/proc/sys/vm/nr_hugepages),
+# otherwise the manager falls back to madvise. Clients find the segment on their own.
+#export KOGMO_RTDB_HUGEPAGES=/dev/hugepages
+
 # Name of current database: kogmo_rtdb_man will start under this name,
 # clients using libkogmo_rtdb.so will connect to this database.
 # If you want, you can connect your clients to someone others database by
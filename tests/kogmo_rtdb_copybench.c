@@ -0,0 +1,123 @@
+/*! \file kogmo_rtdb_copybench.c
+ * \brief Benchmark for commits and reads of large objects
+ *
+ * Measures the throughput of kogmo_rtdb_obj_writedata() and
+ * kogmo_rtdb_obj_readdata() for growing object sizes, once with plain
+ * memcpy (like kogmo_rtdb_ratetest) and once with the copy functions for
+ * large data blocks. These are used above a threshold that depends on the
+ * cache size, set KOGMO_RTDB_COPY_THRESHOLD=<bytes> to change it.
+ * Each run is a separate process, because the copy function is chosen
+ * at connect.
+ *
+ * (c) 2007 Matthias Goebl <matthias.goebl*goebl.net>
+ *     Lehrstuhl fuer Realzeit-Computersysteme (RCS)
+ *     Technische Universitaet Muenchen (TUM)
+ */
+
+#include <stdio.h> /* printf */
+#include <unistd.h> /* fork,getpid */
+#include <stdlib.h> /* exit,setenv */
+#include <sys/wait.h> /* waitpid */
+#include "kogmo_rtdb.h"
+
+#define DIEonERR(value) if (value<0) { \
+ fprintf(stderr,"%i DIED in %s line %i with error %i\n",getpid(),__FILE__,__LINE__,-value);exit(1);}
+
+#define OBJSIZE_MAX (16*1024*1024)
+#define SIZE_MIN ((int)sizeof(kogmo_rtdb_subobj_base_t))
+
+static void
+measure (const char *what, int size_max)
+{
+  kogmo_rtdb_handle_t *dbc;
+  kogmo_rtdb_connect_info_t dbinfo;
+  kogmo_rtdb_obj_info_t objinfo;
+  kogmo_rtdb_subobj_base_t *data;
+  kogmo_rtdb_objid_t oid;
+  kogmo_timestamp_t ts_start,ts_stop;
+  double write_time, read_time;
+  int err, i, size, loops;
+
+  data = malloc ( size_max );
+  if ( data == NULL ) DIEonERR(-KOGMO_RTDB_ERR_NOMEMORY);
+  for(i=0;i<size_max;i++)
+    ((char*)data)[i] = i;
+
+  err = kogmo_rtdb_connect_initinfo (&dbinfo, "", "kogmo_rtdb_copybench", 0.001); DIEonERR(err);
+  oid = kogmo_rtdb_connect (&dbc, &dbinfo); DIEonERR(oid);
+
+  for(size=4096;size<=size_max;size*=4)
+    {
+      err = kogmo_rtdb_obj_initinfo (dbc, &objinfo,
+        "copybench", KOGMO_RTDB_OBJTYPE_C3_TEXT, size); DIEonERR(err);
+      objinfo.max_cycletime = objinfo.min_cycletime = 0.001;
+      objinfo.history_interval = 0.002; // => 3 history slots
+      objinfo.flags.immediately_delete = 1;
+      oid = kogmo_rtdb_obj_insert (dbc, &objinfo); DIEonERR(oid);
+      err = kogmo_rtdb_obj_initdata (dbc, &objinfo, data); DIEonERR(err);
+      data->size = size;
+
+      loops = 256*1024*1024 / size;
+      ts_start = kogmo_timestamp_now();
+      for(i=0;i<loops;i++)
+        {
+          err = kogmo_rtdb_obj_writedata (dbc, objinfo.oid, data); DIEonERR(err);
+        }
+      ts_stop = kogmo_timestamp_now();
+      write_time = kogmo_timestamp_diff_secs ( ts_start, ts_stop ) / loops;
+
+      ts_start = kogmo_timestamp_now();
+      for(i=0;i<loops;i++)
+        {
+          err = kogmo_rtdb_obj_readdata (dbc, objinfo.oid, 0, data, size); DIEonERR(err);
+        }
+      ts_stop = kogmo_timestamp_now();
+      read_time = kogmo_timestamp_diff_secs ( ts_start, ts_stop ) / loops;
+
+      printf("%-12s %9i bytes: commit %9.2f us %8.0f MB/s, read %9.2f us %8.0f MB/s\n",
+             what, size, write_time*1e6, size/write_time/1e6,
+             read_time*1e6, size/read_time/1e6);
+
+      err = kogmo_rtdb_obj_delete (dbc, &objinfo); DIEonERR(err);
+    }
+
+  err = kogmo_rtdb_disconnect (dbc, NULL); DIEonERR(err);
+  free (data);
+}
+
+int
+main (int argc, char **argv)
+{
+  int size_max = OBJSIZE_MAX;
+  int status;
+  pid_t pid;
+
+  if ( argc >= 2 ) size_max = atoi(argv[1]);
+  if ( size_max > OBJSIZE_MAX || size_max < 4096 )
+    {
+      printf("Usage: kogmo_rtdb_copybench [MAXSIZE]\n");
+      printf("Measures commits and reads of objects from 4096 to MAXSIZE bytes.\n");
+      printf("MAXSIZE must be between 4096 and %i, the database needs\n"
+             "3*MAXSIZE bytes of free heap (KOGMO_RTDB_HEAPSIZE).\n", OBJSIZE_MAX);
+      exit(1);
+    }
+
+  pid = fork();
+  if ( pid == 0 )
+    {
+      setenv ("KOGMO_RTDB_COPY_THRESHOLD", "0", 1);
+      measure ("memcpy", size_max);
+      exit(0);
+    }
+  waitpid (pid, &status, 0);
+
+  pid = fork();
+  if ( pid == 0 )
+    {
+      measure ("large-copy", size_max);
+      exit(0);
+    }
+  waitpid (pid, &status, 0);
+
+  return 0;
+}
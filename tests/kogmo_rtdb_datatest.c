@@ -0,0 +1,431 @@
+/*! \file kogmo_rtdb_datatest.c
+ * \brief Testprogram for partial Reads and Writes of Object Data,
+ *        guarded Pointers and Reads during History Wrap-around
+ *
+ * Copyright (c) 2007 Matthias Goebl <matthias.goebl*goebl.net>
+ *     Lehrstuhl fuer Realzeit-Computersysteme (RCS)
+ *     Technische Universitaet Muenchen (TUM)
+ */
+
+#include <stdio.h> /* printf */
+#include <unistd.h> /* sleep,getpid */
+#include <stdlib.h> /* exit */
+#include <string.h> /* memset */
+#include <limits.h> /* INT_MAX */
+#include <signal.h> /* kill */
+#include <sys/wait.h> /* waitpid */
+#include "kogmo_rtdb.h"
+
+#define DIEonERR(value) if (value<0) { \
+ fprintf(stderr,"%i DIED in %s line %i with error %i\n",getpid(),__FILE__,__LINE__,-value);exit(1);}
+
+static int ok = 1;
+
+#define CHECK(str,cond) do { \
+                 printf("%s: %s\n", str, (cond) ? "ok" : "ERROR"); \
+                 if ( !(cond) ) ok = 0; \
+                 } while(0)
+
+// large objects with a short history, so that a concurrent writer
+// overwrites the data while it is being read
+#define BIG_INTS (256*1024)
+typedef struct
+{
+  kogmo_rtdb_subobj_base_t base;
+  int32_t intval[BIG_INTS];
+} big_obj_t;
+
+
+static void
+test_delta (kogmo_rtdb_handle_t *dbc, kogmo_rtdb_obj_info_t *obj_info)
+{
+  kogmo_rtdb_obj_c3_ints256_t obj;
+  kogmo_rtdb_obj_patch_t patch[2];
+  int32_t val = 42;
+  int err, i;
+
+  printf(              "writedata_delta:\n");
+  err = kogmo_rtdb_obj_initdata (dbc, obj_info, &obj); DIEonERR(err);
+  for (i=0;i<256;i++)
+    obj.ints.intval[i] = i;
+  err = kogmo_rtdb_obj_writedata (dbc, obj_info->oid, &obj); DIEonERR(err);
+
+  patch[0].offset = (char*)&obj.ints.intval[7] - (char*)&obj;
+  patch[0].len = sizeof (int32_t);
+  patch[0].data_p = &val;
+  err = kogmo_rtdb_obj_writedata_delta (dbc, obj_info->oid, &obj, patch, 1); DIEonERR(err);
+  err = kogmo_rtdb_obj_readdata (dbc, obj_info->oid, 0, &obj, sizeof(obj)); DIEonERR(err);
+  CHECK("patch applied", obj.ints.intval[7] == 42 && obj.ints.intval[6] == 6 && obj.ints.intval[8] == 8);
+
+  // invalid patches must be rejected without touching the data
+  patch[0].offset = INT_MAX - 1;
+  patch[0].len = 4; // offset+len overflows
+  err = kogmo_rtdb_obj_writedata_delta (dbc, obj_info->oid, &obj, patch, 1);
+  CHECK("offset+len overflow", err == -KOGMO_RTDB_ERR_INVALID);
+  patch[0].offset = sizeof (kogmo_rtdb_subobj_base_t);
+  patch[0].len = INT_MAX;
+  err = kogmo_rtdb_obj_writedata_delta (dbc, obj_info->oid, &obj, patch, 1);
+  CHECK("len overflow", err == -KOGMO_RTDB_ERR_INVALID);
+  patch[0].offset = sizeof (obj) - 2;
+  patch[0].len = 4;
+  err = kogmo_rtdb_obj_writedata_delta (dbc, obj_info->oid, &obj, patch, 1);
+  CHECK("beyond size", err == -KOGMO_RTDB_ERR_INVALID);
+  patch[0].offset = 0;
+  patch[0].len = 4;
+  err = kogmo_rtdb_obj_writedata_delta (dbc, obj_info->oid, &obj, patch, 1);
+  CHECK("into header", err == -KOGMO_RTDB_ERR_INVALID);
+  patch[0].offset = sizeof (kogmo_rtdb_subobj_base_t);
+  patch[0].len = -1;
+  err = kogmo_rtdb_obj_writedata_delta (dbc, obj_info->oid, &obj, patch, 1);
+  CHECK("negative len", err == -KOGMO_RTDB_ERR_INVALID);
+  // one bad patch rejects the whole commit
+  patch[0].offset = (char*)&obj.ints.intval[8] - (char*)&obj;
+  patch[0].len = sizeof (int32_t);
+  patch[1].offset = -8;
+  patch[1].len = 4;
+  patch[1].data_p = &val;
+  err = kogmo_rtdb_obj_writedata_delta (dbc, obj_info->oid, &obj, patch, 2);
+  CHECK("negative offset", err == -KOGMO_RTDB_ERR_INVALID);
+
+  err = kogmo_rtdb_obj_readdata (dbc, obj_info->oid, 0, &obj, sizeof(obj)); DIEonERR(err);
+  CHECK("data unchanged", obj.ints.intval[7] == 42 && obj.ints.intval[8] == 8
+                          && obj.ints.intval[255] == 255);
+}
+
+
+static void
+test_range (kogmo_rtdb_handle_t *dbc, kogmo_rtdb_obj_info_t *obj_info)
+{
+  kogmo_rtdb_obj_c3_ints256_t obj;
+  int hdr = sizeof (kogmo_rtdb_subobj_base_t);
+  int err, i;
+
+  printf(              "readdata_range:\n");
+  err = kogmo_rtdb_obj_initdata (dbc, obj_info, &obj); DIEonERR(err);
+  for (i=0;i<256;i++)
+    obj.ints.intval[i] = i;
+  err = kogmo_rtdb_obj_writedata (dbc, obj_info->oid, &obj); DIEonERR(err);
+
+  memset (&obj, 0xff, sizeof(obj));
+  err = kogmo_rtdb_obj_readdata_range (dbc, obj_info->oid, 0, hdr + 10*4, 2*4, &obj); DIEonERR(err);
+  CHECK("range", err == sizeof(obj) && obj.ints.intval[10] == 10 && obj.ints.intval[11] == 11
+                 && obj.ints.intval[9] == -1 && obj.ints.intval[12] == -1
+                 && obj.base.size == hdr + 12*4);
+
+  memset (&obj, 0xff, sizeof(obj));
+  err = kogmo_rtdb_obj_readdata_range (dbc, obj_info->oid, 0, sizeof(obj) - 4, 100, &obj); DIEonERR(err);
+  CHECK("range beyond size", obj.ints.intval[255] == 255 && obj.ints.intval[254] == -1
+                             && obj.base.size == sizeof(obj));
+
+  // nothing but the header may be copied for ranges outside the data
+  memset (&obj, 0xff, sizeof(obj));
+  err = kogmo_rtdb_obj_readdata_range (dbc, obj_info->oid, 0, INT_MAX - 1, 4, &obj); DIEonERR(err);
+  CHECK("offset+len overflow", err == sizeof(obj) && obj.base.size == hdr && obj.ints.intval[0] == -1);
+  memset (&obj, 0xff, sizeof(obj));
+  err = kogmo_rtdb_obj_readdata_range (dbc, obj_info->oid, 0, hdr + 4, INT_MAX, &obj); DIEonERR(err);
+  CHECK("len overflow", obj.ints.intval[0] == -1 && obj.ints.intval[1] == 1
+                        && obj.ints.intval[255] == 255 && obj.base.size == sizeof(obj));
+  memset (&obj, 0xff, sizeof(obj));
+  err = kogmo_rtdb_obj_readdata_range (dbc, obj_info->oid, 0, 8, 4, &obj); DIEonERR(err);
+  CHECK("len within header", obj.base.size == hdr && obj.ints.intval[0] == -1);
+  memset (&obj, 0xff, sizeof(obj));
+  err = kogmo_rtdb_obj_readdata_range (dbc, obj_info->oid, 0, 8, hdr - 8 + 4, &obj); DIEonERR(err);
+  CHECK("range from header", obj.base.size == hdr + 4 && obj.ints.intval[0] == 0 && obj.ints.intval[1] == -1);
+  memset (&obj, 0xff, sizeof(obj));
+  err = kogmo_rtdb_obj_readdata_range (dbc, obj_info->oid, 0, sizeof(obj), 4, &obj); DIEonERR(err);
+  CHECK("offset at end", obj.base.size == hdr && obj.ints.intval[255] == -1);
+
+  err = kogmo_rtdb_obj_readdata_range (dbc, obj_info->oid, 0, -4, 4, &obj);
+  CHECK("negative offset", err == -KOGMO_RTDB_ERR_INVALID);
+  err = kogmo_rtdb_obj_readdata_range (dbc, obj_info->oid, 0, hdr, -4, &obj);
+  CHECK("negative len", err == -KOGMO_RTDB_ERR_INVALID);
+}
+
+
+static void
+test_between (kogmo_rtdb_handle_t *dbc)
+{
+  kogmo_rtdb_obj_info_t obj_info;
+  kogmo_rtdb_obj_c3_ints256_t obj, hist[16], *ptrs[16];
+  kogmo_timestamp_t c[18], first_ts, last_ts;
+  int err, i, n, h;
+
+  printf(              "readdata_between:\n");
+  err = kogmo_rtdb_obj_initinfo (dbc, &obj_info, "data-test-between", KOGMO_RTDB_OBJTYPE_C3_INTS, sizeof (obj)); DIEonERR(err);
+  obj_info.history_interval = 0.25;
+  obj_info.min_cycletime = obj_info.max_cycletime = 0.05;
+  err = kogmo_rtdb_obj_insert (dbc, &obj_info); DIEonERR(err);
+  h = obj_info.history_size;
+  if ( h < 4 || h > 16 )
+    DIEonERR(-KOGMO_RTDB_ERR_INVALID);
+  err = kogmo_rtdb_obj_initdata (dbc, &obj_info, &obj); DIEonERR(err);
+  // two more frames than the history holds, the frames 2..h+1 remain
+  for (i=0;i<h+2;i++)
+    {
+      obj.ints.intval[0] = i;
+      err = kogmo_rtdb_obj_writedata (dbc, obj_info.oid, &obj); DIEonERR(err);
+      c[i] = obj.base.committed_ts;
+    }
+
+  n = kogmo_rtdb_obj_readdata_between (dbc, obj_info.oid, 0, kogmo_timestamp_now (), hist, sizeof (obj), 16); DIEonERR(n);
+  for (i=0;i<n;i++)
+    if ( hist[i].ints.intval[0] != i+2 || hist[i].base.committed_ts != c[i+2] )
+      break;
+  CHECK("whole history, oldest first", n == h && i == n);
+  n = kogmo_rtdb_obj_readdata_between (dbc, obj_info.oid, c[3], c[5], hist, sizeof (obj), 16); DIEonERR(n);
+  CHECK("window with its bounds", n == 3 && hist[0].ints.intval[0] == 3 && hist[2].ints.intval[0] == 5);
+  n = kogmo_rtdb_obj_readdata_between (dbc, obj_info.oid, c[3]+1, c[5]-1, hist, sizeof (obj), 16); DIEonERR(n);
+  CHECK("window without its bounds", n == 1 && hist[0].ints.intval[0] == 4);
+  n = kogmo_rtdb_obj_readdata_between (dbc, obj_info.oid, 0, kogmo_timestamp_now (), hist, sizeof (obj), 2); DIEonERR(n);
+  CHECK("max_count gives the oldest", n == 2 && hist[0].ints.intval[0] == 2 && hist[1].ints.intval[0] == 3);
+  n = kogmo_rtdb_obj_readdata_between (dbc, obj_info.oid, c[h+1]+1, kogmo_timestamp_now (), hist, sizeof (obj), 16);
+  CHECK("window after the latest data", n == 0);
+  n = kogmo_rtdb_obj_readdata_between (dbc, obj_info.oid, c[5], c[3], hist, sizeof (obj), 16);
+  CHECK("window ends before it begins", n == -KOGMO_RTDB_ERR_INVALID);
+  n = kogmo_rtdb_obj_readdata_between (dbc, obj_info.oid, 0, kogmo_timestamp_now (), hist, sizeof (kogmo_rtdb_subobj_base_t) - 1, 16);
+  CHECK("size smaller than the header", n == -KOGMO_RTDB_ERR_INVALID);
+
+  n = kogmo_rtdb_obj_readdata_between_ptr (dbc, obj_info.oid, 0, kogmo_timestamp_now (), ptrs, 16); DIEonERR(n);
+  for (i=0;i<n;i++)
+    if ( ptrs[i]->ints.intval[0] != i+2 || ptrs[i]->base.committed_ts != c[i+2] )
+      break;
+  CHECK("between_ptr, oldest first", n == h && i == n);
+  first_ts = ptrs[0]->base.committed_ts;
+  last_ts = ptrs[n-1]->base.committed_ts;
+  err = kogmo_rtdb_obj_writedata (dbc, obj_info.oid, &obj); DIEonERR(err);
+  CHECK("between_ptr, the oldest is overwritten first",
+        ptrs[0]->base.committed_ts != first_ts && ptrs[n-1]->base.committed_ts == last_ts);
+
+  err = kogmo_rtdb_obj_delete (dbc, &obj_info); DIEonERR(err);
+}
+
+
+static void
+test_ptr (kogmo_rtdb_handle_t *dbc)
+{
+  kogmo_rtdb_obj_info_t obj_info;
+  kogmo_rtdb_obj_c3_ints256_t obj, *obj_p;
+  kogmo_timestamp_t committed_ts;
+  int err, i;
+
+  printf(              "guarded pointers:\n");
+  err = kogmo_rtdb_obj_initinfo (dbc, &obj_info, "data-test-ptr", KOGMO_RTDB_OBJTYPE_C3_INTS, sizeof (obj)); DIEonERR(err);
+  obj_info.history_interval = 0.1;
+  obj_info.min_cycletime = obj_info.max_cycletime = 0.1;
+  err = kogmo_rtdb_obj_insert (dbc, &obj_info); DIEonERR(err);
+  err = kogmo_rtdb_obj_readdata_ptr_begin (dbc, obj_info.oid, 0, &obj_p, &committed_ts);
+  CHECK("ptr_begin without data", err == -KOGMO_RTDB_ERR_NOTFOUND);
+  err = kogmo_rtdb_obj_initdata (dbc, &obj_info, &obj); DIEonERR(err);
+  for (i=0;i<obj_info.history_size;i++)
+    {
+      obj.ints.intval[0] = i;
+      err = kogmo_rtdb_obj_writedata (dbc, obj_info.oid, &obj); DIEonERR(err);
+    }
+
+  err = kogmo_rtdb_obj_readdata_ptr_begin (dbc, obj_info.oid, 0, &obj_p, &committed_ts); DIEonERR(err);
+  CHECK("ptr_begin gives the latest data", obj_p->ints.intval[0] == obj_info.history_size-1
+                                          && obj_p->base.committed_ts == committed_ts);
+  err = kogmo_rtdb_obj_readdata_ptr_end (dbc, obj_info.oid, &obj_p, committed_ts);
+  CHECK("ptr_end without a commit", err == 0);
+  obj.ints.intval[0] = -1;
+  err = kogmo_rtdb_obj_writedata (dbc, obj_info.oid, &obj); DIEonERR(err);
+  err = kogmo_rtdb_obj_readdata_ptr_end (dbc, obj_info.oid, &obj_p, committed_ts);
+  CHECK("ptr_end after a commit to another slot", err == 0);
+  for (i=0;i<obj_info.history_size;i++)
+    {
+      err = kogmo_rtdb_obj_writedata (dbc, obj_info.oid, &obj); DIEonERR(err);
+    }
+  err = kogmo_rtdb_obj_readdata_ptr_end (dbc, obj_info.oid, &obj_p, committed_ts);
+  CHECK("ptr_end after the slot has been overwritten", err == -KOGMO_RTDB_ERR_HISTWRAP);
+
+  err = kogmo_rtdb_obj_delete (dbc, &obj_info); DIEonERR(err);
+}
+
+
+// internal: 1 if all values of the object are the same, which the writer ensures
+static int
+big_consistent (big_obj_t *obj_p)
+{
+  int i;
+  for (i=1;i<BIG_INTS;i++)
+    if ( obj_p->intval[i] != obj_p->intval[0] )
+      return 0;
+  return 1;
+}
+
+
+// internal: commit 1,2,3.. to a and then to b until killed
+static void
+big_writer (kogmo_rtdb_obj_info_t *a_info, kogmo_rtdb_obj_info_t *b_info)
+{
+  kogmo_rtdb_handle_t *dbc;
+  kogmo_rtdb_connect_info_t dbinfo;
+  big_obj_t *obj_p = malloc (sizeof (big_obj_t));
+  int err, i, v;
+
+  err = kogmo_rtdb_connect_initinfo (&dbinfo, "", "data-test-writer", 0.1); DIEonERR(err);
+  dbinfo.flags = KOGMO_RTDB_CONNECT_FLAGS_NOHANDLERS;
+  err = kogmo_rtdb_connect (&dbc, &dbinfo); DIEonERR(err);
+  err = kogmo_rtdb_obj_initdata (dbc, a_info, obj_p); DIEonERR(err);
+  for (v=1;;v++)
+    {
+      for (i=0;i<BIG_INTS;i++)
+        obj_p->intval[i] = v;
+      err = kogmo_rtdb_obj_writedata (dbc, a_info->oid, obj_p); DIEonERR(err);
+      err = kogmo_rtdb_obj_writedata (dbc, b_info->oid, obj_p); DIEonERR(err);
+    }
+}
+
+
+static void
+test_wrap (kogmo_rtdb_handle_t *dbc)
+{
+  kogmo_rtdb_obj_info_t a_info, b_info;
+  kogmo_rtdb_obj_readmulti_t reads[2];
+  big_obj_t *a_p, *b_p, *hist_p, *ptr_p;
+  kogmo_timestamp_t end_ts, committed_ts;
+  int multi_wraps = 0, between_wraps = 0, ptr_wraps = 0, range_wraps = 0, reads_done = 0;
+  int consistent = 1, in_snapshot = 1, ptr_consistent;
+  int err, i, n, status;
+  pid_t pid;
+
+  printf(              "history wrap-around:\n");
+  a_p = malloc (sizeof (big_obj_t));
+  b_p = malloc (sizeof (big_obj_t));
+  err = kogmo_rtdb_obj_initinfo (dbc, &a_info, "data-test-wrap-a", KOGMO_RTDB_OBJTYPE_C3_INTS, sizeof (big_obj_t)); DIEonERR(err);
+  a_info.history_interval = 0.1;
+  a_info.min_cycletime = a_info.max_cycletime = 0.1;
+  a_info.flags.write_allow = 1;
+  b_info = a_info;
+  strcpy (b_info.name, "data-test-wrap-b");
+  err = kogmo_rtdb_obj_insert (dbc, &a_info); DIEonERR(err);
+  err = kogmo_rtdb_obj_insert (dbc, &b_info); DIEonERR(err);
+  hist_p = malloc (a_info.history_size * sizeof (big_obj_t));
+  memset (a_p, 0, sizeof (big_obj_t));
+  err = kogmo_rtdb_obj_initdata (dbc, &a_info, a_p); DIEonERR(err);
+  err = kogmo_rtdb_obj_writedata (dbc, a_info.oid, a_p); DIEonERR(err);
+  err = kogmo_rtdb_obj_writedata (dbc, b_info.oid, a_p); DIEonERR(err);
+
+  pid = fork ();
+  if ( pid == 0 )
+    big_writer (&a_info, &b_info);
+  DIEonERR(pid);
+
+  end_ts = kogmo_timestamp_add_secs (kogmo_timestamp_now (), 2.0);
+  while ( kogmo_timestamp_now () < end_ts )
+    {
+      // a snapshot contains b=v only together with a=v, and a=v+1 at most
+      reads[0].oid = a_info.oid; reads[0].ts = 0; reads[0].data_p = a_p; reads[0].size = sizeof (big_obj_t);
+      reads[1].oid = b_info.oid; reads[1].ts = 0; reads[1].data_p = b_p; reads[1].size = sizeof (big_obj_t);
+      err = kogmo_rtdb_obj_readdata_multi (dbc, reads, 2); DIEonERR(err);
+      if ( reads[0].result == -KOGMO_RTDB_ERR_HISTWRAP || reads[1].result == -KOGMO_RTDB_ERR_HISTWRAP )
+        multi_wraps++;
+      else
+        {
+          DIEonERR(reads[0].result); DIEonERR(reads[1].result);
+          if ( !big_consistent (a_p) || !big_consistent (b_p) )
+            consistent = 0;
+          if ( a_p->intval[0] < b_p->intval[0] || a_p->intval[0] > b_p->intval[0] + 1 )
+            in_snapshot = 0;
+        }
+
+      // each entry in one piece, in commit order
+      n = kogmo_rtdb_obj_readdata_between (dbc, a_info.oid, 0, kogmo_timestamp_now (),
+                                           hist_p, sizeof (big_obj_t), a_info.history_size);
+      if ( n == -KOGMO_RTDB_ERR_HISTWRAP )
+        between_wraps++;
+      else
+        {
+          DIEonERR(n);
+          for (i=0;i<n;i++)
+            if ( !big_consistent (&hist_p[i])
+                 || ( i > 0 && hist_p[i].intval[0] <= hist_p[i-1].intval[0] ) )
+              consistent = 0;
+        }
+
+      // what has been read through the pointer is valid if ptr_end says so
+      err = kogmo_rtdb_obj_readdata_ptr_begin (dbc, a_info.oid, 0, &ptr_p, &committed_ts); DIEonERR(err);
+      ptr_consistent = big_consistent (ptr_p);
+      err = kogmo_rtdb_obj_readdata_ptr_end (dbc, a_info.oid, &ptr_p, committed_ts);
+      if ( err == -KOGMO_RTDB_ERR_HISTWRAP )
+        ptr_wraps++;
+      else
+        {
+          DIEonERR(err);
+          if ( !ptr_consistent )
+            consistent = 0;
+        }
+
+      // the object without its beginning, in one piece and at its place
+      memset (a_p->intval, -1, sizeof (a_p->intval));
+      err = kogmo_rtdb_obj_readdata_range (dbc, a_info.oid, 0, (char*)&a_p->intval[1000] - (char*)a_p,
+                                           ( BIG_INTS - 1000 ) * sizeof (int32_t), a_p);
+      if ( err == -KOGMO_RTDB_ERR_HISTWRAP )
+        range_wraps++;
+      else
+        {
+          DIEonERR(err);
+          if ( a_p->intval[999] != -1 || a_p->intval[1000] < 0 )
+            consistent = 0;
+          for (i=1000;i<BIG_INTS;i++)
+            if ( a_p->intval[i] != a_p->intval[1000] )
+              consistent = 0;
+        }
+      reads_done++;
+    }
+
+  // the writer dies while committing, the snapshots must go on
+  kill (pid, SIGKILL);
+  waitpid (pid, &status, 0);
+  err = kogmo_rtdb_obj_readdata_multi (dbc, reads, 2);
+  CHECK("readdata_multi after a writer died", err == 2 && big_consistent (a_p) && big_consistent (b_p));
+
+  printf("%i rounds\n", reads_done);
+  printf("readdata_multi wrap-arounds: %i\n", multi_wraps);
+  printf("readdata_between wrap-arounds: %i\n", between_wraps);
+  printf("readdata_ptr_end wrap-arounds: %i\n", ptr_wraps);
+  printf("readdata_range wrap-arounds: %i\n", range_wraps);
+  CHECK("no torn data", consistent);
+  CHECK("readdata_multi snapshot bound", in_snapshot);
+
+  err = kogmo_rtdb_obj_delete (dbc, &a_info); DIEonERR(err);
+  err = kogmo_rtdb_obj_delete (dbc, &b_info); DIEonERR(err);
+  free (hist_p);
+  free (b_p);
+  free (a_p);
+}
+
+
+int
+main (int argc, char **argv)
+{
+  kogmo_rtdb_handle_t *dbc;
+  kogmo_rtdb_connect_info_t dbinfo;
+  kogmo_rtdb_obj_info_t obj_info;
+  kogmo_rtdb_objid_t oid;
+  int err;
+
+  err = kogmo_rtdb_connect_initinfo (&dbinfo, "", "data-test", 0.1); DIEonERR(err);
+  dbinfo.flags = KOGMO_RTDB_CONNECT_FLAGS_NOHANDLERS; // the writer child must not end us
+  oid = kogmo_rtdb_connect (&dbc, &dbinfo); DIEonERR(oid);
+
+  err = kogmo_rtdb_obj_initinfo (dbc, &obj_info, "data-test-object", KOGMO_RTDB_OBJTYPE_C3_INTS, sizeof (kogmo_rtdb_obj_c3_ints256_t)); DIEonERR(err);
+  oid = kogmo_rtdb_obj_insert (dbc, &obj_info); DIEonERR(oid);
+
+  test_delta (dbc, &obj_info);
+  test_range (dbc, &obj_info);
+  test_between (dbc);
+  test_ptr (dbc);
+  test_wrap (dbc);
+
+  err = kogmo_rtdb_obj_delete (dbc, &obj_info); DIEonERR(err);
+  err = kogmo_rtdb_disconnect (dbc, NULL); DIEonERR(err);
+
+  if ( !ok )
+    {
+      printf("\nWARNING: THERE WERE ERRORS!!!\n\n");
+      return 1;
+    }
+
+  return 0;
+}
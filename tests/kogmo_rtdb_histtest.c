@@ -14,6 +14,70 @@
 #define DIEonERR(value) if (value<0) { \
  fprintf(stderr,"%i DIED in %s line %i with error %i\n",getpid(),__FILE__,__LINE__,-value);exit(1);}
 
+// frames for the data_ts index get their data_ts in this scrambled order
+#define DATATS_FRAMES 23
+#define DATATS_ORDER(i) ( ( (i) * 7 ) % DATATS_FRAMES )
+
+
+// internal: the frame among first..last that a data time read must return
+// (0: datatime, 1: dataolder, 2: datayounger), -1 if there is none
+static int
+datats_expected (kogmo_timestamp_t *d, int first, int last, kogmo_timestamp_t ts, int mode)
+{
+  int i, found = -1;
+  for (i=first; i<=last; i++)
+    {
+      if ( ( mode == 0 && d[i] <= ts ) || ( mode == 1 && d[i] < ts ) )
+        {
+          if ( found < 0 || d[i] > d[found] )
+            found = i;
+        }
+      if ( mode == 2 && d[i] > ts )
+        {
+          if ( found < 0 || d[i] < d[found] )
+            found = i;
+        }
+    }
+  return found;
+}
+
+
+// internal: check the data time reads at and around the data_ts of the frames
+// 0..last, the history holds the frames first..last. returns 1 if all are right
+static int
+datats_check (kogmo_rtdb_handle_t *dbc, kogmo_rtdb_objid_t oid,
+              kogmo_timestamp_t *d, int first, int last)
+{
+  kogmo_rtdb_obj_c3_ints256_t obj;
+  kogmo_timestamp_t ts;
+  int i, delta, mode, expected, got, ok = 1;
+  kogmo_rtdb_objsize_t err;
+
+  for (i=0; i<=last; i++)
+    for (delta=-1; delta<=1; delta++)
+      for (mode=0; mode<3; mode++)
+        {
+          ts = d[i] + delta;
+          if ( mode == 0 )
+            err = kogmo_rtdb_obj_readdata_datatime (dbc, oid, ts, &obj, sizeof(obj));
+          else if ( mode == 1 )
+            err = kogmo_rtdb_obj_readdata_dataolder (dbc, oid, ts, &obj, sizeof(obj));
+          else
+            err = kogmo_rtdb_obj_readdata_datayounger (dbc, oid, ts, &obj, sizeof(obj));
+          got = err < 0 ? -1 : obj.ints.intval[0];
+          expected = datats_expected (d, first, last, ts, mode);
+          if ( got != expected )
+            {
+              printf(" => ERROR: %s of frame %i%+i gave frame %i instead of %i !!!\n",
+                     mode == 0 ? "datatime" : mode == 1 ? "dataolder" : "datayounger",
+                     i, delta, got, expected);
+              ok = 0;
+            }
+        }
+  printf("frames %i..%i: %s\n", first, last, ok ? "ok" : "ERROR");
+  return ok;
+}
+
 int
 main (int argc, char **argv)
 {
@@ -21,7 +85,7 @@ main (int argc, char **argv)
   kogmo_rtdb_connect_info_t dbinfo;
   kogmo_rtdb_obj_info_t obj_info;
   kogmo_rtdb_obj_c3_ints256_t obj, *obj_p;
-  kogmo_timestamp_t d[4], c[4], t0;
+  kogmo_timestamp_t d[4], c[4], t0, dd[DATATS_FRAMES];
   kogmo_rtdb_objid_t oid;
   int ok = 1;
   int err;
@@ -91,6 +155,31 @@ else
   err = kogmo_rtdb_obj_readdata_datayounger (dbc, obj_info.oid, d[2]-1, &obj, sizeof(obj)); DIEonERR(err); PRT("read [2]-1",2);
 
   err = kogmo_rtdb_obj_delete (dbc, &obj_info); DIEonERR(err);
+
+  // frames committed out of data_ts order, e.g. late sensor frames
+  err = kogmo_rtdb_obj_initinfo (dbc, &obj_info, "history-test-datats", KOGMO_RTDB_OBJTYPE_C3_INTS, sizeof (obj)); DIEonERR(err);
+  obj_info.history_interval = 1.0;
+  obj_info.min_cycletime = obj_info.max_cycletime = 0.25;
+  obj_info.flags.data_ts_index = 1;
+  oid = kogmo_rtdb_obj_insert (dbc, &obj_info); DIEonERR(oid);
+  if ( 2 * obj_info.history_size > DATATS_FRAMES )
+    DIEonERR(-KOGMO_RTDB_ERR_INVALID);
+  err = kogmo_rtdb_obj_initdata (dbc, &obj_info, &obj); DIEonERR(err);
+  for(i=0;i<2*obj_info.history_size;i++)
+    {
+      dd[i] = obj.base.data_ts = t0 + DATATS_ORDER(i) * 1000;
+      obj.ints.intval[0] = i;
+      err = kogmo_rtdb_obj_writedata (dbc, obj_info.oid, &obj); DIEonERR(err);
+      if ( i == obj_info.history_size - 1 )
+        {
+          printf(      "data_ts index, out of order:\n");
+          if ( !datats_check (dbc, obj_info.oid, dd, 0, i) ) ok = 0;
+        }
+    }
+  printf(              "data_ts index, after the history wrapped:\n");
+  if ( !datats_check (dbc, obj_info.oid, dd, obj_info.history_size, i-1) ) ok = 0;
+  err = kogmo_rtdb_obj_delete (dbc, &obj_info); DIEonERR(err);
+
   err = kogmo_rtdb_disconnect (dbc, NULL); DIEonERR(err);
 
   if ( !ok )
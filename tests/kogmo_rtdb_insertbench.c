@@ -0,0 +1,112 @@
+/*! \file kogmo_rtdb_insertbench.c
+ * \brief Benchmark for object creation and deletion
+ *
+ * Fills the object table with a number of objects and measures the
+ * latency of inserting and deleting objects, with and without keep_alloc.
+ *
+ * (c) 2007 Matthias Goebl <matthias.goebl*goebl.net>
+ *     Lehrstuhl fuer Realzeit-Computersysteme (RCS)
+ *     Technische Universitaet Muenchen (TUM)
+ */
+
+#include <stdio.h> /* printf */
+#include <unistd.h> /* getpid */
+#include <stdlib.h> /* exit */
+#include "kogmo_rtdb.h"
+
+#define DIEonERR(value) if (value<0) { \
+ fprintf(stderr,"%i DIED in %s line %i with error %i\n",getpid(),__FILE__,__LINE__,-value);exit(1);}
+
+#define OBJS_MAX (1024*1024)
+#define BURST 32
+
+static void
+init_obj (kogmo_rtdb_handle_t *dbc, kogmo_rtdb_obj_info_t *info,
+          const char *prefix, int i, int keep_alloc)
+{
+  char name[KOGMO_RTDB_OBJMETA_NAME_MAXLEN];
+  int err;
+  snprintf(name, sizeof(name), "%s-%i", prefix, i);
+  err = kogmo_rtdb_obj_initinfo (dbc, info, name,
+    KOGMO_RTDB_OBJTYPE_C3_TEXT, sizeof (kogmo_rtdb_subobj_base_t) + 64); DIEonERR(err);
+  info->max_cycletime = info->min_cycletime = 0.04;
+  info->history_interval = 0.2;
+  info->flags.keep_alloc = keep_alloc;
+}
+
+// like a tracker: create and delete a burst of objects per cycle
+static void
+bench (kogmo_rtdb_handle_t *dbc, int loops, int keep_alloc)
+{
+  kogmo_rtdb_obj_info_t info[BURST];
+  kogmo_timestamp_t ts, ins_sum = 0, del_sum = 0, ins_max = 0, del_max = 0;
+  kogmo_rtdb_objid_t oid;
+  int err, i, j;
+
+  for(i=0;i<loops;i++)
+    {
+      for(j=0;j<BURST;j++)
+        {
+          init_obj (dbc, &info[j], "insertbench-burst", j, keep_alloc);
+          ts = kogmo_timestamp_now();
+          oid = kogmo_rtdb_obj_insert (dbc, &info[j]); DIEonERR(oid);
+          ts = kogmo_timestamp_now() - ts;
+          ins_sum += ts;
+          if ( ts > ins_max ) ins_max = ts;
+        }
+      for(j=0;j<BURST;j++)
+        {
+          ts = kogmo_timestamp_now();
+          err = kogmo_rtdb_obj_delete (dbc, &info[j]); DIEonERR(err);
+          ts = kogmo_timestamp_now() - ts;
+          del_sum += ts;
+          if ( ts > del_max ) del_max = ts;
+        }
+      // deleted keep-alloc objects can be reused after the keep-deleted interval
+      if ( keep_alloc )
+        usleep(300000);
+    }
+
+  printf("%-10s insert: %8.3f us avg %8.3f us max, delete: %8.3f us avg %8.3f us max\n",
+         keep_alloc ? "keep_alloc" : "normal",
+         (double)ins_sum / ( loops * BURST ) / 1000.0, (double)ins_max / 1000.0,
+         (double)del_sum / ( loops * BURST ) / 1000.0, (double)del_max / 1000.0);
+}
+
+int
+main (int argc, char **argv)
+{
+  kogmo_rtdb_handle_t *dbc;
+  kogmo_rtdb_connect_info_t dbinfo;
+  kogmo_rtdb_obj_info_t info;
+  kogmo_rtdb_objid_t oid;
+  int err, i, objs = 500, loops = 10;
+
+  if ( argc >= 2 ) objs = atoi(argv[1]);
+  if ( argc >= 3 ) loops = atoi(argv[2]);
+  if ( objs < 0 || objs > OBJS_MAX || loops < 1 )
+    {
+      printf("Usage: kogmo_rtdb_insertbench [OBJECTS [LOOPS]]\n");
+      printf("Measures the latency of object insertion and deletion with\n"
+             "OBJECTS other objects in the database (default %i).\n", objs);
+      printf("The manager needs enough object slots (kogmo_rtdb_man -O).\n");
+      exit(1);
+    }
+
+  err = kogmo_rtdb_connect_initinfo (&dbinfo, "", "kogmo_rtdb_insertbench", 0.04); DIEonERR(err);
+  oid = kogmo_rtdb_connect (&dbc, &dbinfo); DIEonERR(oid);
+
+  for(i=0;i<objs;i++)
+    {
+      init_obj (dbc, &info, "insertbench-fill", i, 0);
+      oid = kogmo_rtdb_obj_insert (dbc, &info); DIEonERR(oid);
+    }
+  printf("inserted %i objects\n", objs);
+
+  bench (dbc, loops, 0);
+  bench (dbc, loops, 1);
+
+  // disconnecting deletes the remaining objects
+  err = kogmo_rtdb_disconnect (dbc, NULL); DIEonERR(err);
+  return 0;
+}
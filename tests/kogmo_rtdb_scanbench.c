@@ -0,0 +1,202 @@
+/*! \file kogmo_rtdb_scanbench.c
+ * \brief Benchmark for object table scans and commits
+ *
+ * Inserts a number of objects and measures the time for searches that
+ * have to scan the object table (e.g. by creator process), for lookups by
+ * object-id, for commits, for reads and commits with bound handles and
+ * for timestamped reads deep in the history of an object.
+ *
+ * (c) 2007 Matthias Goebl <matthias.goebl*goebl.net>
+ *     Lehrstuhl fuer Realzeit-Computersysteme (RCS)
+ *     Technische Universitaet Muenchen (TUM)
+ */
+
+#include <stdio.h> /* printf */
+#include <unistd.h> /* getpid */
+#include <stdlib.h> /* exit */
+#include "kogmo_rtdb.h"
+
+#define DIEonERR(value) if (value<0) { \
+ fprintf(stderr,"%i DIED in %s line %i with error %i\n",getpid(),__FILE__,__LINE__,-value);exit(1);}
+
+#define OBJS_MAX (1024*1024)
+
+static void
+report (const char *what, int loops, kogmo_timestamp_t ts_start, kogmo_timestamp_t ts_stop)
+{
+  double runtime = kogmo_timestamp_diff_secs ( ts_start, ts_stop );
+  printf("%-28s %8i loops in %f seconds => %8.3f us each\n",
+         what, loops, runtime, runtime/loops*1e6);
+}
+
+int
+main (int argc, char **argv)
+{
+  kogmo_rtdb_handle_t *dbc;
+  kogmo_rtdb_connect_info_t dbinfo;
+  kogmo_rtdb_obj_info_t *objinfo, info;
+  kogmo_rtdb_obj_handle_t *handles;
+  kogmo_rtdb_subobj_base_t data;
+  kogmo_rtdb_objid_list_t idlist;
+  kogmo_rtdb_objid_t oid, proc_oid;
+  kogmo_rtdb_objsize_t size;
+  int err, i, objs = 500, loops = 2000;
+  kogmo_timestamp_t ts_start,ts_stop,ts_hist;
+  char name[KOGMO_RTDB_OBJMETA_NAME_MAXLEN];
+
+  if ( argc >= 2 ) objs = atoi(argv[1]);
+  if ( argc >= 3 ) loops = atoi(argv[2]);
+  if ( objs < 1 || objs > OBJS_MAX || loops < 1 )
+    {
+      printf("Usage: kogmo_rtdb_scanbench [OBJECTS [LOOPS]]\n");
+      printf("Measures object table scans, lookups and commits.\n");
+      printf("OBJECTS must be between 1 and %i, the manager needs enough\n"
+             "object slots for them (kogmo_rtdb_man -O).\n", OBJS_MAX);
+      exit(1);
+    }
+
+  objinfo = malloc ( objs * sizeof (kogmo_rtdb_obj_info_t) );
+  if ( objinfo == NULL ) DIEonERR(-KOGMO_RTDB_ERR_NOMEMORY);
+
+  err = kogmo_rtdb_connect_initinfo (&dbinfo, "", "kogmo_rtdb_scanbench", 0.001); DIEonERR(err);
+  proc_oid = kogmo_rtdb_connect (&dbc, &dbinfo); DIEonERR(proc_oid);
+
+  for(i=0;i<objs;i++)
+    {
+      snprintf(name, sizeof(name), "scanbench-%i", i);
+      err = kogmo_rtdb_obj_initinfo (dbc, &objinfo[i], name,
+        KOGMO_RTDB_OBJTYPE_C3_TEXT + i % 16, sizeof (data)); DIEonERR(err);
+      objinfo[i].max_cycletime = objinfo[i].min_cycletime = 0.001;
+      objinfo[i].history_interval = 0.010;
+      oid = kogmo_rtdb_obj_insert (dbc, &objinfo[i]); DIEonERR(oid);
+    }
+  printf("inserted %i objects\n", objs);
+
+  // the creator is not indexed, so these scan all slots
+  ts_start = kogmo_timestamp_now();
+  for(i=0;i<loops;i++)
+    {
+      err = kogmo_rtdb_obj_searchinfo (dbc, "", 0, 0, proc_oid, 0, idlist, 0); DIEonERR(err);
+    }
+  ts_stop = kogmo_timestamp_now();
+  report ("searchinfo by process", loops, ts_start, ts_stop);
+
+  ts_start = kogmo_timestamp_now();
+  for(i=0;i<loops;i++)
+    {
+      err = kogmo_rtdb_obj_searchinfo (dbc, "", 0, 0, -1, 0, idlist, 0);
+      if ( err != -KOGMO_RTDB_ERR_NOTFOUND ) DIEonERR(err);
+    }
+  ts_stop = kogmo_timestamp_now();
+  report ("searchinfo without match", loops, ts_start, ts_stop);
+
+  ts_start = kogmo_timestamp_now();
+  for(i=0;i<loops;i++)
+    {
+      err = kogmo_rtdb_obj_searchinfo (dbc, "~scanbench-1.*", 0, 0, 0, 0, idlist, 0); DIEonERR(err);
+    }
+  ts_stop = kogmo_timestamp_now();
+  report ("searchinfo by regex", loops, ts_start, ts_stop);
+
+  ts_start = kogmo_timestamp_now();
+  for(i=0;i<loops;i++)
+    {
+      err = kogmo_rtdb_obj_searchinfo (dbc, "", KOGMO_RTDB_OBJTYPE_C3_TEXT, 0, 0, 0, idlist, 0); DIEonERR(err);
+    }
+  ts_stop = kogmo_timestamp_now();
+  report ("searchinfo by type", loops, ts_start, ts_stop);
+
+  ts_start = kogmo_timestamp_now();
+  for(i=0;i<loops;i++)
+    {
+      err = kogmo_rtdb_obj_readinfo (dbc, objinfo[i % objs].oid, 0, &info); DIEonERR(err);
+    }
+  ts_stop = kogmo_timestamp_now();
+  report ("readinfo", loops, ts_start, ts_stop);
+
+  err = kogmo_rtdb_obj_initdata (dbc, &objinfo[0], &data); DIEonERR(err);
+  ts_start = kogmo_timestamp_now();
+  for(i=0;i<loops*10;i++)
+    {
+      err = kogmo_rtdb_obj_writedata (dbc, objinfo[i % objs].oid, &data); DIEonERR(err);
+    }
+  ts_stop = kogmo_timestamp_now();
+  report ("writedata", loops*10, ts_start, ts_stop);
+
+  ts_start = kogmo_timestamp_now();
+  for(i=0;i<loops*10;i++)
+    {
+      size = kogmo_rtdb_obj_readdata (dbc, objinfo[i % objs].oid, 0, &data, sizeof(data)); DIEonERR(size);
+    }
+  ts_stop = kogmo_timestamp_now();
+  report ("readdata", loops*10, ts_start, ts_stop);
+
+  handles = malloc ( objs * sizeof (kogmo_rtdb_obj_handle_t) );
+  if ( handles == NULL ) DIEonERR(-KOGMO_RTDB_ERR_NOMEMORY);
+  for(i=0;i<objs;i++)
+    {
+      err = kogmo_rtdb_obj_bind (dbc, objinfo[i].oid, &handles[i]); DIEonERR(err);
+    }
+
+  ts_start = kogmo_timestamp_now();
+  for(i=0;i<loops*10;i++)
+    {
+      err = kogmo_rtdb_obj_writedata_bound (dbc, &handles[i % objs], &data); DIEonERR(err);
+    }
+  ts_stop = kogmo_timestamp_now();
+  report ("writedata bound", loops*10, ts_start, ts_stop);
+
+  ts_start = kogmo_timestamp_now();
+  for(i=0;i<loops*10;i++)
+    {
+      size = kogmo_rtdb_obj_readdata_bound (dbc, &handles[i % objs], 0, &data, sizeof(data)); DIEonERR(size);
+    }
+  ts_stop = kogmo_timestamp_now();
+  report ("readdata bound", loops*10, ts_start, ts_stop);
+
+  // an object with a deep history, filled twice,
+  // the searched entry is half the history old
+  err = kogmo_rtdb_obj_initinfo (dbc, &info, "scanbench-history",
+    KOGMO_RTDB_OBJTYPE_C3_TEXT, sizeof (data)); DIEonERR(err);
+  info.max_cycletime = info.min_cycletime = 0.0001;
+  info.history_interval = 1.0;
+  oid = kogmo_rtdb_obj_insert (dbc, &info); DIEonERR(oid);
+  err = kogmo_rtdb_obj_readinfo (dbc, oid, 0, &info); DIEonERR(err);
+  ts_hist = 0;
+  for(i=0;i<info.history_size*2;i++)
+    {
+      err = kogmo_rtdb_obj_writedata (dbc, oid, &data); DIEonERR(err);
+      if ( i == info.history_size*3/2 )
+        {
+          size = kogmo_rtdb_obj_readdata (dbc, oid, 0, &data, sizeof(data)); DIEonERR(size);
+          ts_hist = data.committed_ts;
+        }
+    }
+
+  ts_start = kogmo_timestamp_now();
+  for(i=0;i<loops;i++)
+    {
+      size = kogmo_rtdb_obj_readdata (dbc, oid, ts_hist, &data, sizeof(data)); DIEonERR(size);
+    }
+  ts_stop = kogmo_timestamp_now();
+  report ("readdata at time", loops, ts_start, ts_stop);
+
+  ts_start = kogmo_timestamp_now();
+  for(i=0;i<loops;i++)
+    {
+      size = kogmo_rtdb_obj_readdata_younger (dbc, oid, ts_hist, &data, sizeof(data)); DIEonERR(size);
+    }
+  ts_stop = kogmo_timestamp_now();
+  report ("readdata younger", loops, ts_start, ts_stop);
+
+  err = kogmo_rtdb_obj_delete (dbc, &info); DIEonERR(err);
+
+  for(i=0;i<objs;i++)
+    {
+      err = kogmo_rtdb_obj_delete (dbc, &objinfo[i]); DIEonERR(err);
+    }
+  err = kogmo_rtdb_disconnect (dbc, NULL); DIEonERR(err);
+  free (handles);
+  free (objinfo);
+  return 0;
+}
@@ -0,0 +1,408 @@
+/*! \file kogmo_rtdb_waittest.c
+ * \brief Testprogram for Waiting for new Data of one or several Objects
+ *
+ * Copyright (c) 2007 Matthias Goebl <matthias.goebl*goebl.net>
+ *     Lehrstuhl fuer Realzeit-Computersysteme (RCS)
+ *     Technische Universitaet Muenchen (TUM)
+ */
+
+#include <stdio.h> /* printf */
+#include <unistd.h> /* fork,usleep,getpid */
+#include <stdlib.h> /* exit */
+#include <sys/time.h> /* getrusage */
+#include <sys/resource.h> /* getrusage */
+#include <sys/wait.h> /* waitpid */
+#include <poll.h> /* poll */
+#include "kogmo_rtdb.h"
+
+#define DIEonERR(value) if (value<0) { \
+ fprintf(stderr,"%i DIED in %s line %i with error %i\n",getpid(),__FILE__,__LINE__,-value);exit(1);}
+
+static int ok = 1;
+
+#define CHECK(str,cond) do { \
+                 printf("%s: %s\n", str, (cond) ? "ok" : "ERROR"); \
+                 if ( !(cond) ) ok = 0; \
+                 } while(0)
+
+
+// internal: insert an object and write one frame with the given data_ts
+static void
+insert_written (kogmo_rtdb_handle_t *dbc, kogmo_rtdb_obj_info_t *obj_info,
+                char *name, kogmo_timestamp_t data_ts)
+{
+  kogmo_rtdb_obj_c3_ints256_t obj;
+  int err;
+
+  err = kogmo_rtdb_obj_initinfo (dbc, obj_info, name, KOGMO_RTDB_OBJTYPE_C3_INTS, sizeof (obj)); DIEonERR(err);
+  obj_info->flags.write_allow = 1;
+  err = kogmo_rtdb_obj_insert (dbc, obj_info); DIEonERR(err);
+  err = kogmo_rtdb_obj_initdata (dbc, obj_info, &obj); DIEonERR(err);
+  obj.base.data_ts = data_ts;
+  err = kogmo_rtdb_obj_writedata (dbc, obj_info->oid, &obj); DIEonERR(err);
+}
+
+
+// internal: latest commit timestamp of an object
+static kogmo_timestamp_t
+committed_ts (kogmo_rtdb_handle_t *dbc, kogmo_rtdb_objid_t oid)
+{
+  kogmo_rtdb_obj_c3_ints256_t obj;
+  int err;
+
+  err = kogmo_rtdb_obj_readdata (dbc, oid, 0, &obj, sizeof (obj)); DIEonERR(err);
+  return obj.base.committed_ts;
+}
+
+
+// internal: cpu time of this process in seconds
+static double
+cpu_secs (void)
+{
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6
+         + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+
+// internal: connect a forked child, it reports its checks with its exit status
+static kogmo_rtdb_handle_t *
+child_connect (void)
+{
+  kogmo_rtdb_handle_t *dbc;
+  kogmo_rtdb_connect_info_t dbinfo;
+  int err;
+
+  err = kogmo_rtdb_connect_initinfo (&dbinfo, "", "wait-test-child", 0.1); DIEonERR(err);
+  dbinfo.flags = KOGMO_RTDB_CONNECT_FLAGS_NOHANDLERS;
+  err = kogmo_rtdb_connect (&dbc, &dbinfo); DIEonERR(err);
+  return dbc;
+}
+
+
+// internal: exit the child
+static void
+child_exit (kogmo_rtdb_handle_t *dbc)
+{
+  kogmo_rtdb_disconnect (dbc, NULL);
+  exit (ok ? 0 : 1);
+}
+
+
+// internal: fork a child that commits value to an object after delay seconds
+static pid_t
+commit_later (kogmo_rtdb_obj_info_t *obj_info, double delay, int value)
+{
+  kogmo_rtdb_handle_t *dbc;
+  kogmo_rtdb_obj_c3_ints256_t obj;
+  int err;
+  pid_t pid;
+
+  fflush (stdout); // or the child prints it again
+  pid = fork ();
+  if ( pid == 0 )
+    {
+      dbc = child_connect ();
+      usleep (delay * 1e6);
+      err = kogmo_rtdb_obj_initdata (dbc, obj_info, &obj); DIEonERR(err);
+      obj.ints.intval[0] = value;
+      err = kogmo_rtdb_obj_writedata (dbc, obj_info->oid, &obj); DIEonERR(err);
+      child_exit (dbc);
+    }
+  DIEonERR(pid);
+  return pid;
+}
+
+
+// internal: delete an object after a while, so that the child is waiting
+static void
+delete_later (kogmo_rtdb_handle_t *dbc, kogmo_rtdb_obj_info_t *obj_info, pid_t pid)
+{
+  int err, status;
+
+  usleep (300000);
+  err = kogmo_rtdb_obj_delete (dbc, obj_info); DIEonERR(err);
+  waitpid (pid, &status, 0);
+  CHECK("child woke up in time", WIFEXITED (status) && WEXITSTATUS (status) == 0);
+}
+
+
+static void
+test_waitnext (kogmo_rtdb_handle_t *dbc)
+{
+  kogmo_rtdb_obj_info_t obj_info;
+  kogmo_rtdb_obj_c3_ints256_t obj;
+  kogmo_timestamp_t old_ts, start_ts;
+  double secs, cpu;
+  int err;
+  pid_t pid;
+
+  printf(              "waitnext:\n");
+  insert_written (dbc, &obj_info, "wait-test-next", kogmo_timestamp_now ());
+  old_ts = committed_ts (dbc, obj_info.oid);
+
+  err = kogmo_rtdb_obj_readdata_waitnext_until (dbc, obj_info.oid, old_ts - 1, &obj, sizeof (obj),
+                                                kogmo_timestamp_add_secs (kogmo_timestamp_now (), 1.0));
+  CHECK("data that is already new", err == sizeof (obj) && obj.base.committed_ts == old_ts);
+
+  // the reader must sleep in the kernel, not poll or spin
+  start_ts = kogmo_timestamp_now ();
+  cpu = cpu_secs ();
+  err = kogmo_rtdb_obj_readdata_waitnext_until (dbc, obj_info.oid, old_ts, &obj, sizeof (obj),
+                                                kogmo_timestamp_add_secs (start_ts, 0.5));
+  secs = kogmo_timestamp_diff_secs (start_ts, kogmo_timestamp_now ());
+  cpu = cpu_secs () - cpu;
+  printf("timeout after %.3f seconds, %.3f seconds cpu time\n", secs, cpu);
+  CHECK("timeout", err == -KOGMO_RTDB_ERR_TIMEOUT);
+  CHECK("timeout not too early, not too late", secs >= 0.5 && secs < 1.0);
+  CHECK("no busy waiting", cpu < 0.1);
+
+  pid = commit_later (&obj_info, 0.3, 42);
+  start_ts = kogmo_timestamp_now ();
+  err = kogmo_rtdb_obj_readdata_waitnext_until (dbc, obj_info.oid, old_ts, &obj, sizeof (obj),
+                                                kogmo_timestamp_add_secs (start_ts, 5.0));
+  secs = kogmo_timestamp_diff_secs (start_ts, kogmo_timestamp_now ());
+  CHECK("wakeup on a commit of another process", err == sizeof (obj) && obj.ints.intval[0] == 42 && secs < 2.0);
+  waitpid (pid, &err, 0);
+  old_ts = obj.base.committed_ts;
+
+  fflush (stdout); // or the child prints it again
+  pid = fork ();
+  if ( pid == 0 )
+    {
+      dbc = child_connect ();
+      err = kogmo_rtdb_obj_readdata_waitnext_until (dbc, obj_info.oid, old_ts, &obj, sizeof (obj),
+                                                    kogmo_timestamp_add_secs (kogmo_timestamp_now (), 5.0));
+      CHECK("wakeup on deletion", err == -KOGMO_RTDB_ERR_NOTFOUND);
+      child_exit (dbc);
+    }
+  DIEonERR(pid);
+  delete_later (dbc, &obj_info, pid);
+}
+
+
+static void
+test_wait_any (kogmo_rtdb_handle_t *dbc)
+{
+  kogmo_rtdb_obj_info_t a_info, b_info;
+  kogmo_rtdb_objid_t oids[2];
+  kogmo_timestamp_t old_ts[2];
+  int changed[2];
+  int err;
+  pid_t pid;
+
+  printf(              "wait_any:\n");
+  insert_written (dbc, &a_info, "wait-test-any-a", kogmo_timestamp_now ());
+  insert_written (dbc, &b_info, "wait-test-any-b", kogmo_timestamp_now ());
+  oids[0] = a_info.oid;
+  oids[1] = b_info.oid;
+  old_ts[0] = committed_ts (dbc, a_info.oid);
+  old_ts[1] = committed_ts (dbc, b_info.oid);
+
+  err = kogmo_rtdb_obj_wait_any (dbc, oids, old_ts, 2,
+                                 kogmo_timestamp_add_secs (kogmo_timestamp_now (), 0.1), changed);
+  CHECK("no change", err == -KOGMO_RTDB_ERR_TIMEOUT);
+
+  pid = commit_later (&b_info, 0.3, 1);
+  err = kogmo_rtdb_obj_wait_any (dbc, oids, old_ts, 2,
+                                 kogmo_timestamp_add_secs (kogmo_timestamp_now (), 5.0), changed);
+  CHECK("wakeup on a commit", err == 1 && changed[0] == 0 && changed[1] == 1);
+  waitpid (pid, &err, 0);
+  old_ts[1] = committed_ts (dbc, b_info.oid);
+
+  fflush (stdout); // or the child prints it again
+  pid = fork ();
+  if ( pid == 0 )
+    {
+      dbc = child_connect ();
+      err = kogmo_rtdb_obj_wait_any (dbc, oids, old_ts, 2,
+                                     kogmo_timestamp_add_secs (kogmo_timestamp_now (), 5.0), changed);
+      CHECK("wakeup on deletion", err == 1 && changed[0] == 0 && changed[1] == -1);
+      child_exit (dbc);
+    }
+  DIEonERR(pid);
+  delete_later (dbc, &b_info, pid);
+
+  err = kogmo_rtdb_obj_delete (dbc, &a_info); DIEonERR(err);
+}
+
+
+static void
+test_wait_all (kogmo_rtdb_handle_t *dbc)
+{
+  kogmo_rtdb_obj_info_t c_info, d_info, e_info;
+  kogmo_rtdb_obj_c3_ints256_t *ptrs[2];
+  kogmo_rtdb_objid_t oids[2];
+  kogmo_timestamp_t data_ts, set_ts = 0;
+  int err;
+  pid_t pid;
+
+  printf(              "wait_all:\n");
+  data_ts = kogmo_timestamp_now ();
+  insert_written (dbc, &c_info, "wait-test-all-c", data_ts);
+  insert_written (dbc, &d_info, "wait-test-all-d", data_ts);
+  oids[0] = c_info.oid;
+  oids[1] = d_info.oid;
+
+  err = kogmo_rtdb_obj_wait_all (dbc, oids, 2, 0, kogmo_timestamp_add_secs (kogmo_timestamp_now (), 1.0),
+                                 &set_ts, ptrs, NULL);
+  CHECK("first set", err == 2 && set_ts == data_ts
+                     && ptrs[0]->base.data_ts == data_ts && ptrs[1]->base.data_ts == data_ts);
+  err = kogmo_rtdb_obj_wait_all (dbc, oids, 2, 0, kogmo_timestamp_add_secs (kogmo_timestamp_now (), 0.1),
+                                 &set_ts, ptrs, NULL);
+  CHECK("no new set", err == -KOGMO_RTDB_ERR_TIMEOUT);
+
+  // the waiter watches only the object that committed last (d),
+  // the deletion of any other one must wake it up as well
+  fflush (stdout); // or the child prints it again
+  pid = fork ();
+  if ( pid == 0 )
+    {
+      dbc = child_connect ();
+      err = kogmo_rtdb_obj_wait_all (dbc, oids, 2, 0, kogmo_timestamp_add_secs (kogmo_timestamp_now (), 5.0),
+                                     &set_ts, ptrs, NULL);
+      CHECK("wakeup on deletion of an unwatched object", err == -KOGMO_RTDB_ERR_NOTFOUND);
+      child_exit (dbc);
+    }
+  DIEonERR(pid);
+  delete_later (dbc, &c_info, pid);
+
+  // now e committed last
+  insert_written (dbc, &e_info, "wait-test-all-e", data_ts);
+  oids[0] = e_info.oid;
+  fflush (stdout); // or the child prints it again
+  pid = fork ();
+  if ( pid == 0 )
+    {
+      dbc = child_connect ();
+      err = kogmo_rtdb_obj_wait_all (dbc, oids, 2, 0, kogmo_timestamp_add_secs (kogmo_timestamp_now (), 5.0),
+                                     &set_ts, ptrs, NULL);
+      CHECK("wakeup on deletion of the watched object", err == -KOGMO_RTDB_ERR_NOTFOUND);
+      child_exit (dbc);
+    }
+  DIEonERR(pid);
+  delete_later (dbc, &e_info, pid);
+
+  err = kogmo_rtdb_obj_delete (dbc, &d_info); DIEonERR(err);
+}
+
+
+static void
+test_subscribe_fd (kogmo_rtdb_handle_t *dbc)
+{
+  kogmo_rtdb_obj_info_t e_info;
+  kogmo_rtdb_obj_c3_ints256_t obj;
+  struct pollfd pfd;
+  uint64_t events;
+  int err, fd;
+
+  printf(              "subscribe_fd:\n");
+  insert_written (dbc, &e_info, "wait-test-fd-e", kogmo_timestamp_now ());
+  fd = kogmo_rtdb_obj_subscribe_fd (dbc, e_info.oid); DIEonERR(fd);
+  pfd.fd = fd;
+  pfd.events = POLLIN;
+
+  err = poll (&pfd, 1, 100);
+  CHECK("no event for old data", err == 0);
+
+  err = kogmo_rtdb_obj_initdata (dbc, &e_info, &obj); DIEonERR(err);
+  err = kogmo_rtdb_obj_writedata (dbc, e_info.oid, &obj); DIEonERR(err);
+  err = poll (&pfd, 1, 2000);
+  if ( err == 1 )
+    err = read (fd, &events, sizeof (events));
+  CHECK("event for new data", err == sizeof (events));
+
+  err = kogmo_rtdb_obj_delete (dbc, &e_info); DIEonERR(err);
+  err = poll (&pfd, 1, 2000);
+  if ( err == 1 )
+    err = read (fd, &events, sizeof (events));
+  CHECK("event on deletion", err == sizeof (events));
+
+  err = kogmo_rtdb_obj_unsubscribe_fd (dbc, fd); DIEonERR(err);
+}
+
+
+static void
+test_waitstats (kogmo_rtdb_handle_t *dbc)
+{
+  kogmo_rtdb_obj_info_t obj_info;
+  kogmo_rtdb_obj_c3_ints256_t obj;
+  kogmo_rtdb_waitstats_t stats;
+  kogmo_timestamp_t old_ts, start_ts;
+  double secs;
+  int err;
+  pid_t pid;
+
+  printf(              "waitstats:\n");
+  insert_written (dbc, &obj_info, "wait-test-stats", kogmo_timestamp_now ());
+  old_ts = committed_ts (dbc, obj_info.oid);
+
+  // a commit within the spin time
+  err = kogmo_rtdb_setwaitspin (dbc, 1.0, 1); DIEonERR(err);
+  err = kogmo_rtdb_getwaitstats (dbc, NULL, 1); DIEonERR(err);
+  pid = commit_later (&obj_info, 0.1, 1);
+  err = kogmo_rtdb_obj_readdata_waitnext_until (dbc, obj_info.oid, old_ts, &obj, sizeof (obj),
+                                                kogmo_timestamp_add_secs (kogmo_timestamp_now (), 5.0));
+  DIEonERR(err);
+  waitpid (pid, &err, 0);
+  old_ts = obj.base.committed_ts;
+  err = kogmo_rtdb_getwaitstats (dbc, &stats, 1); DIEonERR(err);
+  CHECK("commit while spinning", stats.waits == 1 && stats.spin_wakeups == 1 && stats.blocks == 0);
+
+  // a commit after the spin time
+  err = kogmo_rtdb_setwaitspin (dbc, 0.05, 1); DIEonERR(err);
+  pid = commit_later (&obj_info, 0.3, 2);
+  err = kogmo_rtdb_obj_readdata_waitnext_until (dbc, obj_info.oid, old_ts, &obj, sizeof (obj),
+                                                kogmo_timestamp_add_secs (kogmo_timestamp_now (), 5.0));
+  DIEonERR(err);
+  waitpid (pid, &err, 0);
+  old_ts = obj.base.committed_ts;
+  err = kogmo_rtdb_getwaitstats (dbc, &stats, 1); DIEonERR(err);
+  CHECK("commit after spinning", stats.waits == 1 && stats.spin_wakeups == 0 && stats.blocks == 1);
+
+  err = kogmo_rtdb_getwaitstats (dbc, &stats, 0); DIEonERR(err);
+  CHECK("reset", stats.waits == 0 && stats.spin_wakeups == 0 && stats.blocks == 0);
+
+  // the spin time must not delay the timeout
+  err = kogmo_rtdb_setwaitspin (dbc, 1.0, 1); DIEonERR(err);
+  start_ts = kogmo_timestamp_now ();
+  err = kogmo_rtdb_obj_readdata_waitnext_until (dbc, obj_info.oid, old_ts, &obj, sizeof (obj),
+                                                kogmo_timestamp_add_secs (start_ts, 0.2));
+  secs = kogmo_timestamp_diff_secs (start_ts, kogmo_timestamp_now ());
+  CHECK("timeout while spinning", err == -KOGMO_RTDB_ERR_TIMEOUT && secs >= 0.2 && secs < 0.5);
+
+  err = kogmo_rtdb_setwaitspin (dbc, 0, 0); DIEonERR(err);
+  err = kogmo_rtdb_obj_delete (dbc, &obj_info); DIEonERR(err);
+}
+
+
+int
+main (int argc, char **argv)
+{
+  kogmo_rtdb_handle_t *dbc;
+  kogmo_rtdb_connect_info_t dbinfo;
+  kogmo_rtdb_objid_t oid;
+  int err;
+
+  err = kogmo_rtdb_connect_initinfo (&dbinfo, "", "wait-test", 0.1); DIEonERR(err);
+  dbinfo.flags = KOGMO_RTDB_CONNECT_FLAGS_NOHANDLERS; // the children must not end us
+  oid = kogmo_rtdb_connect (&dbc, &dbinfo); DIEonERR(oid);
+  err = kogmo_rtdb_setwaitspin (dbc, 0, 0); DIEonERR(err); // ignore KOGMO_RTDB_WAIT_SPIN
+
+  test_waitnext (dbc);
+  test_wait_any (dbc);
+  test_wait_all (dbc);
+  test_subscribe_fd (dbc);
+  test_waitstats (dbc);
+
+  err = kogmo_rtdb_disconnect (dbc, NULL); DIEonERR(err);
+
+  if ( !ok )
+    {
+      printf("\nWARNING: THERE WERE ERRORS!!!\n\n");
+      return 1;
+    }
+
+  return 0;
+}
@@ -18,6 +18,42 @@ static int compare_oid(const void *a, const void *b) {
      return 0;
 }
 
+// search with a cursor, so that the database is not locked during the whole
+// search. the reply can hold KOGMO_RTDB_OBJIDLIST_MAX oids, the result
+// counts all matches and the errors are those of kogmo_rtdb_obj_searchinfo().
+static kogmo_rtdb_objid_t
+search_idlist (kogmo_rtdb_handle_t *dbc, kogmo_rtdb_obj_udpsimplereq_t *req_p,
+               kogmo_rtdb_objid_list_t idlist)
+{
+  kogmo_rtdb_obj_search_t search;
+  kogmo_rtdb_obj_info_t parent_info;
+  kogmo_rtdb_objid_t oids[64];
+  int i, n = 0, err, nfound = 0;
+
+  err = kogmo_rtdb_obj_searchinfo_begin (dbc, &search, req_p->name, req_p->otype,
+                                         req_p->parent_oid, req_p->proc_oid, req_p->ts, 0);
+  if ( err < 0 )
+    return err;
+  while ( ( req_p->nth == 0 || nfound < req_p->nth ) &&
+          ( n = kogmo_rtdb_obj_searchinfo_next (dbc, &search, oids, sizeof(oids)/sizeof(oids[0])) ) > 0 )
+    {
+      for(i=0;i<n && ( req_p->nth == 0 || nfound < req_p->nth );i++,nfound++)
+        if ( nfound < KOGMO_RTDB_OBJIDLIST_MAX )
+          idlist[nfound] = oids[i];
+    }
+  kogmo_rtdb_obj_searchinfo_end (dbc, &search);
+  if ( n < 0 )
+    return n;
+  idlist[nfound < KOGMO_RTDB_OBJIDLIST_MAX ? nfound : KOGMO_RTDB_OBJIDLIST_MAX] = 0;
+  if ( nfound )
+    return nfound;
+  // return invalid if parent-id does not exist
+  if ( req_p->parent_oid &&
+       kogmo_rtdb_obj_readinfo (dbc, req_p->parent_oid, req_p->ts, &parent_info) < 0 )
+    return -KOGMO_RTDB_ERR_INVALID;
+  return -KOGMO_RTDB_ERR_NOTFOUND;
+}
+
 int
 main (int argc, char **argv)
 {
@@ -131,7 +167,7 @@ main (int argc, char **argv)
         }
       else
         {
-          listoids = kogmo_rtdb_obj_searchinfo (dbc, req_p->name, req_p->otype, req_p->parent_oid, req_p->proc_oid, req_p->ts, idlist, req_p->nth);
+          listoids = search_idlist (dbc, req_p, idlist);
           DBG("Search for %s:0x%08X parent:%lli proc:%lli ts:%lli nth:%i returned %lli",
               req_p->name, req_p->otype, (long long int)req_p->parent_oid, (long long int)req_p->proc_oid, req_p->ts, req_p->nth, (long long int)listoids);
         }
@@ -163,6 +199,8 @@ main (int argc, char **argv)
         { // Read-Request:
           last_buflen = buflen;
           // sort oids numerically ascending so is it guaranteed that a parent objects is created first
+          if ( listoids > KOGMO_RTDB_OBJIDLIST_MAX )
+            listoids = KOGMO_RTDB_OBJIDLIST_MAX;
           qsort(&idlist[0], listoids, sizeof(kogmo_rtdb_objid_t), compare_oid);
 
           for(i=0;i<listoids;i++)